@@ -9,4 +9,35 @@
 
 #include "project_tree.hpp"
 
-auto generate(const ProjectConfig& config, const ProjectTree& project_tree) -> void;
\ No newline at end of file
+/**
+ * Writes the generated sources, the public symbol table and the native build of the project, which
+ * includes the headers of and links against every referenced project
+ *
+ * Returns the translation units of the native build.
+ */
+auto generate(const ProjectConfig& config,
+              const ProjectTree& project_tree,
+              std::span<const ProjectConfig* const> references = {}) -> std::vector<fs::path>;
+
+constexpr auto default_cache_size = uint64_t{5} << 30;
+
+/**
+ * BuildOptions
+ * \brief Settings of the native build that belong to the machine rather than the project
+ */
+struct BuildOptions final {
+  // Number of compiler processes, zero selects the hardware concurrency.
+  uint32_t jobs       = 0;
+
+  // Directory of the object cache, empty disables it.
+  fs::path cache_dir;
+  uint64_t cache_size = default_cache_size;
+};
+
+/**
+ * Builds the translation units into the project binary
+ */
+auto compile(const ProjectConfig& config,
+             std::span<const ProjectConfig* const> references,
+             std::span<const fs::path> units,
+             const BuildOptions& options = {}) -> void;
\ No newline at end of file
@@ -3,30 +3,50 @@
 
 #include "gen_common.hpp"
 
-const auto c_type_map = std::unordered_map<std::string_view, std::string_view>{
-    {"bool32", "__UINT32_TYPE__"},
-
-    {"u8",     "uint8_t"        },
-    {"u16",    "uint16_t"       },
-    {"u32",    "uint32_t"       },
-    {"u64",    "uint64_t"       },
-    {"uword",  "uintptr_t"      },
-
-    {"i8",     "int8_t"         },
-    {"i16",    "int16_t"        },
-    {"i32",    "int32_t"        },
-    {"i64",    "int64_t"        },
-    {"iword",  "intptr_t"       },
-
-    {"f32",    "float"          },
-    {"f64",    "double"         }
-};
+auto write_type(OutputBuffer& writer, const Type& type) -> OutputBuffer& {
+  switch (type.kind()) {
+    case TypeKind::Named: {
+      return writer << identifer_prefix << type.name();
+    }
+    case TypeKind::Pointer: {
+      return write_type(writer, deref(type.element())) << '*';
+    }
+    case TypeKind::Array: {
+      if (type.extent() == 0) {
+        return write_type(writer << "std::vector<", deref(type.element())) << '>';
+      }
+      write_type(writer << "std::array<", deref(type.element()));
+      return writer << ", " << type.extent() << '>';
+    }
+    case TypeKind::Optional: {
+      return write_type(writer << "std::optional<", deref(type.element())) << '>';
+    }
+    case TypeKind::Generic: {
+      writer << identifer_prefix << type.name() << '<';
+      for (auto i = size_t{0}; i < type.arguments().size(); ++i) {
+        if (i != 0) {
+          writer << ", ";
+        }
+        write_type(writer, deref(type.arguments()[i]));
+      }
+      return writer << '>';
+    }
+  }
+  throw std::exception("not implemented!");
+}
 
-auto mutate_type_name(std::string_view view) -> std::string_view {
-  if (auto c_type = c_type_map.find(view); c_type != c_type_map.end()) {
-    return c_type->second;
+auto write_linkage(OutputBuffer& writer, AccessModifier access) -> OutputBuffer& {
+  switch (access) {
+    case AccessModifier::Private: {
+      return writer << "static ";
+    }
+    case AccessModifier::Public: {
+      return writer << export_macro << ' ';
+    }
+    default: {
+      return writer;
+    }
   }
-  return view;
 }
 
 const auto operator_symbol_map = std::unordered_map<Operator, std::string_view>{
@@ -80,6 +100,6 @@ auto get_operator_symbol(Operator op) -> std::string_view {
 constexpr auto include_prefix  = std::string_view{"#include \""};
 constexpr auto include_postfix = std::string_view{"\""};
 
-auto write_include(std::ostream& stream, std::string_view header) -> std::ostream& {
-  return stream << include_prefix << header << include_postfix << newline;
+auto write_include(OutputBuffer& writer, std::string_view header) -> OutputBuffer& {
+  return writer << include_prefix << header << include_postfix << newline;
 }
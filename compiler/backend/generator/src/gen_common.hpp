@@ -8,11 +8,13 @@
 #endif
 
 #include "syntax_tree.hpp"
+#include "output_buffer.hpp"
 
 constexpr auto keyword_auto          = std::string_view{"auto"};
 
 constexpr auto identifer_prefix      = std::string_view{"__ty_"};
 constexpr auto namespace_file_prefix = std::string_view{"__ty_ns_"};
+constexpr auto export_macro          = std::string_view{"__ty_export"};
 
 enum class GeneratedFile {
   Source,
@@ -20,8 +22,19 @@ enum class GeneratedFile {
   HeaderPublic
 };
 
-auto mutate_type_name(std::string_view view) -> std::string_view;
+/**
+ * Writes the C++ spelling of a type, composite types map onto the standard library
+ */
+auto write_type(OutputBuffer& writer, const Type& type) -> OutputBuffer&;
+
+/**
+ * Writes the storage class or export attribute of a module level definition
+ *
+ * Private definitions are only seen by their own file and get internal linkage, public ones are
+ * exported from the binary. Anything in between keeps the default of the target.
+ */
+auto write_linkage(OutputBuffer& writer, AccessModifier access) -> OutputBuffer&;
 
 auto get_operator_symbol(Operator op) -> std::string_view;
 
-auto write_include(std::ostream& stream, std::string_view header) -> std::ostream&;
\ No newline at end of file
+auto write_include(OutputBuffer& writer, std::string_view header) -> OutputBuffer&;
\ No newline at end of file
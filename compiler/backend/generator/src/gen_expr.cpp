@@ -7,23 +7,23 @@
  * Expressions
  */
 
-auto write_expr_bool(std::ostream& writer, const BooleanExpression& expr) -> void {
+auto write_expr_bool(OutputBuffer& writer, const BooleanExpression& expr) -> void {
   writer << (expr.value() ? "true" : "false");
 }
 
-auto write_expr_number(std::ostream& writer, const NumberExpression& expr) -> void {
+auto write_expr_number(OutputBuffer& writer, const NumberExpression& expr) -> void {
   writer << expr.value();
 }
 
-auto write_expr_string(std::ostream& writer, const StringExpression& expr) -> void {
+auto write_expr_string(OutputBuffer& writer, const StringExpression& expr) -> void {
   writer << '"' << expr.value() << '"';
 }
 
-auto write_expr_ident(std::ostream& writer, const IdentifierExpression& expr) -> void {
+auto write_expr_ident(OutputBuffer& writer, const IdentifierExpression& expr) -> void {
   writer << identifer_prefix << expr.identifier();
 }
 
-auto write_expr_call(std::ostream& writer, const CallExpression& expr) -> void {
+auto write_expr_call(OutputBuffer& writer, const CallExpression& expr) -> void {
   writer << identifer_prefix << expr.identifier() << '(';
   auto& params = expr.parameters();
   if (!params.empty()) {
@@ -37,13 +37,13 @@ auto write_expr_call(std::ostream& writer, const CallExpression& expr) -> void {
   writer << ')';
 }
 
-auto write_expression(std::ostream& writer, const std::unique_ptr<BaseExpression>& expr) -> void;
+auto write_expression(OutputBuffer& writer, const std::unique_ptr<BaseExpression>& expr) -> void;
 
 constexpr auto is_no_space_op(Operator op) -> bool {
   return op == Operator::Access || op == Operator::Static;
 }
 
-auto write_expr_binary(std::ostream& writer, const BinaryExpression& expr) -> void {
+auto write_expr_binary(OutputBuffer& writer, const BinaryExpression& expr) -> void {
   // writer << '(';
   write_expression(writer, expr.lhs());
 
@@ -58,7 +58,7 @@ auto write_expr_binary(std::ostream& writer, const BinaryExpression& expr) -> vo
   // writer << ')';
 }
 
-auto write_expr_unary(std::ostream& writer, const UnaryExpression& expr) -> void {
+auto write_expr_unary(OutputBuffer& writer, const UnaryExpression& expr) -> void {
   //write_expression(writer, expr->lhs());
   //
   //const auto op = expr->op();
@@ -73,7 +73,7 @@ auto write_expr_unary(std::ostream& writer, const UnaryExpression& expr) -> void
   throw_not_implemented();
 }
 
-auto write_expression(std::ostream& writer, const std::unique_ptr<BaseExpression>& expr) -> void {
+auto write_expression(OutputBuffer& writer, const std::unique_ptr<BaseExpression>& expr) -> void {
   switch (expr->kind()) {
     case SyntaxKind::ExprBool: {
       write_expr_bool(writer, deref(ptr_cast<BooleanExpression>(expr.get())));
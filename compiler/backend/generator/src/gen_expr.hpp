@@ -9,4 +9,4 @@
 
 #include "gen_common.hpp"
 
-auto write_expression(std::ostream& writer, const std::unique_ptr<BaseExpression>& expr) -> void;
\ No newline at end of file
+auto write_expression(OutputBuffer& writer, const std::unique_ptr<BaseExpression>& expr) -> void;
\ No newline at end of file
@@ -5,17 +5,17 @@
 
 #include "gen_stmt.hpp"
 
-auto write_parameter(std::ostream& writer, const FunctionParameter& param) {
+auto write_parameter(OutputBuffer& writer, const FunctionParameter& param) {
   if (param.is_type_auto()) {
     writer << keyword_auto;
   } else {
-    writer << identifer_prefix << param.type_name();
+    write_type(writer, deref(param.type()));
   }
 
-  writer << " " << param.name();
+  writer << " " << identifer_prefix << param.name();
 }
 
-auto write_parameter_block(std::ostream& writer, const FunctionDefinition& def) -> void {
+auto write_parameter_block(OutputBuffer& writer, const FunctionDefinition& def) -> void {
   writer << '(';
 
   const auto& parameters = def.parameters();
@@ -31,22 +31,22 @@ auto write_parameter_block(std::ostream& writer, const FunctionDefinition& def)
   writer << ')';
 }
 
-auto write_declaration(std::ostream& writer, const FunctionDefinition& def) {
+auto write_declaration(OutputBuffer& writer, const FunctionDefinition& def) {
   writer << keyword_auto << ' ' << identifer_prefix << def.name();
 
   write_parameter_block(writer, def);
 
   if (!def.is_return_auto()) {
-    writer << " -> " << identifer_prefix << def.return_type();
+    write_type(writer << " -> ", deref(def.return_type()));
   }
 }
 
-auto write_forward_decl(std::ostream& writer, const FunctionDefinition& def) -> void {
+auto write_forward_decl(OutputBuffer& writer, const FunctionDefinition& def) -> void {
   write_declaration(writer, def);
   writer << ';';
 }
 
-auto write_definition(std::ostream& writer, const FunctionDefinition& def) -> void {
+auto write_definition(OutputBuffer& writer, const FunctionDefinition& def) -> void {
   write_declaration(writer, def);
   write_block(writer, deref(def.body()));
   writer << newline;
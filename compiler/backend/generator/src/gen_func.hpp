@@ -9,6 +9,6 @@
 
 #include "gen_common.hpp"
 
-auto write_forward_decl(std::ostream& writer, const FunctionDefinition& def) -> void;
+auto write_forward_decl(OutputBuffer& writer, const FunctionDefinition& def) -> void;
 
-auto write_definition(std::ostream& writer, const FunctionDefinition& def) -> void;
\ No newline at end of file
+auto write_definition(OutputBuffer& writer, const FunctionDefinition& def) -> void;
\ No newline at end of file
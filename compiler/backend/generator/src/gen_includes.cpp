@@ -0,0 +1,90 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "gen_includes.hpp"
+
+#include "gen_common.hpp"
+
+#include "profiler.hpp"
+
+using DeclarationSites = std::unordered_map<std::string, DeclarationIndex::Site>;
+
+auto index_namespace(const NameSpace& ns,
+                     DeclarationSites& sites,
+                     std::unordered_set<std::string_view>& name_spaces) -> void {
+  name_spaces.insert(ns.full_name());
+
+  for (auto& ptree : ns.trees()) {
+    auto& tree   = deref(ptree);
+    auto* source = tree.source().get();
+    auto add     = [&](const BaseDefinition& def, SymbolKind kind) {
+      if (def.access() != AccessModifier::Private) {
+        sites.emplace(module_key(ns.full_name(), def.name()),
+                      DeclarationIndex::Site{source, kind, def.name()});
+      }
+    };
+
+    for (auto& ctype : tree.ctypes()) {
+      add(deref(ctype), SymbolKind::CType);
+    }
+    for (auto& var : tree.variables()) {
+      add(deref(var), SymbolKind::Variable);
+    }
+    for (auto& strct : tree.structs()) {
+      add(deref(strct), SymbolKind::Struct);
+    }
+    for (auto& object : tree.objects()) {
+      add(deref(object), SymbolKind::Object);
+    }
+    for (auto& fn : tree.functions()) {
+      add(deref(fn), SymbolKind::Function);
+    }
+  }
+
+  for (auto& retained : ns.retained()) {
+    for (auto& symbol : deref(retained.record).exports) {
+      if (symbol.kind == SymbolKind::CInclude) {
+        continue;
+      }
+      sites.emplace(module_key(ns.full_name(), symbol.name),
+                    DeclarationIndex::Site{retained.source.get(), symbol.kind, symbol.name});
+    }
+  }
+
+  for (auto& psub : ns.sub_spaces()) {
+    index_namespace(deref(psub), sites, name_spaces);
+  }
+}
+
+DeclarationIndex::DeclarationIndex(const ProjectTree& project_tree) {
+  PROFILE_SCOPE("Index Declarations");
+  index_namespace(deref(project_tree.root()), sites_, name_spaces_);
+}
+
+auto included_headers(const DeclarationIndex& index, std::span<const std::string> uses)
+    -> std::vector<const SourceContext*> {
+  auto headers = std::vector<const SourceContext*>{};
+  for (auto& key : uses) {
+    const auto* site = index.find(key);
+    if (site && site->kind != SymbolKind::Struct &&
+        std::find(headers.begin(), headers.end(), site->source) == headers.end()) {
+      headers.push_back(site->source);
+    }
+  }
+  return headers;
+}
+
+auto write_uses(OutputBuffer& writer,
+                const DeclarationIndex& index,
+                std::span<const std::string> uses) -> void {
+  for (auto* source : included_headers(index, uses)) {
+    write_include(writer, deref(source).gen_header_internal_path().filename().string());
+  }
+
+  for (auto& key : uses) {
+    const auto* site = index.find(key);
+    if (site && site->kind == SymbolKind::Struct) {
+      writer << "class " << identifer_prefix << site->name << ';' << newline;
+    }
+  }
+}
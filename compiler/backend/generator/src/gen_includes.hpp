@@ -0,0 +1,66 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <unordered_set>
+
+#include "output_buffer.hpp"
+#include "project_tree.hpp"
+
+/**
+ * DeclarationIndex
+ * \brief Sources of the non private module level declarations of the project, by module key
+ *
+ * Retained sources are indexed by their recorded exports. Keys that are not found belong to
+ * referenced projects, whose headers come in through the imports of a source.
+ */
+class DeclarationIndex final {
+ public:
+  struct Site final {
+    const SourceContext* source;
+    SymbolKind kind;
+    std::string_view name;
+  };
+
+ private:
+  std::unordered_map<std::string, Site> sites_;
+  std::unordered_set<std::string_view> name_spaces_;
+
+ public:
+  explicit DeclarationIndex(const ProjectTree& project_tree);
+
+  NODISCARD auto find(const std::string& key) const -> const Site* {
+    auto it = sites_.find(key);
+    return it != sites_.end() ? &it->second : nullptr;
+  }
+
+  /**
+   * Whether sources of the project declare into the namespace, a referenced project declaring
+   * into it as well is shadowed by the generated header of the same name
+   */
+  NODISCARD auto is_local(std::string_view full_name) const -> bool {
+    return name_spaces_.contains(full_name);
+  }
+};
+
+/**
+ * Internal headers a generated file includes for the declarations of other files it uses, in the
+ * order of first use
+ *
+ * Structures are left out, a forward declaration is all a file needs as their definitions never
+ * leave their own source.
+ */
+auto included_headers(const DeclarationIndex& index, std::span<const std::string> uses)
+    -> std::vector<const SourceContext*>;
+
+/**
+ * Writes the includes and structure forward declarations of the declarations a file uses
+ */
+auto write_uses(OutputBuffer& writer,
+                const DeclarationIndex& index,
+                std::span<const std::string> uses) -> void;
@@ -0,0 +1,1202 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "gen_llvm.hpp"
+
+#include <bit>
+
+#include "gen_common.hpp"
+#include "interpreter.hpp"
+#include "profiler.hpp"
+#include "timer.hpp"
+
+/**
+ * IrType
+ * \brief Type of a value or of memory, a fixed width C type or a structure
+ */
+struct IrType final {
+  ConstantType scalar               = ConstantType::I32;
+  const StructDefinition* structure = nullptr;
+};
+
+/**
+ * IrValue
+ * \brief Operand of an instruction, a register or a constant
+ */
+struct IrValue final {
+  std::string text;
+  ConstantType type;
+};
+
+/**
+ * IrSlot
+ * \brief Memory a variable lives in, an alloca, a global or a member of either
+ */
+struct IrSlot final {
+  std::string pointer;
+  IrType type;
+};
+
+/**
+ * IrSignature
+ * \brief Symbol and C++ calling convention of a function, results are null for void functions
+ */
+struct IrSignature final {
+  std::string name;
+  std::vector<ConstantType> parameters;
+  std::optional<ConstantType> result;
+};
+
+/**
+ * IrOperation
+ * \brief Instruction of an operator for signed, unsigned and floating point operands
+ */
+struct IrOperation final {
+  std::string_view signed_op;
+  std::string_view unsigned_op;
+  std::string_view floating_op;
+};
+
+const auto arithmetic_op_map = std::unordered_map<Operator, IrOperation>{
+    {Operator::Add,      {"add", "add", "fadd"}},
+    {Operator::Subtract, {"sub", "sub", "fsub"}},
+    {Operator::Multiply, {"mul", "mul", "fmul"}},
+    {Operator::Divide,   {"sdiv", "udiv", "fdiv"}},
+    {Operator::BitOr,    {"or", "or", {}}       },
+    {Operator::BitXor,   {"xor", "xor", {}}     },
+    {Operator::BitAnd,   {"and", "and", {}}     },
+};
+
+const auto comparison_op_map = std::unordered_map<Operator, IrOperation>{
+    {Operator::Equals,            {"icmp eq", "icmp eq", "fcmp oeq"}  },
+    {Operator::NotEquals,         {"icmp ne", "icmp ne", "fcmp une"}  },
+    {Operator::LessThan,          {"icmp slt", "icmp ult", "fcmp olt"}},
+    {Operator::GreaterThan,       {"icmp sgt", "icmp ugt", "fcmp ogt"}},
+    {Operator::LessThanEquals,    {"icmp sle", "icmp ule", "fcmp ole"}},
+    {Operator::GreaterThanEquals, {"icmp sge", "icmp uge", "fcmp oge"}},
+};
+
+const auto compound_op_map = std::unordered_map<Operator, Operator>{
+    {Operator::SelfAdd,    Operator::Add     },
+    {Operator::SelfSub,    Operator::Subtract},
+    {Operator::SelfMul,    Operator::Multiply},
+    {Operator::SelfDiv,    Operator::Divide  },
+    {Operator::SelfBitOr,  Operator::BitOr   },
+    {Operator::SelfBitXor, Operator::BitXor  },
+    {Operator::SelfBitAnd, Operator::BitAnd  },
+};
+
+// Itanium codes of the parameter types, int64_t is long on LP64 targets.
+const auto mangled_type_map = std::unordered_map<ConstantType, char>{
+    {ConstantType::Bool, 'b'},
+    {ConstantType::I8,   'a'},
+    {ConstantType::I16,  's'},
+    {ConstantType::I32,  'i'},
+    {ConstantType::I64,  'l'},
+    {ConstantType::U8,   'h'},
+    {ConstantType::U16,  't'},
+    {ConstantType::U32,  'j'},
+    {ConstantType::U64,  'm'},
+    {ConstantType::F32,  'f'},
+    {ConstantType::F64,  'd'},
+};
+
+auto register_type(ConstantType type) -> std::string_view {
+  switch (type) {
+    case ConstantType::Bool: {
+      return "i1";
+    }
+    case ConstantType::I8:
+    case ConstantType::U8: {
+      return "i8";
+    }
+    case ConstantType::I16:
+    case ConstantType::U16: {
+      return "i16";
+    }
+    case ConstantType::I32:
+    case ConstantType::U32: {
+      return "i32";
+    }
+    case ConstantType::F32: {
+      return "float";
+    }
+    case ConstantType::F64: {
+      return "double";
+    }
+    default: {
+      return "i64";
+    }
+  }
+}
+
+// Bools are i1 in registers and a byte in memory, as C++ stores them.
+auto memory_type(ConstantType type) -> std::string_view {
+  return type == ConstantType::Bool ? "i8" : register_type(type);
+}
+
+// Arguments and results narrower than int are extended by the side that produces them.
+auto extension(ConstantType type) -> std::string_view {
+  if (bit_width(type) >= 32) {
+    return {};
+  }
+  return is_signed(type) ? "signext" : "zeroext";
+}
+
+auto select(const IrOperation& operation, ConstantType type) -> std::string_view {
+  if (is_floating(type)) {
+    return operation.floating_op;
+  }
+  return is_signed(type) ? operation.signed_op : operation.unsigned_op;
+}
+
+// Floating point constants are written as the hex bits of a double, f32 values are exact in it.
+auto ir_constant(const ConstantValue& constant) -> std::string {
+  return std::visit(
+      [](auto value) -> std::string {
+        using T = decltype(value);
+        if constexpr (std::is_same_v<T, bool>) {
+          return value ? "true" : "false";
+        } else if constexpr (std::is_same_v<T, double>) {
+          auto digits       = std::array<char, 16>{};
+          auto [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(),
+                                            std::bit_cast<uint64_t>(value), 16);
+          const auto hex    = std::string_view{digits.data(), end};
+          return std::string{"0x"}.append(digits.size() - hex.size(), '0').append(hex);
+        } else {
+          return std::to_string(value);
+        }
+      },
+      constant.value);
+}
+
+auto memory_constant(const ConstantValue& constant) -> std::string {
+  if (constant.type == ConstantType::Bool) {
+    return std::get<bool>(constant.value) ? "1" : "0";
+  }
+  return ir_constant(constant);
+}
+
+// Initializers of module variables have to be constant, they are folded the way the checker does.
+auto constant_value(const BaseExpression& expr) -> std::optional<ConstantValue> {
+  switch (expr.kind()) {
+    case SyntaxKind::ExprBool: {
+      return ConstantValue{ConstantType::Bool, ref_cast<const BooleanExpression>(expr).value()};
+    }
+    case SyntaxKind::ExprNumber: {
+      return parse_literal(ref_cast<const NumberExpression>(expr).value());
+    }
+    case SyntaxKind::ExprUnary: {
+      auto& unary        = ref_cast<const UnaryExpression>(expr);
+      const auto operand = constant_value(deref(unary.expr()));
+      return operand ? evaluate(unary.op(), *operand) : std::nullopt;
+    }
+    case SyntaxKind::ExprBinary: {
+      auto& binary   = ref_cast<const BinaryExpression>(expr);
+      const auto lhs = constant_value(deref(binary.lhs()));
+      const auto rhs = constant_value(deref(binary.rhs()));
+      return lhs && rhs ? evaluate(binary.op(), *lhs, *rhs) : std::nullopt;
+    }
+    default: {
+      return std::nullopt;
+    }
+  }
+}
+
+// Deduced return types are only lowered for functions that return nothing.
+auto returns_value(const StatementBlock& block) -> bool {
+  for (auto& pstmt : block.statements()) {
+    auto& stmt = deref(pstmt);
+    switch (stmt.kind()) {
+      case SyntaxKind::StmtRet: {
+        if (ref_cast<const ReturnStatement>(stmt).expr()) {
+          return true;
+        }
+        break;
+      }
+      case SyntaxKind::StmtIf:
+      case SyntaxKind::StmtElif:
+      case SyntaxKind::StmtElse:
+      case SyntaxKind::StmtLoop:
+      case SyntaxKind::StmtWhile:
+      case SyntaxKind::StmtFor: {
+        if (returns_value(deref(ref_cast<const BaseBodyStatement>(stmt).body()))) {
+          return true;
+        }
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * ModuleEmitter
+ * \brief Lowers one checked syntax tree to a textual LLVM IR module
+ *
+ * Every variable lives in memory, locals in allocas of the entry block, so no SSA construction is
+ * needed and opt promotes them to registers. Types are resolved through the symbol table the way
+ * the interpreter does, constructs without a lowering stop the build with their position.
+ */
+class ModuleEmitter final {
+  const SymbolTable& table_;
+  const ProjectConfig& config_;
+  const ProjectTree& project_tree_;
+  const SourceContext& source_;
+
+  OutputBuffer types_;
+  OutputBuffer globals_;
+  OutputBuffer functions_;
+  OutputBuffer entry_;
+  OutputBuffer body_;
+
+  std::unordered_map<const StructDefinition*, std::vector<IrType>> structures_;
+  // Keyed by the definition, or by the symbol for functions of referenced projects.
+  std::unordered_map<const void*, IrSignature> signatures_;
+  std::unordered_map<const BaseSyntax*, IrSlot> slots_;
+  std::unordered_set<std::string> declared_;
+
+  std::optional<ConstantType> result_;
+  std::string block_;
+  bool terminated_  = false;
+  uint32_t next_id_ = 0;
+
+ public:
+  explicit ModuleEmitter(const SymbolTable& table,
+                         const ProjectConfig& config,
+                         const ProjectTree& project_tree,
+                         const SourceContext& source)
+      : table_{table},
+        config_{config},
+        project_tree_{project_tree},
+        source_{source} {}
+
+  auto emit(const SyntaxTree& tree) -> void {
+    const auto scope = table_.scope_of(tree);
+    for (auto& pobject : tree.objects()) {
+      if (!project_tree_.is_eliminated(*pobject)) {
+        unsupported(*pobject, "objects");
+      }
+    }
+    for (auto& pstruct : tree.structs()) {
+      if (!project_tree_.is_eliminated(*pstruct)) {
+        define_structure(*pstruct, scope);
+      }
+    }
+
+    // Functions of this module are defined, not declared, wherever they are called from.
+    for (auto& pfn : tree.functions()) {
+      if (!project_tree_.is_eliminated(*pfn)) {
+        declared_.insert(signature(*pfn).name);
+      }
+    }
+    for (auto& pvar : tree.variables()) {
+      if (!project_tree_.is_eliminated(*pvar)) {
+        emit_global(*pvar, scope);
+      }
+    }
+    for (auto& pfn : tree.functions()) {
+      if (!project_tree_.is_eliminated(*pfn)) {
+        emit_function(*pfn);
+      }
+    }
+  }
+
+  auto write(OutputBuffer& writer) const -> void {
+    const auto rel_path = source_.rel_path().generic_string();
+    writer << "; Generated by Typhon Compiler" << newline;
+    writer << ";     Source File : " << rel_path << newline;
+    writer << "source_filename = \"" << rel_path << '"' << newline;
+    for (auto* part : {&types_, &globals_}) {
+      if (!part->empty()) {
+        writer << newline << part->view();
+      }
+    }
+    writer << functions_.view();
+  }
+
+ private:
+  [[noreturn]] auto unsupported(const BaseSyntax& node, std::string_view what) const -> void {
+    std::cerr << "Error : " << what << " are not supported by the LLVM backend "
+              << source_.rel_path().string() << ' ' << node.pos() << std::endl;
+    exit(-1);
+  }
+
+  auto next_name(std::string_view name) -> std::string {
+    return std::string{name}.append(".").append(std::to_string(next_id_++));
+  }
+
+  // Unnamed values get a leading dot, identifiers can not start with one.
+  auto next_value() -> std::string { return "%." + std::to_string(next_id_++); }
+
+  auto linkage(AccessModifier access) const -> std::string_view {
+    if (access == AccessModifier::Private) {
+      return "internal ";
+    }
+    if (config_.binary_type() == BinaryType::Dyn && access != AccessModifier::Public) {
+      return "hidden ";
+    }
+    return {};
+  }
+
+  auto type_name(const IrType& type) const -> std::string {
+    if (type.structure) {
+      return std::string{"%"}.append(identifer_prefix).append(type.structure->name());
+    }
+    return std::string{memory_type(type.scalar)};
+  }
+
+  /*
+   * Types
+   */
+
+  auto resolve_type(ScopeId scope, const Type& type, const BaseSyntax& node) -> IrType {
+    if (const auto scalar = resolve_constant_type(table_, scope, type, node.pos())) {
+      return IrType{*scalar, nullptr};
+    }
+
+    if (type.kind() == TypeKind::Named) {
+      const auto id = table_.resolve(scope, type.name(), node.pos());
+      if (id != invalid_symbol_id) {
+        auto& symbol = table_.symbol(id);
+        if (symbol.kind == SymbolKind::Struct && symbol.syntax != nullptr) {
+          auto& structure = ref_cast<const StructDefinition>(*symbol.syntax);
+          define_structure(structure, symbol.scope);
+          return IrType{ConstantType::I32, &structure};
+        }
+      }
+    }
+    unsupported(node, "types other than fixed width C types and structures");
+  }
+
+  auto define_structure(const StructDefinition& structure, ScopeId scope) -> void {
+    if (structures_.contains(&structure)) {
+      return;
+    }
+    if (!structure.functions().empty() || !structure.objects().empty()) {
+      unsupported(structure, "structure members other than variables");
+    }
+    if (const auto inner = table_.scope_of(structure); inner != invalid_scope_id) {
+      scope = inner;
+    }
+
+    // Registered before the fields, so a field of a structure that refers back fails cleanly.
+    auto& fields = structures_[&structure];
+    auto types   = std::vector<IrType>{};
+    for (auto& pvar : structure.variables()) {
+      auto& var = deref(pvar);
+      if (!var.is_typed() || var.is_assigned()) {
+        unsupported(var, "structure variables without a type or with an initializer");
+      }
+      types.push_back(resolve_type(scope, deref(var.type()), var));
+    }
+
+    types_ << '%' << identifer_prefix << structure.name() << " = type { ";
+    for (auto i = size_t{0}; i < types.size(); ++i) {
+      types_ << (i > 0 ? ", " : "") << type_name(types[i]);
+    }
+    types_ << " }" << newline;
+    fields = std::move(types);
+  }
+
+  auto signature(const FunctionDefinition& fn) -> const IrSignature& {
+    if (auto it = signatures_.find(&fn); it != signatures_.end()) {
+      return it->second;
+    }
+
+    auto parameters = std::vector<const Type*>{};
+    for (auto& pparam : fn.parameters()) {
+      if (pparam->is_type_auto()) {
+        unsupported(*pparam, "parameters without a type");
+      }
+      parameters.push_back(pparam->type());
+    }
+    if (fn.is_return_auto() && fn.body() && returns_value(*fn.body())) {
+      unsupported(fn, "deduced return types");
+    }
+
+    auto result = lower_signature(fn.name(), table_.scope_of(fn), parameters, fn.return_type(), fn);
+    return signatures_.emplace(&fn, std::move(result)).first->second;
+  }
+
+  // Functions of referenced projects are only known by their exported signature, one without a
+  // result type returns nothing.
+  auto signature(const Symbol& symbol, const BaseSyntax& call) -> const IrSignature& {
+    if (auto it = signatures_.find(&symbol); it != signatures_.end()) {
+      return it->second;
+    }
+    if (std::find(symbol.parameters.begin(), symbol.parameters.end(), nullptr) !=
+        symbol.parameters.end()) {
+      unsupported(call, "calls of functions with parameters without a type");
+    }
+
+    const auto name = table_.names().view(symbol.name);
+    auto result     = lower_signature(name, symbol.scope, symbol.parameters, symbol.type, call);
+    return signatures_.emplace(&symbol, std::move(result)).first->second;
+  }
+
+  auto lower_signature(std::string_view name,
+                       ScopeId scope,
+                       std::span<const Type* const> parameters,
+                       const Type* result_type,
+                       const BaseSyntax& node) -> IrSignature {
+    auto result = IrSignature{};
+    result.name = std::string{identifer_prefix}.append(name);
+    for (auto* parameter : parameters) {
+      const auto type = resolve_type(scope, deref(parameter), node);
+      if (type.structure) {
+        unsupported(node, "structure parameters");
+      }
+      result.parameters.push_back(type.scalar);
+    }
+
+    if (result_type) {
+      const auto type = resolve_type(scope, *result_type, node);
+      if (type.structure) {
+        unsupported(node, "structure results");
+      }
+      result.result = type.scalar;
+    }
+
+    auto mangled = std::string{"_Z"}.append(std::to_string(result.name.size())).append(result.name);
+    for (const auto type : result.parameters) {
+      mangled.push_back(mangled_type_map.at(type));
+    }
+    if (result.parameters.empty()) {
+      mangled.push_back('v');
+    }
+    result.name = std::move(mangled);
+    return result;
+  }
+
+  auto write_result(OutputBuffer& writer, const IrSignature& signature) const -> void {
+    if (!signature.result) {
+      writer << "void";
+      return;
+    }
+    if (const auto ext = extension(*signature.result); !ext.empty()) {
+      writer << ext << ' ';
+    }
+    writer << register_type(*signature.result);
+  }
+
+  /*
+   * Module Variables
+   */
+
+  auto emit_global(const VariableDefinition& var, ScopeId scope) -> void {
+    auto initial = std::optional<ConstantValue>{};
+    if (var.is_assigned()) {
+      initial = constant_value(*var.assignment());
+      if (!initial) {
+        unsupported(var, "module variables with an initializer that is not constant");
+      }
+    }
+
+    auto type = IrType{};
+    if (var.is_typed()) {
+      type = resolve_type(scope, deref(var.type()), var);
+    } else if (initial) {
+      type.scalar = initial->type;
+    } else {
+      unsupported(var, "variables without a type or an initializer");
+    }
+    if (initial && type.structure) {
+      unsupported(var, "structure initializers");
+    }
+    if (initial) {
+      initial = ::convert(*initial, type.scalar);
+      if (!initial) {
+        unsupported(var, "initializers that can not be converted");
+      }
+    }
+
+    const auto name    = std::string{"@"}.append(identifer_prefix).append(var.name());
+    const auto storage = var.is_mutable() ? "global " : "constant ";
+    globals_ << name << " = " << linkage(var.access()) << storage << type_name(type) << ' '
+             << (initial ? memory_constant(*initial) : "zeroinitializer") << newline;
+    declared_.insert(name);
+    slots_.emplace(&var, IrSlot{name, type});
+  }
+
+  // Variables of other modules are declared on first use.
+  auto external_global(const Symbol& symbol, const BaseSyntax& node) -> IrSlot {
+    auto type = IrType{};
+    if (symbol.type) {
+      type = resolve_type(symbol.scope, *symbol.type, node);
+    } else if (const auto* var = ptr_cast<const VariableDefinition>(symbol.syntax);
+               var && var->is_assigned() && constant_value(*var->assignment())) {
+      type.scalar = constant_value(*var->assignment())->type;
+    } else {
+      unsupported(node, "module variables of other files without a type");
+    }
+
+    const auto name = std::string{"@"}.append(identifer_prefix).append(
+        table_.names().view(symbol.name));
+    if (declared_.insert(name).second) {
+      globals_ << name << " = external global " << type_name(type) << newline;
+    }
+
+    const auto slot = IrSlot{name, type};
+    if (symbol.syntax) {
+      slots_.emplace(symbol.syntax, slot);
+    }
+    return slot;
+  }
+
+  /*
+   * Functions
+   */
+
+  auto emit_function(const FunctionDefinition& fn) -> void {
+    auto& signature  = this->signature(fn);
+    const auto scope = table_.scope_of(fn);
+
+    entry_.clear();
+    body_.clear();
+    entry_.indent();
+    body_.indent();
+    result_     = signature.result;
+    block_      = "entry";
+    terminated_ = false;
+    next_id_    = 0;
+
+    functions_ << newline << "define " << linkage(fn.access());
+    write_result(functions_, signature);
+    functions_ << " @" << signature.name << '(';
+
+    auto& parameters = fn.parameters();
+    for (auto i = size_t{0}; i < parameters.size(); ++i) {
+      auto& param     = deref(parameters[i]);
+      const auto type = signature.parameters[i];
+      const auto arg  = "%" + param.name();
+      functions_ << (i > 0 ? ", " : "") << register_type(type);
+      if (const auto ext = extension(type); !ext.empty()) {
+        functions_ << ' ' << ext;
+      }
+      functions_ << ' ' << arg;
+
+      // Parameters are assignable, they get a slot like every other local.
+      const auto slot = IrSlot{"%" + next_name(param.name()), IrType{type, nullptr}};
+      entry_ << slot.pointer << " = alloca " << memory_type(type) << newline;
+      auto stored = arg;
+      if (type == ConstantType::Bool) {
+        stored = next_value();
+        entry_ << stored << " = zext i1 " << arg << " to i8" << newline;
+      }
+      entry_ << "store " << memory_type(type) << ' ' << stored << ", ptr " << slot.pointer
+             << newline;
+      slots_.emplace(&param, slot);
+    }
+    functions_ << ") {" << newline << "entry:" << newline;
+
+    emit_block(deref(fn.body()), scope);
+    if (!terminated_) {
+      body_ << (result_ ? "unreachable" : "ret void") << newline;
+    }
+    functions_ << entry_.view() << body_.view() << '}' << newline;
+  }
+
+  /*
+   * Blocks
+   */
+
+  // Starts a block, a running block falls through into it.
+  auto begin_block(const std::string& label) -> void {
+    if (!terminated_) {
+      body_ << "br label %" << label << newline;
+    }
+    body_.dedent();
+    body_ << label << ':' << newline;
+    body_.indent();
+    block_      = label;
+    terminated_ = false;
+  }
+
+  auto branch(const std::string& label) -> void {
+    if (!terminated_) {
+      body_ << "br label %" << label << newline;
+      terminated_ = true;
+    }
+  }
+
+  auto branch(const IrValue& condition, const std::string& then, const std::string& otherwise)
+      -> void {
+    body_ << "br i1 " << condition.text << ", label %" << then << ", label %" << otherwise
+          << newline;
+    terminated_ = true;
+  }
+
+  /*
+   * Statements
+   */
+
+  auto emit_block(const StatementBlock& block, ScopeId scope) -> void {
+    if (const auto inner = table_.scope_of(block); inner != invalid_scope_id) {
+      scope = inner;
+    }
+
+    auto& statements = block.statements();
+    for (auto i = size_t{0}; i < statements.size(); ++i) {
+      // Statements after a return still have to be valid IR, they go into a block nothing enters.
+      if (terminated_) {
+        begin_block(next_name("dead"));
+      }
+
+      auto& stmt = deref(statements[i]);
+      if (stmt.kind() == SyntaxKind::StmtIf) {
+        i = emit_conditional(statements, i, scope);
+      } else {
+        emit_statement(stmt, scope);
+      }
+    }
+  }
+
+  // Lowers an if and the elif and else statements following it, returns the index of the last one.
+  auto emit_conditional(const std::vector<BaseStatement::Pointer>& statements,
+                        size_t first,
+                        ScopeId scope) -> size_t {
+    const auto end = next_name("if.end");
+    auto i         = first;
+    while (true) {
+      auto& stmt = deref(statements[i]);
+      if (stmt.kind() == SyntaxKind::StmtElse) {
+        emit_block(deref(ref_cast<const ElseStatement>(stmt).body()), scope);
+        break;
+      }
+
+      const auto chained = i + 1 < statements.size() &&
+                           (statements[i + 1]->kind() == SyntaxKind::StmtElif ||
+                            statements[i + 1]->kind() == SyntaxKind::StmtElse);
+      const auto then      = next_name("if.then");
+      const auto otherwise = chained ? next_name("if.else") : end;
+
+      auto& conditional    = ref_cast<const IfStatement>(stmt);
+      const auto condition = to_bool(emit_value(deref(conditional.expr())));
+      branch(condition, then, otherwise);
+      begin_block(then);
+      emit_block(deref(conditional.body()), scope);
+      branch(end);
+
+      if (!chained) {
+        break;
+      }
+      begin_block(otherwise);
+      ++i;
+    }
+    begin_block(end);
+    return i;
+  }
+
+  auto emit_statement(const BaseStatement& stmt, ScopeId scope) -> void {
+    switch (stmt.kind()) {
+      case SyntaxKind::StmtDef: {
+        auto& def = deref(ref_cast<const DefinitionStatement>(stmt).def());
+        if (def.kind() != SyntaxKind::DefVar) {
+          unsupported(def, "local definitions other than variables");
+        }
+        emit_local(ref_cast<const VariableDefinition>(def), scope);
+        break;
+      }
+      case SyntaxKind::StmtExpr: {
+        if (auto& expr = ref_cast<const ExpressionStatement>(stmt).expr()) {
+          emit_effect(*expr);
+        }
+        break;
+      }
+      case SyntaxKind::StmtRet: {
+        emit_return(ref_cast<const ReturnStatement>(stmt));
+        break;
+      }
+      case SyntaxKind::StmtLoop: {
+        // Without a break a loop only ends through a return, nothing follows it.
+        const auto body = next_name("loop.body");
+        begin_block(body);
+        emit_block(deref(ref_cast<const LoopStatement>(stmt).body()), scope);
+        branch(body);
+        terminated_ = true;
+        break;
+      }
+      case SyntaxKind::StmtWhile: {
+        auto& loop      = ref_cast<const WhileStatement>(stmt);
+        const auto cond = next_name("while.cond");
+        const auto body = next_name("while.body");
+        const auto end  = next_name("while.end");
+        begin_block(cond);
+        branch(to_bool(emit_value(deref(loop.expr()))), body, end);
+        begin_block(body);
+        emit_block(deref(loop.body()), scope);
+        branch(cond);
+        begin_block(end);
+        break;
+      }
+      case SyntaxKind::StmtFor: {
+        emit_for(ref_cast<const ForStatement>(stmt), scope);
+        break;
+      }
+      default: {
+        unsupported(stmt, "statements of kind " + std::string{to_string(stmt.kind())});
+      }
+    }
+  }
+
+  auto emit_for(const ForStatement& loop, ScopeId scope) -> void {
+    if (const auto inner = table_.scope_of(loop); inner != invalid_scope_id) {
+      scope = inner;
+    }
+    if (loop.prefix()) {
+      emit_statement(*loop.prefix(), scope);
+    }
+
+    const auto cond = next_name("for.cond");
+    const auto body = next_name("for.body");
+    const auto step = next_name("for.step");
+    const auto end  = next_name("for.end");
+    begin_block(cond);
+    if (loop.cond()) {
+      branch(to_bool(emit_value(*loop.cond())), body, end);
+    }
+    begin_block(body);
+    emit_block(deref(loop.body()), scope);
+    begin_block(step);
+    if (loop.postfix()) {
+      emit_effect(*loop.postfix());
+    }
+    branch(cond);
+    begin_block(end);
+  }
+
+  auto emit_return(const ReturnStatement& stmt) -> void {
+    if (!stmt.expr()) {
+      if (result_) {
+        unsupported(stmt, "returns without a value from functions with a result");
+      }
+      body_ << "ret void" << newline;
+    } else {
+      if (!result_) {
+        unsupported(stmt, "returns with a value from functions without a result");
+      }
+      const auto value = convert(emit_value(*stmt.expr()), *result_);
+      body_ << "ret " << register_type(value.type) << ' ' << value.text << newline;
+    }
+    terminated_ = true;
+  }
+
+  auto emit_local(const VariableDefinition& var, ScopeId scope) -> void {
+    // The initializer runs before the slot exists, it can not refer to the variable itself.
+    auto initial = std::optional<IrValue>{};
+    if (var.is_assigned()) {
+      initial = emit_value(*var.assignment());
+    }
+
+    auto type = IrType{};
+    if (var.is_typed()) {
+      type = resolve_type(scope, deref(var.type()), var);
+    } else if (initial) {
+      type.scalar = initial->type;
+    } else {
+      unsupported(var, "variables without a type or an initializer");
+    }
+
+    const auto slot = IrSlot{"%" + next_name(var.name()), type};
+    entry_ << slot.pointer << " = alloca " << type_name(type) << newline;
+    if (initial) {
+      if (type.structure) {
+        unsupported(var, "structure initializers");
+      }
+      store(slot, convert(*initial, type.scalar));
+    }
+    slots_.insert_or_assign(&var, slot);
+  }
+
+  /*
+   * Memory
+   */
+
+  auto load(const IrSlot& slot, const BaseSyntax& node) -> IrValue {
+    if (slot.type.structure) {
+      unsupported(node, "structure values");
+    }
+
+    const auto type = slot.type.scalar;
+    auto result     = next_value();
+    body_ << result << " = load " << memory_type(type) << ", ptr " << slot.pointer << newline;
+    if (type == ConstantType::Bool) {
+      const auto byte = std::exchange(result, next_value());
+      body_ << result << " = trunc i8 " << byte << " to i1" << newline;
+    }
+    return IrValue{result, type};
+  }
+
+  auto store(const IrSlot& slot, const IrValue& value) -> void {
+    auto stored = value.text;
+    if (value.type == ConstantType::Bool) {
+      stored = next_value();
+      body_ << stored << " = zext i1 " << value.text << " to i8" << newline;
+    }
+    body_ << "store " << memory_type(value.type) << ' ' << stored << ", ptr " << slot.pointer
+          << newline;
+  }
+
+  auto variable(const BaseExpression& identifier) -> IrSlot {
+    const auto id = table_.linked(identifier);
+    if (id == invalid_symbol_id) {
+      unsupported(identifier, "names that were not resolved");
+    }
+
+    auto& symbol = table_.symbol(id);
+    if (auto it = slots_.find(symbol.syntax); it != slots_.end()) {
+      return it->second;
+    }
+    if (symbol.kind == SymbolKind::Variable) {
+      return external_global(symbol, identifier);
+    }
+    unsupported(identifier, "names other than variables and parameters");
+  }
+
+  auto member(const IrSlot& object, const BaseExpression& name, const BaseSyntax& node) -> IrSlot {
+    if (!object.type.structure || name.kind() != SyntaxKind::ExprIdentifier) {
+      unsupported(node, "member accesses other than variables of structures");
+    }
+
+    auto& identifier = ref_cast<const IdentifierExpression>(name).identifier();
+    auto& variables  = object.type.structure->variables();
+    for (auto i = size_t{0}; i < variables.size(); ++i) {
+      if (variables[i]->name() == identifier) {
+        const auto result = next_value();
+        body_ << result << " = getelementptr inbounds " << type_name(object.type) << ", ptr "
+              << object.pointer << ", i32 0, i32 " << i << newline;
+        return IrSlot{result, structures_.at(object.type.structure)[i]};
+      }
+    }
+    unsupported(node, "members that do not exist");
+  }
+
+  auto address(const BaseExpression& expr) -> IrSlot {
+    if (expr.kind() == SyntaxKind::ExprIdentifier) {
+      return variable(expr);
+    }
+    if (expr.kind() == SyntaxKind::ExprBinary) {
+      auto& access = ref_cast<const BinaryExpression>(expr);
+      if (access.op() == Operator::Access) {
+        const auto object = address(deref(access.lhs()));
+        return member(object, deref(access.rhs()), expr);
+      }
+    }
+    unsupported(expr, "assignments to anything but variables and their members");
+  }
+
+  /*
+   * Expressions
+   */
+
+  auto convert(const IrValue& value, ConstantType type) -> IrValue {
+    const auto from = value.type;
+    if (from == type) {
+      return value;
+    }
+    if (type == ConstantType::Bool) {
+      return to_bool(value);
+    }
+
+    auto op = std::string_view{};
+    if (from == ConstantType::Bool) {
+      op = is_floating(type) ? "uitofp" : "zext";
+    } else if (is_floating(from) && is_floating(type)) {
+      op = bit_width(type) > bit_width(from) ? "fpext" : "fptrunc";
+    } else if (is_floating(from)) {
+      op = is_signed(type) ? "fptosi" : "fptoui";
+    } else if (is_floating(type)) {
+      op = is_signed(from) ? "sitofp" : "uitofp";
+    } else if (bit_width(type) == bit_width(from)) {
+      return IrValue{value.text, type};
+    } else if (bit_width(type) < bit_width(from)) {
+      op = "trunc";
+    } else {
+      op = is_signed(from) ? "sext" : "zext";
+    }
+
+    const auto result = next_value();
+    body_ << result << " = " << op << ' ' << register_type(from) << ' ' << value.text << " to "
+          << register_type(type) << newline;
+    return IrValue{result, type};
+  }
+
+  auto to_bool(const IrValue& value) -> IrValue {
+    if (value.type == ConstantType::Bool) {
+      return value;
+    }
+
+    const auto result = next_value();
+    body_ << result << (is_floating(value.type) ? " = fcmp une " : " = icmp ne ")
+          << register_type(value.type) << ' ' << value.text
+          << (is_floating(value.type) ? ", 0.0" : ", 0") << newline;
+    return IrValue{result, ConstantType::Bool};
+  }
+
+  auto emit_effect(const BaseExpression& expr) -> void {
+    if (expr.kind() == SyntaxKind::ExprCall) {
+      emit_call(ref_cast<const CallExpression>(expr));
+    } else {
+      emit_value(expr);
+    }
+  }
+
+  auto emit_value(const BaseExpression& expr) -> IrValue {
+    switch (expr.kind()) {
+      case SyntaxKind::ExprBool: {
+        const auto value = ref_cast<const BooleanExpression>(expr).value();
+        return IrValue{value ? "true" : "false", ConstantType::Bool};
+      }
+      case SyntaxKind::ExprNumber: {
+        const auto literal = parse_literal(ref_cast<const NumberExpression>(expr).value());
+        if (!literal) {
+          unsupported(expr, "number literals of this form");
+        }
+        return IrValue{ir_constant(*literal), literal->type};
+      }
+      case SyntaxKind::ExprIdentifier: {
+        return load(variable(expr), expr);
+      }
+      case SyntaxKind::ExprCall: {
+        auto result = emit_call(ref_cast<const CallExpression>(expr));
+        if (!result) {
+          unsupported(expr, "results of void functions");
+        }
+        return *result;
+      }
+      case SyntaxKind::ExprUnary: {
+        return emit_unary(ref_cast<const UnaryExpression>(expr));
+      }
+      case SyntaxKind::ExprBinary: {
+        return emit_binary(ref_cast<const BinaryExpression>(expr));
+      }
+      default: {
+        unsupported(expr, "expressions of kind " + std::string{to_string(expr.kind())});
+      }
+    }
+  }
+
+  auto emit_call(const CallExpression& call) -> std::optional<IrValue> {
+    const auto id = table_.linked(call);
+    if (id == invalid_symbol_id || table_.symbol(id).kind != SymbolKind::Function) {
+      unsupported(call, "calls of anything but functions");
+    }
+
+    auto& symbol     = table_.symbol(id);
+    const auto* fn   = ptr_cast<const FunctionDefinition>(symbol.syntax);
+    auto& signature  = fn ? this->signature(*fn) : this->signature(symbol, call);
+    auto& parameters = call.parameters();
+    if (parameters.size() != signature.parameters.size()) {
+      unsupported(call, "calls with default or variadic arguments");
+    }
+
+    auto arguments = std::vector<IrValue>{};
+    for (auto i = size_t{0}; i < parameters.size(); ++i) {
+      arguments.push_back(convert(emit_value(deref(parameters[i])), signature.parameters[i]));
+    }
+
+    if (declared_.insert(signature.name).second) {
+      globals_ << "declare ";
+      write_result(globals_, signature);
+      globals_ << " @" << signature.name << '(';
+      for (auto i = size_t{0}; i < signature.parameters.size(); ++i) {
+        globals_ << (i > 0 ? ", " : "") << register_type(signature.parameters[i]);
+        if (const auto ext = extension(signature.parameters[i]); !ext.empty()) {
+          globals_ << ' ' << ext;
+        }
+      }
+      globals_ << ')' << newline;
+    }
+
+    auto result = std::optional<IrValue>{};
+    if (signature.result) {
+      result = IrValue{next_value(), *signature.result};
+      body_ << result->text << " = ";
+    }
+    body_ << "call ";
+    write_result(body_, signature);
+    body_ << " @" << signature.name << '(';
+    for (auto i = size_t{0}; i < arguments.size(); ++i) {
+      body_ << (i > 0 ? ", " : "") << register_type(arguments[i].type);
+      if (const auto ext = extension(arguments[i].type); !ext.empty()) {
+        body_ << ' ' << ext;
+      }
+      body_ << ' ' << arguments[i].text;
+    }
+    body_ << ')' << newline;
+    return result;
+  }
+
+  auto emit_unary(const UnaryExpression& expr) -> IrValue {
+    const auto op = expr.op();
+    if (is_increment(op)) {
+      const auto slot    = address(deref(expr.expr()));
+      const auto current = load(slot, expr);
+      const auto step    = op == Operator::PreInc || op == Operator::PostInc ? Operator::Add
+                                                                             : Operator::Subtract;
+      const auto next    = convert(
+          emit_arithmetic(step, current, IrValue{"1", ConstantType::I32}, expr), current.type);
+      store(slot, next);
+      return op == Operator::PreInc || op == Operator::PreDec ? next : current;
+    }
+
+    const auto operand = emit_value(deref(expr.expr()));
+    if (op == Operator::BoolNot) {
+      const auto result = next_value();
+      body_ << result << " = xor i1 " << to_bool(operand).text << ", true" << newline;
+      return IrValue{result, ConstantType::Bool};
+    }
+
+    const auto value  = convert(operand, promote(operand.type));
+    const auto type   = register_type(value.type);
+    const auto result = next_value();
+    switch (op) {
+      case Operator::Positive: {
+        return value;
+      }
+      case Operator::Negative: {
+        if (is_floating(value.type)) {
+          body_ << result << " = fneg " << type << ' ' << value.text << newline;
+        } else {
+          body_ << result << " = sub " << type << " 0, " << value.text << newline;
+        }
+        break;
+      }
+      case Operator::BitNot: {
+        if (is_floating(value.type)) {
+          unsupported(expr, "bitwise operators on floating point values");
+        }
+        body_ << result << " = xor " << type << ' ' << value.text << ", -1" << newline;
+        break;
+      }
+      default: {
+        unsupported(expr, "unary operators of this kind");
+      }
+    }
+    return IrValue{result, value.type};
+  }
+
+  auto emit_binary(const BinaryExpression& expr) -> IrValue {
+    const auto op = expr.op();
+    if (op == Operator::Access) {
+      return load(address(expr), expr);
+    }
+    if (op == Operator::Static) {
+      unsupported(expr, "qualified names");
+    }
+    if (is_assignment(op)) {
+      return emit_assignment(expr);
+    }
+    if (op == Operator::And || op == Operator::Or) {
+      return emit_logical(expr);
+    }
+
+    const auto lhs = emit_value(deref(expr.lhs()));
+    const auto rhs = emit_value(deref(expr.rhs()));
+    return emit_arithmetic(op, lhs, rhs, expr);
+  }
+
+  auto emit_arithmetic(Operator op, const IrValue& lhs, const IrValue& rhs, const BaseSyntax& node)
+      -> IrValue {
+    // Shifts promote each operand on its own, the result has the type of the left one.
+    if (op == Operator::ShiftLeft || op == Operator::ShiftRight) {
+      const auto type = promote(lhs.type);
+      if (is_floating(type) || is_floating(rhs.type)) {
+        unsupported(node, "shifts of floating point values");
+      }
+
+      const auto value  = convert(lhs, type);
+      const auto amount = convert(rhs, type);
+      const auto result = next_value();
+      const auto shift  = op == Operator::ShiftLeft ? "shl" : is_signed(type) ? "ashr" : "lshr";
+      body_ << result << " = " << shift << ' ' << register_type(type) << ' ' << value.text << ", "
+            << amount.text << newline;
+      return IrValue{result, type};
+    }
+
+    const auto type   = common_type(lhs.type, rhs.type);
+    const auto left   = convert(lhs, type);
+    const auto right  = convert(rhs, type);
+    const auto result = next_value();
+    if (auto it = comparison_op_map.find(op); it != comparison_op_map.end()) {
+      body_ << result << " = " << select(it->second, type) << ' ' << register_type(type) << ' '
+            << left.text << ", " << right.text << newline;
+      return IrValue{result, ConstantType::Bool};
+    }
+
+    auto it = arithmetic_op_map.find(op);
+    if (it == arithmetic_op_map.end()) {
+      unsupported(node, "binary operators of this kind");
+    }
+    const auto instruction = select(it->second, type);
+    if (instruction.empty()) {
+      unsupported(node, "bitwise operators on floating point values");
+    }
+    body_ << result << " = " << instruction << ' ' << register_type(type) << ' ' << left.text
+          << ", " << right.text << newline;
+    return IrValue{result, type};
+  }
+
+  auto emit_assignment(const BinaryExpression& expr) -> IrValue {
+    const auto slot = address(deref(expr.lhs()));
+    if (slot.type.structure) {
+      unsupported(expr, "structure assignments");
+    }
+
+    auto value = emit_value(deref(expr.rhs()));
+    if (expr.op() != Operator::Assign) {
+      auto compound = compound_op_map.find(expr.op());
+      if (compound == compound_op_map.end()) {
+        unsupported(expr, "assignment operators of this kind");
+      }
+      value = emit_arithmetic(compound->second, load(slot, expr), value, expr);
+    }
+
+    const auto stored = convert(value, slot.type.scalar);
+    store(slot, stored);
+    return stored;
+  }
+
+  // The right operand only runs when the left one does not decide the result.
+  auto emit_logical(const BinaryExpression& expr) -> IrValue {
+    const auto is_and = expr.op() == Operator::And;
+    const auto lhs    = to_bool(emit_value(deref(expr.lhs())));
+    const auto from   = block_;
+    const auto right  = next_name(is_and ? "and.rhs" : "or.rhs");
+    const auto end    = next_name(is_and ? "and.end" : "or.end");
+    branch(lhs, is_and ? right : end, is_and ? end : right);
+
+    begin_block(right);
+    const auto rhs  = to_bool(emit_value(deref(expr.rhs())));
+    const auto last = block_;
+    begin_block(end);
+
+    const auto result = next_value();
+    body_ << result << " = phi i1 [ " << (is_and ? "false" : "true") << ", %" << from << " ], [ "
+          << rhs.text << ", %" << last << " ]" << newline;
+    return IrValue{result, ConstantType::Bool};
+  }
+};
+
+auto generate_ir_module(OutputManifest& outputs,
+                        OutputBuffer& writer,
+                        const ProjectConfig& config,
+                        const ProjectTree& project_tree,
+                        const SyntaxTree& syntax_tree) -> void {
+  auto& source = deref(syntax_tree.source());
+  TRACE_PRINT("Generating : " << source.gen_ir_path() << std::endl);
+  PROFILE_SCOPE("Generate IR Module", source.rel_path());
+  TRACE_TIMER("Generator");
+
+  auto emitter = ModuleEmitter{deref(project_tree.symbols()), config, project_tree, source};
+  emitter.emit(syntax_tree);
+
+  writer.clear();
+  emitter.write(writer);
+  source.stats().generated_source_bytes = writer.size();
+  outputs.write(source.gen_ir_path(), writer.view());
+}
@@ -0,0 +1,25 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "gen_output.hpp"
+#include "output_buffer.hpp"
+#include "project_tree.hpp"
+
+/**
+ * Writes the textual LLVM IR module of a checked source to its gen_ir_path
+ *
+ * Functions, module variables, structures, control flow and arithmetic on fixed width C types are
+ * lowered, anything else is reported as an error. Symbols get the names the C++ backend gives
+ * them, so a module links against generated C++ and the entry point calls into it unchanged.
+ */
+auto generate_ir_module(OutputManifest& outputs,
+                        OutputBuffer& writer,
+                        const ProjectConfig& config,
+                        const ProjectTree& project_tree,
+                        const SyntaxTree& syntax_tree) -> void;
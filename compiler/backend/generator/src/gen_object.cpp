@@ -7,18 +7,19 @@
 #include "gen_func.hpp"
 #include "gen_struct.hpp"
 
-auto write_declaration(std::ostream& writer, const ObjectDefinition& def) -> void {
+auto write_declaration(OutputBuffer& writer, const ObjectDefinition& def) -> void {
   writer << "class " << def.name();
 }
 
-auto write_forward_decl(std::ostream& writer, const ObjectDefinition& def) -> void {
+auto write_forward_decl(OutputBuffer& writer, const ObjectDefinition& def) -> void {
   write_declaration(writer, def);
   writer << ';';
 }
 
-auto write_object_definition(std::ostream& writer, const ObjectDefinition& str) -> void {
+auto write_object_definition(OutputBuffer& writer, const ObjectDefinition& str) -> void {
   write_declaration(writer, str);
   writer << " {";
+  writer.indent();
 
   for (auto& var : str.variables()) {
     writer << newline;
@@ -40,5 +41,6 @@ auto write_object_definition(std::ostream& writer, const ObjectDefinition& str)
     write_object_definition(writer, deref(object));
   }
 
+  writer.dedent();
   writer << newline << "};" << newline;
 }
\ No newline at end of file
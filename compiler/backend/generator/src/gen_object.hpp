@@ -9,6 +9,6 @@
 
 #include "gen_common.hpp"
 
-auto write_forward_decl(std::ostream& writer, const ObjectDefinition& def) -> void;
+auto write_forward_decl(OutputBuffer& writer, const ObjectDefinition& def) -> void;
 
-auto write_object_definition(std::ostream& writer, const ObjectDefinition& str) -> void;
\ No newline at end of file
+auto write_object_definition(OutputBuffer& writer, const ObjectDefinition& str) -> void;
\ No newline at end of file
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "gen_output.hpp"
+
+#include <sstream>
+
+constexpr auto manifest_file_name = std::string_view{"outputs.manifest"};
+
+auto read_file(const fs::path& path) -> std::string {
+  auto buffer = std::stringstream{};
+  auto file   = std::ifstream{path, std::ios::binary};
+  buffer << file.rdbuf();
+  return buffer.str();
+}
+
+// Each manifest line is "<hex hash> <generic path relative to the build directory>".
+OutputManifest::OutputManifest(const ProjectConfig& config)
+    : path_{config.dir_build() / manifest_file_name} {
+  auto stream = std::ifstream{path_};
+  auto line   = std::string{};
+
+  while (std::getline(stream, line)) {
+    const auto view = std::string_view{line};
+    if (view.size() <= hash_hex_length + 1 || view[hash_hex_length] != ' ') {
+      continue;
+    }
+
+    if (auto hash = from_hex(view.substr(0, hash_hex_length))) {
+      entries_[std::string{view.substr(hash_hex_length + 1)}] = Entry{*hash, false};
+    }
+  }
+}
+
+auto OutputManifest::key(const fs::path& path) const -> std::string {
+  return fs::proximate(path, path_.parent_path()).generic_string();
+}
+
+auto OutputManifest::write(const fs::path& path, std::string_view content) -> void {
+  const auto hash     = hash_content(content);
+  const auto name     = key(path);
+  const auto recorded = entries_.contains(name);
+
+  auto& entry         = entries_[name];
+  entry.produced      = true;
+
+  // Trust the manifest when the file is still there, otherwise fall back to the disk contents so
+  // a deleted manifest does not force a full rebuild.
+  if (fs::exists(path)) {
+    if (recorded ? entry.hash == hash : hash_content(read_file(path)) == hash) {
+      entry.hash = hash;
+      ++unchanged_;
+      return;
+    }
+  }
+
+  if (path.has_parent_path()) {
+    fs::create_directories(path.parent_path());
+  }
+
+  auto stream = std::ofstream{path, std::ios::binary};
+  stream.write(content.data(), static_cast<std::streamsize>(content.size()));
+  if (stream.fail()) {
+    std::cerr << "Error : failed to write " << path << std::endl;
+    exit(-1);
+  }
+
+  entry.hash = hash;
+  ++written_;
+}
+
+auto OutputManifest::retain(const fs::path& path) -> void {
+  const auto name     = key(path);
+  const auto recorded = entries_.contains(name);
+
+  auto& entry         = entries_[name];
+  entry.produced      = true;
+
+  if (!recorded && fs::exists(path)) {
+    entry.hash = hash_content(read_file(path));
+  }
+  ++unchanged_;
+}
+
+auto OutputManifest::save() -> void {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.produced) {
+      ++it;
+      continue;
+    }
+
+    TRACE_PRINT("Removing stale output : " << it->first << std::endl);
+    fs::remove(path_.parent_path() / it->first);
+    it = entries_.erase(it);
+  }
+
+  fs::create_directories(path_.parent_path());
+  auto stream = std::ofstream{path_};
+  for (auto& [path, entry] : entries_) {
+    stream << to_hex(entry.hash) << ' ' << path << newline;
+  }
+
+  TRACE_PRINT("Outputs written : " << written_ << ", unchanged : " << unchanged_ << std::endl);
+}
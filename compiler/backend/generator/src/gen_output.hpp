@@ -0,0 +1,51 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "project_config.hpp"
+#include "hash.hpp"
+
+/**
+ * OutputManifest
+ * \brief Writes generated files only when their content changed
+ *
+ * Hashes of every output are kept in a manifest under the build directory. Unchanged outputs keep
+ * their mtime so the native build does not recompile them, outputs that are no longer produced are
+ * removed when the manifest is saved.
+ */
+class OutputManifest final {
+  struct Entry final {
+    ContentHash hash = 0;
+    bool produced    = false;
+  };
+
+  fs::path path_;
+  std::map<std::string, Entry> entries_;
+
+  uint64_t written_   = 0;
+  uint64_t unchanged_ = 0;
+
+ public:
+  explicit OutputManifest(const ProjectConfig& config);
+
+  NODISCARD auto written() const { return written_; }
+  NODISCARD auto unchanged() const { return unchanged_; }
+
+  auto write(const fs::path& path, std::string_view content) -> void;
+
+  /**
+   * Keeps an output of a source that was not regenerated this run
+   */
+  auto retain(const fs::path& path) -> void;
+
+  auto save() -> void;
+
+ private:
+  // Keys are relative to the build directory so they do not depend on where tyc was started.
+  NODISCARD auto key(const fs::path& path) const -> std::string;
+};
@@ -0,0 +1,183 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "gen_pch.hpp"
+
+#include "gen_includes.hpp"
+
+#include <map>
+#include <unordered_set>
+
+#include "profiler.hpp"
+
+constexpr auto builtins_file_name = std::string_view{"__builtins.hpp"};
+
+/**
+ * GeneratedHeader
+ * \brief Header a generated source includes, a node of the include graph keyed by file name
+ *
+ * Namespace headers of referenced projects are external, neither their includes nor their names
+ * are known.
+ */
+struct GeneratedHeader final {
+  bool external = true;
+  size_t fan_in = 0;
+  std::vector<std::string> includes;
+  std::vector<std::string> names;
+};
+
+using HeaderGraph = std::map<std::string, GeneratedHeader>;
+
+auto header_file_name(const SourceContext& source) -> std::string {
+  return source.gen_header_internal_path().filename().string();
+}
+
+/**
+ * IncludeGraph
+ * \brief Internal headers with what they include, and what every generated source includes
+ */
+struct IncludeGraph final {
+  HeaderGraph headers;
+  std::vector<std::vector<std::string>> sources;
+  std::unordered_set<std::string> privates;
+};
+
+// An internal header includes the namespaces its source imports from referenced projects and the
+// headers its declarations use, a source its own internal header and the headers it uses.
+auto add_source(IncludeGraph& graph,
+                const DeclarationIndex& index,
+                const SourceContext& source,
+                const SourceUses* uses,
+                std::span<const std::string> imports,
+                std::span<const ExportedSymbol> exports,
+                std::span<const std::string> private_names) -> void {
+  auto& header    = graph.headers[header_file_name(source)];
+  header.external = false;
+  for (auto& import : imports) {
+    if (!index.is_local(import)) {
+      header.includes.push_back(namespace_file_name(import));
+    }
+  }
+  for (auto& symbol : exports) {
+    header.names.push_back(symbol.name);
+  }
+  graph.privates.insert(private_names.begin(), private_names.end());
+
+  auto& includes = graph.sources.emplace_back(std::vector{header_file_name(source)});
+  if (!uses) {
+    return;
+  }
+
+  for (auto* used : included_headers(index, uses->header_uses)) {
+    header.includes.push_back(header_file_name(deref(used)));
+  }
+  // Forward declared structures are named by the header as well.
+  for (auto& key : uses->header_uses) {
+    if (auto* site = index.find(key); site && site->kind == SymbolKind::Struct) {
+      header.names.emplace_back(site->name);
+    }
+  }
+  for (auto* used : included_headers(index, uses->uses)) {
+    includes.push_back(header_file_name(deref(used)));
+  }
+}
+
+auto add_namespace(IncludeGraph& graph,
+                   const DeclarationIndex& index,
+                   const ProjectTree& project_tree,
+                   const NameSpace& ns) -> void {
+  for (auto& ptree : ns.trees()) {
+    auto& tree   = deref(ptree);
+    auto& source = deref(tree.source());
+    auto imports = std::vector<std::string>{};
+    for (auto& pimport : tree.imports()) {
+      imports.push_back(deref(pimport).full_name());
+    }
+    add_source(graph, index, source, project_tree.uses(source), imports, collect_exports(tree),
+               collect_private_names(tree));
+  }
+  for (auto& retained : ns.retained()) {
+    auto& source = deref(retained.source);
+    auto& record = deref(retained.record);
+    add_source(graph, index, source, project_tree.uses(source), record.imports, record.exports,
+               record.privates);
+  }
+
+  for (auto& psub : ns.sub_spaces()) {
+    add_namespace(graph, index, project_tree, deref(psub));
+  }
+}
+
+auto include_closure(const HeaderGraph& headers, std::span<const std::string> includes)
+    -> std::unordered_set<std::string> {
+  auto closure = std::unordered_set<std::string>{includes.begin(), includes.end()};
+  auto pending = std::vector<std::string>{includes.begin(), includes.end()};
+  while (!pending.empty()) {
+    const auto current = std::move(pending.back());
+    pending.pop_back();
+    if (auto it = headers.find(current); it != headers.end()) {
+      for (auto& include : it->second.includes) {
+        if (closure.insert(include).second) {
+          pending.push_back(include);
+        }
+      }
+    }
+  }
+  return closure;
+}
+
+auto select_precompiled_headers(const ProjectConfig& config,
+                                const ProjectTree& project_tree,
+                                const DeclarationIndex& index) -> std::vector<std::string> {
+  PROFILE_SCOPE("Select Precompiled Headers");
+  auto selected = std::vector<std::string>{};
+
+  const auto builtins = config.dir_project() / builtins_file_name;
+  if (fs::exists(builtins)) {
+    selected.push_back(fs::absolute(builtins).generic_string());
+  }
+
+  auto graph = IncludeGraph{};
+  add_namespace(graph, index, project_tree, deref(project_tree.root()));
+
+  auto& headers = graph.headers;
+
+  for (auto& includes : graph.sources) {
+    for (auto& included : include_closure(headers, includes)) {
+      headers[included].fan_in += 1;
+    }
+  }
+
+  auto clashes = [&](const std::string& file_name) {
+    const auto closure = include_closure(headers, std::span{&file_name, 1});
+    return std::any_of(closure.begin(), closure.end(), [&](auto& included) {
+      auto& names = headers[included].names;
+      return std::any_of(
+          names.begin(), names.end(), [&](auto& name) { return graph.privates.contains(name); });
+    });
+  };
+
+  const auto total = graph.sources.size();
+  auto candidates  = std::vector<std::pair<const std::string*, const GeneratedHeader*>>{};
+  for (auto& [file_name, header] : headers) {
+    if (total != 0 && header.fan_in * 2 >= total && !clashes(file_name)) {
+      candidates.emplace_back(&file_name, &header);
+    }
+  }
+
+  // Most included first, headers included by the most used ones lead.
+  std::stable_sort(candidates.begin(), candidates.end(), [](auto& lhs, auto& rhs) {
+    return lhs.second->fan_in > rhs.second->fan_in;
+  });
+
+  // Headers of referenced projects are found on the include path, generated ones by their path.
+  const auto gen_source = fs::absolute(config.dir_gen_source());
+  for (auto [file_name, header] : candidates) {
+    if (header->external) {
+      selected.push_back('<' + *file_name + '>');
+    } else {
+      selected.push_back((gen_source / *file_name).generic_string());
+    }
+  }
+  return selected;
+}
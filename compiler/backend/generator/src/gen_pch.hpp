@@ -0,0 +1,24 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "project_config.hpp"
+#include "project_tree.hpp"
+
+class DeclarationIndex;
+
+/**
+ * Headers worth precompiling, spelled as target_precompile_headers expects them
+ *
+ * The builtins of the project and every header in the include closure of at least half of the
+ * generated sources are chosen. A header is left out when a name it declares is also the name of a
+ * private definition, which would clash in the files that did not include it before.
+ */
+auto select_precompiled_headers(const ProjectConfig& config,
+                                const ProjectTree& project_tree,
+                                const DeclarationIndex& index) -> std::vector<std::string>;
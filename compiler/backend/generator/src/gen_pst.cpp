@@ -3,89 +3,101 @@
 
 #include "gen_pst.hpp"
 
-constexpr auto root_node_name     = std::string_view{"SymbolTable"};
-constexpr auto ns_node_name       = std::string_view{"Namespace"};
-
-constexpr auto cinclude_node_name = std::string_view{"CInclude"};
-constexpr auto ctype_node_name    = std::string_view{"CType"};
-
-constexpr auto var_node_name      = std::string_view{"Variable"};
-constexpr auto struct_node_name   = std::string_view{"Struct"};
-
-constexpr auto proj_attr_name     = std::string_view{"project"};
-constexpr auto name_attr_name     = std::string_view{"name"};
-constexpr auto type_attr_name     = std::string_view{"type"};
-constexpr auto ctype_attr_name    = std::string_view{"ctype"};
-
-auto create_node(xml::document& doc, const CInclude& include) -> xml::node& {
-  auto& node = xml::allocate_element(doc, cinclude_node_name);
-  node.append_attribute(&xml::allocate_attribute(doc, name_attr_name, include.name()));
-  return node;
-}
-
-auto create_node(xml::document& doc, const CTypeDefinition& ctype) -> xml::node& {
-  auto& node = xml::allocate_element(doc, ctype_node_name);
-  node.append_attribute(&xml::allocate_attribute(doc, name_attr_name, ctype.name()));
-  node.append_attribute(&xml::allocate_attribute(doc, ctype_attr_name, ctype.c_name()));
-  return node;
-}
-
-auto create_node(xml::document& doc, const VariableDefinition& var) -> xml::node& {
-  auto& node = xml::allocate_element(doc, var_node_name);
-  node.append_attribute(&xml::allocate_attribute(doc, name_attr_name, var.name()));
-  node.append_attribute(&xml::allocate_attribute(doc, type_attr_name, var.type_name()));
-  return node;
-}
-
-auto create_node(xml::document& doc, const StructDefinition& strct) -> xml::node& {
-  auto& node = xml::allocate_element(doc, struct_node_name);
-  node.append_attribute(&xml::allocate_attribute(doc, name_attr_name, strct.name()));
-  return node;
-}
+#include <sstream>
+
+#include "profiler.hpp"
+#include "symbol_file.hpp"
+
+constexpr auto root_node_name      = std::string_view{"SymbolTable"};
+constexpr auto ns_node_name        = std::string_view{"Namespace"};
+
+constexpr auto cinclude_node_name  = std::string_view{"CInclude"};
+constexpr auto ctype_node_name     = std::string_view{"CType"};
+
+constexpr auto var_node_name       = std::string_view{"Variable"};
+constexpr auto struct_node_name    = std::string_view{"Struct"};
+constexpr auto object_node_name    = std::string_view{"Object"};
+constexpr auto func_node_name      = std::string_view{"Function"};
+
+constexpr auto proj_attr_name      = std::string_view{"project"};
+constexpr auto name_attr_name      = std::string_view{"name"};
+constexpr auto type_attr_name      = std::string_view{"type"};
+constexpr auto ctype_attr_name     = std::string_view{"ctype"};
+constexpr auto mutable_attr_name   = std::string_view{"mutable"};
+constexpr auto members_attr_name   = std::string_view{"members"};
+constexpr auto signature_attr_name = std::string_view{"signature"};
+
+// Symbols of parsed sources are temporaries, so names are copied into the document.
+auto create_node(xml::document& doc, const ExportedSymbol& symbol) -> xml::node& {
+  const auto name   = xml::allocate_string(doc, symbol.name);
+  const auto detail = xml::allocate_string(doc, symbol.detail);
+
+  auto element      = [&](std::string_view node_name, std::string_view detail_name) -> auto& {
+    auto& node = xml::allocate_element(doc, node_name);
+    node.append_attribute(&xml::allocate_attribute(doc, name_attr_name, name));
+    if (!detail_name.empty()) {
+      node.append_attribute(&xml::allocate_attribute(doc, detail_name, detail));
+    }
+    return node;
+  };
 
-auto append_cincludes(xml::document& doc, xml::node& node, const SyntaxTree& tree) {
-  for (auto& pinclude : tree.cincludes()) {
-    auto& include = deref(pinclude);
-    if (include.access() >= AccessModifier::Public) {
-      node.append_node(&create_node(doc, include));
+  switch (symbol.kind) {
+    case SymbolKind::CInclude: {
+      return element(cinclude_node_name, {});
+    }
+    case SymbolKind::CType: {
+      return element(ctype_node_name, ctype_attr_name);
+    }
+    // Parameters are never exported, one would read as a variable.
+    case SymbolKind::Variable:
+    case SymbolKind::Parameter: {
+      auto& node = element(var_node_name, type_attr_name);
+      if (symbol.is_mutable) {
+        node.append_attribute(&xml::allocate_attribute(doc, mutable_attr_name, "true"));
+      }
+      return node;
+    }
+    case SymbolKind::Struct: {
+      return element(struct_node_name, members_attr_name);
+    }
+    case SymbolKind::Object: {
+      return element(object_node_name, members_attr_name);
+    }
+    case SymbolKind::Function: {
+      return element(func_node_name, signature_attr_name);
     }
   }
+  return element(var_node_name, type_attr_name);
 }
 
-auto append_ctypes(xml::document& doc, xml::node& node, const SyntaxTree& tree) {
-  for (auto& ptype : tree.ctypes()) {
-    auto& ctype = deref(ptype);
-    if (ctype.access() >= AccessModifier::Public) {
-      node.append_node(&create_node(doc, ctype));
-    }
-  }
+auto is_published(const ExportedSymbol& symbol) -> bool {
+  return symbol.access >= AccessModifier::Public;
 }
 
-auto append_variables(xml::document& doc, xml::node& node, const SyntaxTree& tree) {
-  for (auto& pvariable : tree.variables()) {
-    auto& variable = deref(pvariable);
-    if (variable.access() >= AccessModifier::Public) {
-      node.append_node(&create_node(doc, variable));
-    }
+// Retained sources are not parsed, their exports come from the dependency database.
+auto namespace_exports(const NameSpace& ns) -> std::map<fs::path, std::vector<ExportedSymbol>> {
+  auto exports = std::map<fs::path, std::vector<ExportedSymbol>>{};
+  for (auto& ptree : ns.trees()) {
+    auto& tree                               = deref(ptree);
+    exports[deref(tree.source()).rel_path()] = collect_exports(tree);
+  }
+  for (auto& retained : ns.retained()) {
+    exports[deref(retained.source).rel_path()] = deref(retained.record).exports;
   }
+  return exports;
 }
 
-auto append_structs(xml::document& doc, xml::node& node, const SyntaxTree& tree) {
-  for (auto& pstruct : tree.structs()) {
-    auto& strct = deref(pstruct);
-    if (strct.access() >= AccessModifier::Public) {
-      node.append_node(&create_node(doc, strct));
+/* Debug Dump */
+
+auto append_exports(xml::document& doc, xml::node& node, std::span<const ExportedSymbol> exports) {
+  for (auto& symbol : exports) {
+    if (!is_published(symbol)) {
+      continue;
     }
+    node.append_node(&create_node(doc, symbol));
   }
 }
 
-auto append_tree(xml::document& doc, xml::node& node, const SyntaxTree& tree) {
-  append_cincludes(doc, node, tree);
-  append_ctypes(doc, node, tree);
-  append_variables(doc, node, tree);
-  append_structs(doc, node, tree);
-}
-
 auto create_namespace(xml::document& doc, const NameSpace& ns) -> xml::node& {
   auto& node = xml::allocate_element(doc, ns_node_name);
 
@@ -93,8 +105,8 @@ auto create_namespace(xml::document& doc, const NameSpace& ns) -> xml::node& {
     node.append_attribute(&xml::allocate_attribute(doc, name_attr_name, ns.name()));
   }
 
-  for (auto& ptree : ns.trees()) {
-    append_tree(doc, node, deref(ptree));
+  for (auto& [path, symbols] : namespace_exports(ns)) {
+    append_exports(doc, node, symbols);
   }
 
   for (auto& pns : ns.sub_spaces()) {
@@ -104,7 +116,9 @@ auto create_namespace(xml::document& doc, const NameSpace& ns) -> xml::node& {
   return node;
 }
 
-auto generate_public_symbol_table(const ProjectConfig& config, const ProjectTree& tree) -> void {
+auto write_symbol_dump(OutputManifest& outputs,
+                       const ProjectConfig& config,
+                       const ProjectTree& tree) -> void {
   auto doc   = xml::document{};
 
   auto& root = xml::allocate_element(doc, root_node_name);
@@ -114,7 +128,44 @@ auto generate_public_symbol_table(const ProjectConfig& config, const ProjectTree
 
   doc.append_node(&root);
 
-  auto pub_sym_path = config.dir_binary() / config.name() += ".tysym";
-  auto stream                                             = std::ofstream{pub_sym_path};
+  auto dump_path = config.dir_build() / config.name() += ".tysym.xml";
+  auto stream    = std::ostringstream{};
   stream << doc;
+
+  outputs.write(dump_path, stream.view());
+}
+
+/* Binary Table */
+
+auto append_namespace(SymbolFileWriter& writer, const NameSpace& ns) -> void {
+  const auto index = writer.add_namespace(ns.full_name());
+  for (auto& [path, symbols] : namespace_exports(ns)) {
+    for (auto& symbol : symbols) {
+      if (is_published(symbol)) {
+        writer.add_symbol(index,
+                          static_cast<uint8_t>(symbol.kind),
+                          static_cast<uint8_t>(symbol.access),
+                          symbol.is_mutable,
+                          symbol.name,
+                          symbol.detail);
+      }
+    }
+  }
+
+  for (auto& pns : ns.sub_spaces()) {
+    append_namespace(writer, deref(pns));
+  }
+}
+
+auto generate_public_symbol_table(OutputManifest& outputs,
+                                  const ProjectConfig& config,
+                                  const ProjectTree& tree) -> void {
+  PROFILE_SCOPE("Generate Symbol Table");
+  auto writer = SymbolFileWriter{config.name()};
+  append_namespace(writer, deref(tree.root()));
+
+  outputs.write(config.path_symbols(), writer.serialize());
+
+  // The xml form is not read by the compiler, it is kept for inspecting the table.
+  write_symbol_dump(outputs, config, tree);
 }
@@ -7,4 +7,11 @@
 #error
 #endif
 
-auto generate_public_symbol_table(const ProjectConfig& config, const ProjectTree& tree) -> void;
\ No newline at end of file
+#include "gen_output.hpp"
+
+/**
+ * Writes the binary public symbol table to the binary directory and an xml dump of it to obj
+ */
+auto generate_public_symbol_table(OutputManifest& outputs,
+                                  const ProjectConfig& config,
+                                  const ProjectTree& tree) -> void;
@@ -6,10 +6,10 @@
 #include "gen_expr.hpp"
 #include "gen_var.hpp"
 
-auto write_statement(std::ostream& writer, const std::unique_ptr<BaseStatement>& statement) -> void;
-auto write_block(std::ostream& writer, const StatementBlock& body) -> void;
+auto write_statement(OutputBuffer& writer, const std::unique_ptr<BaseStatement>& statement) -> void;
+auto write_block(OutputBuffer& writer, const StatementBlock& body) -> void;
 
-auto write_stmt_def(std::ostream& writer, const DefinitionStatement& stmt) {
+auto write_stmt_def(OutputBuffer& writer, const DefinitionStatement& stmt) {
   auto& def = deref(stmt.def());
 
   switch (def.kind()) {
@@ -23,49 +23,54 @@ auto write_stmt_def(std::ostream& writer, const DefinitionStatement& stmt) {
   }
 }
 
-auto write_stmt_expr(std::ostream& writer, const ExpressionStatement& stmt) {
+auto write_stmt_expr(OutputBuffer& writer, const ExpressionStatement& stmt) {
   write_expression(writer, stmt.expr());
   writer << ';' << newline;
 }
 
-auto write_stmt_ret(std::ostream& writer, const ReturnStatement& stmt) {
+auto write_stmt_ret(OutputBuffer& writer, const ReturnStatement& stmt) {
   writer << "return ";
   write_expression(writer, stmt.expr());
   writer << ';' << newline;
 }
 
-auto write_stmt_if(std::ostream& writer, const IfStatement& stmt) {
+auto write_stmt_if(OutputBuffer& writer, const IfStatement& stmt) {
   writer << "if (";
   write_expression(writer, stmt.expr());
   writer << ") ";
   write_block(writer, deref(stmt.body()));
+  writer << newline;
 }
 
-auto write_stmt_elif(std::ostream& writer, const ElifStatement& stmt) {
+auto write_stmt_elif(OutputBuffer& writer, const ElifStatement& stmt) {
   writer << "else if (";
   write_expression(writer, stmt.expr());
   writer << ") ";
   write_block(writer, deref(stmt.body()));
+  writer << newline;
 }
 
-auto write_stmt_else(std::ostream& writer, const ElseStatement& stmt) {
+auto write_stmt_else(OutputBuffer& writer, const ElseStatement& stmt) {
   writer << "else ";
   write_block(writer, deref(stmt.body()));
+  writer << newline;
 }
 
-auto write_stmt_loop(std::ostream& writer, const LoopStatement& stmt) {
+auto write_stmt_loop(OutputBuffer& writer, const LoopStatement& stmt) {
   writer << "while (true) ";
   write_block(writer, deref(stmt.body()));
+  writer << newline;
 }
 
-auto write_stmt_while(std::ostream& writer, const WhileStatement& stmt) {
+auto write_stmt_while(OutputBuffer& writer, const WhileStatement& stmt) {
   writer << "while (";
   write_expression(writer, stmt.expr());
   writer << ") ";
   write_block(writer, deref(stmt.body()));
+  writer << newline;
 }
 
-auto write_stmt_for(std::ostream& writer, const ForStatement& stmt) {
+auto write_stmt_for(OutputBuffer& writer, const ForStatement& stmt) {
   writer << "for (";
   write_statement(writer, stmt.prefix());
   writer << ' ';
@@ -74,9 +79,10 @@ auto write_stmt_for(std::ostream& writer, const ForStatement& stmt) {
   write_expression(writer, stmt.postfix());
   writer << ") ";
   write_block(writer, *stmt.body());
+  writer << newline;
 }
 
-auto write_statement(std::ostream& writer, const std::unique_ptr<BaseStatement>& statement)
+auto write_statement(OutputBuffer& writer, const std::unique_ptr<BaseStatement>& statement)
     -> void {
   auto& stmt = deref(statement);
 
@@ -122,14 +128,16 @@ auto write_statement(std::ostream& writer, const std::unique_ptr<BaseStatement>&
   }
 }
 
-auto write_block(std::ostream& writer, const StatementBlock& body) -> void {
+auto write_block(OutputBuffer& writer, const StatementBlock& body) -> void {
   writer << " {";
 
   if (!body.statements().empty()) {
+    writer.indent();
     writer << newline;
     for (auto& statement : body.statements()) {
       write_statement(writer, statement);
     }
+    writer.dedent();
     writer << '}';
   } else {
     writer << " }";
@@ -9,4 +9,4 @@
 
 #include "gen_common.hpp"
 
-auto write_block(std::ostream& writer, const StatementBlock& body) -> void;
\ No newline at end of file
+auto write_block(OutputBuffer& writer, const StatementBlock& body) -> void;
\ No newline at end of file
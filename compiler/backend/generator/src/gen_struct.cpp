@@ -7,18 +7,19 @@
 #include "gen_func.hpp"
 #include "gen_object.hpp"
 
-auto write_declaration(std::ostream& writer, const StructDefinition& def) -> void {
+auto write_declaration(OutputBuffer& writer, const StructDefinition& def) -> void {
   writer << "class " << identifer_prefix << def.name();
 }
 
-auto write_forward_decl(std::ostream& writer, const StructDefinition& def) -> void {
+auto write_forward_decl(OutputBuffer& writer, const StructDefinition& def) -> void {
   write_declaration(writer, def);
   writer << ';';
 }
 
-auto write_struct_definition(std::ostream& writer, const StructDefinition& str) -> void {
+auto write_struct_definition(OutputBuffer& writer, const StructDefinition& str) -> void {
   write_declaration(writer, str);
   writer << " {" << newline;
+  writer.indent();
 
   for (auto& var : str.variables()) {
     write_def(writer, deref(var));
@@ -38,5 +39,6 @@ auto write_struct_definition(std::ostream& writer, const StructDefinition& str)
     write_object_definition(writer, deref(object));
   }
 
+  writer.dedent();
   writer << "};" << newline;
 }
\ No newline at end of file
@@ -9,6 +9,6 @@
 
 #include "gen_common.hpp"
 
-auto write_forward_decl(std::ostream& writer, const StructDefinition& def) -> void;
+auto write_forward_decl(OutputBuffer& writer, const StructDefinition& def) -> void;
 
-auto write_struct_definition(std::ostream& writer, const StructDefinition& str) -> void;
\ No newline at end of file
+auto write_struct_definition(OutputBuffer& writer, const StructDefinition& str) -> void;
\ No newline at end of file
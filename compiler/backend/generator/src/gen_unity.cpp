@@ -0,0 +1,136 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "gen_unity.hpp"
+
+#include "gen_common.hpp"
+
+#include <unordered_set>
+
+#include "profiler.hpp"
+
+constexpr auto unity_file_prefix = std::string_view{"__ty_unity_"};
+
+/**
+ * UnitySource
+ * \brief Generated source of a namespace with the private and other definitions it names
+ */
+struct UnitySource final {
+  const SourceContext* source;
+  std::vector<std::string> privates;
+  std::vector<std::string> names;
+};
+
+/**
+ * UnityBatch
+ * \brief Sources compiled as one translation unit
+ */
+struct UnityBatch final {
+  std::vector<const SourceContext*> sources;
+  std::unordered_set<std::string> privates;
+  std::unordered_set<std::string> names;
+};
+
+// C includes and types are not defined by the generated source, only declared or aliased.
+auto definition_names(std::span<const ExportedSymbol> exports) -> std::vector<std::string> {
+  auto names = std::vector<std::string>{};
+  for (auto& symbol : exports) {
+    if (symbol.kind != SymbolKind::CInclude && symbol.kind != SymbolKind::CType) {
+      names.push_back(symbol.name);
+    }
+  }
+  return names;
+}
+
+// Retained sources are not parsed, their names come from the dependency database.
+auto collect_unity_sources(const NameSpace& ns) -> std::vector<UnitySource> {
+  auto sources = std::vector<UnitySource>{};
+  for (auto& ptree : ns.trees()) {
+    auto& tree = deref(ptree);
+    sources.push_back({tree.source().get(),
+                       collect_private_names(tree),
+                       definition_names(collect_exports(tree))});
+  }
+  for (auto& retained : ns.retained()) {
+    auto& record = deref(retained.record);
+    sources.push_back({retained.source.get(), record.privates, definition_names(record.exports)});
+  }
+
+  // Batches must not depend on which files happened to be parsed.
+  std::sort(sources.begin(), sources.end(), [](auto& lhs, auto& rhs) {
+    return lhs.source->rel_path() < rhs.source->rel_path();
+  });
+  return sources;
+}
+
+// First fit, a source joins the first batch with room where none of its private names is defined
+// and none of its other names is private. Private definitions are file scoped in Typhon, a public
+// definition of the same name in another file is legal but not within one translation unit.
+auto batch_sources(std::span<const UnitySource> sources, size_t batch_size)
+    -> std::vector<UnityBatch> {
+  auto batches = std::vector<UnityBatch>{};
+  for (auto& source : sources) {
+    auto fits = [&](const UnityBatch& batch) {
+      return batch.sources.size() < batch_size &&
+             std::none_of(source.privates.begin(), source.privates.end(),
+                          [&](auto& name) {
+                            return batch.privates.contains(name) || batch.names.contains(name);
+                          }) &&
+             std::none_of(source.names.begin(), source.names.end(),
+                          [&](auto& name) { return batch.privates.contains(name); });
+    };
+
+    auto it = std::find_if(batches.begin(), batches.end(), fits);
+    if (it == batches.end()) {
+      it = batches.emplace(batches.end());
+    }
+    it->sources.push_back(source.source);
+    it->privates.insert(source.privates.begin(), source.privates.end());
+    it->names.insert(source.names.begin(), source.names.end());
+  }
+  return batches;
+}
+
+auto unity_file_name(const NameSpace& ns, size_t index) -> std::string {
+  auto name = std::string{unity_file_prefix};
+  for (auto c : ns.full_name()) {
+    name += c == ':' ? '_' : c;
+  }
+  return name.append("_").append(std::to_string(index)).append(gen_src_file_ext);
+}
+
+auto generate_unity_sources(OutputManifest& outputs,
+                            const ProjectConfig& config,
+                            const NameSpace& ns,
+                            std::vector<fs::path>& paths) -> void {
+  const auto sources = collect_unity_sources(ns);
+  const auto batches = batch_sources(sources, config.unity_batch_size());
+
+  auto writer        = OutputBuffer{};
+  for (auto i = size_t{0}; i < batches.size(); ++i) {
+    writer.clear();
+    writer << "/*" << newline << " *  Generated by Typhon Compiler" << newline
+           << " *      Unity Build : " << ns.full_name() << newline << " */" << newline << newline;
+
+    for (auto* source : batches[i].sources) {
+      const auto path = fs::relative(deref(source).gen_source_path(), config.dir_gen_source());
+      write_include(writer, path.generic_string());
+    }
+
+    auto& path = paths.emplace_back(config.dir_gen_source() / unity_file_name(ns, i));
+    outputs.write(path, writer.view());
+  }
+
+  for (auto& psub : ns.sub_spaces()) {
+    generate_unity_sources(outputs, config, deref(psub), paths);
+  }
+}
+
+auto generate_unity_sources(OutputManifest& outputs,
+                            const ProjectConfig& config,
+                            const ProjectTree& project_tree) -> std::vector<fs::path> {
+  PROFILE_SCOPE("Generate Unity Sources");
+  auto paths = std::vector<fs::path>{};
+  generate_unity_sources(outputs, config, deref(project_tree.root()), paths);
+  return paths;
+}
@@ -0,0 +1,22 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "gen_output.hpp"
+#include "project_tree.hpp"
+
+/**
+ * Writes the amalgamated sources of a unity build and returns their paths
+ *
+ * Generated sources of a namespace are included in batches of the configured size. Private
+ * definitions keep their own name with internal linkage, so a file is never batched with another
+ * that defines one of its private names, privately or not.
+ */
+auto generate_unity_sources(OutputManifest& outputs,
+                            const ProjectConfig& config,
+                            const ProjectTree& project_tree) -> std::vector<fs::path>;
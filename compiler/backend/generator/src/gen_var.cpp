@@ -5,13 +5,13 @@
 
 #include "gen_expr.hpp"
 
-auto write_declaration(std::ostream& writer, const VariableDefinition& def) -> void {
+auto write_declaration(OutputBuffer& writer, const VariableDefinition& def) -> void {
   if (!def.is_mutable()) {
     writer << "const ";
   }
 
   if (def.is_typed()) {
-    writer << identifer_prefix << def.type_name();
+    write_type(writer, deref(def.type()));
   } else {
     writer << keyword_auto;
   }
@@ -19,13 +19,13 @@ auto write_declaration(std::ostream& writer, const VariableDefinition& def) -> v
   writer << ' ' << identifer_prefix << def.name();
 }
 
-auto write_forward_decl(std::ostream& writer, const VariableDefinition& def) -> void {
+auto write_forward_decl(OutputBuffer& writer, const VariableDefinition& def) -> void {
   writer << "extern ";
   write_declaration(writer, def);
   writer << ';' << newline;
 }
 
-auto write_def(std::ostream& writer, const VariableDefinition& def) -> void {
+auto write_def(OutputBuffer& writer, const VariableDefinition& def) -> void {
   write_declaration(writer, def);
 
   if (def.assignment()) {
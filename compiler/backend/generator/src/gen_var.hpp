@@ -9,6 +9,6 @@
 
 #include "gen_common.hpp"
 
-auto write_forward_decl(std::ostream& writer, const VariableDefinition& def) -> void;
+auto write_forward_decl(OutputBuffer& writer, const VariableDefinition& def) -> void;
 
-auto write_def(std::ostream& writer, const VariableDefinition& def) -> void;
\ No newline at end of file
+auto write_def(OutputBuffer& writer, const VariableDefinition& def) -> void;
\ No newline at end of file
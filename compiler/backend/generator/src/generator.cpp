@@ -9,25 +9,54 @@
 #include "gen_object.hpp"
 
 #include "gen_pst.hpp"
+#include "gen_pch.hpp"
+#include "gen_includes.hpp"
+#include "gen_llvm.hpp"
+#include "gen_unity.hpp"
+#include "gen_output.hpp"
+#include "native.hpp"
+#include "profile_data.hpp"
+#include "process.hpp"
+#include "symbol_table.hpp"
+
+#include <sstream>
 
 #include "common.hpp"
 #include "timer.hpp"
+#include "profiler.hpp"
 
-auto forward_decl_structs(std::ostream& writer, const SyntaxTree& tree) {
+// Private definitions are declared in their own source, everything else in the internal header.
+auto is_declared_in(const BaseDefinition& def, GeneratedFile file) -> bool {
+  return (def.access() == AccessModifier::Private) == (file == GeneratedFile::Source);
+}
+
+auto forward_decl_structs(OutputBuffer& writer,
+                          const ProjectTree& project_tree,
+                          const SyntaxTree& tree,
+                          GeneratedFile file) {
   for (auto& strc : tree.structs()) {
+    if (project_tree.is_eliminated(*strc) || !is_declared_in(*strc, file)) {
+      continue;
+    }
     writer << newline;
     write_forward_decl(writer, deref(strc));
   }
 }
 
-auto forward_decl_objects(std::ostream& writer, const SyntaxTree& tree) {
+auto forward_decl_objects(OutputBuffer& writer,
+                          const ProjectTree& project_tree,
+                          const SyntaxTree& tree,
+                          GeneratedFile file) {
   for (auto& object : tree.objects()) {
+    if (project_tree.is_eliminated(*object) || !is_declared_in(*object, file)) {
+      continue;
+    }
     writer << newline;
     write_forward_decl(writer, deref(object));
   }
 }
 
-auto forward_decl_aliases(std::ostream& writer, const SyntaxTree& nodes) {
+auto forward_decl_aliases(OutputBuffer& writer, const SyntaxTree& nodes) {
   // for (auto& node : nodes) {
   //   if (node->kind() == SyntaxKind::DefObject) {
   //     empty = false;
@@ -36,70 +65,119 @@ auto forward_decl_aliases(std::ostream& writer, const SyntaxTree& nodes) {
   // }
 }
 
-auto forward_declare_funcs(std::ostream& writer, const SyntaxTree& tree) {
+auto forward_declare_funcs(OutputBuffer& writer,
+                           const ProjectTree& project_tree,
+                           const SyntaxTree& tree,
+                           GeneratedFile file) {
   for (auto& fn : tree.functions()) {
+    if (project_tree.is_eliminated(*fn) || !is_declared_in(*fn, file)) {
+      continue;
+    }
+    write_linkage(writer, fn->access());
     write_forward_decl(writer, deref(fn));
+    writer << newline;
   }
 }
 
-auto forward_declare_vars(std::ostream& writer, const SyntaxTree& tree) {
+// Private variables are defined before anything of their file refers to them, a static variable
+// can not be declared without being defined.
+auto forward_declare_vars(OutputBuffer& writer,
+                          const ProjectTree& project_tree,
+                          const SyntaxTree& tree) {
   for (auto& var : tree.variables()) {
+    if (project_tree.is_eliminated(*var) || !is_declared_in(*var, GeneratedFile::HeaderInternal)) {
+      continue;
+    }
+    write_linkage(writer, var->access());
     write_forward_decl(writer, deref(ptr_cast<VariableDefinition>(var.get())));
   }
 }
 
-auto forward_declare_source(std::ostream& writer, const SyntaxTree& tree) -> void {
-  // writer << "/*" << newline << " *  Forward Declarations" << newline << " */" << newline;
+// Private types live in an anonymous namespace, private functions are static.
+auto forward_declare_source(OutputBuffer& writer,
+                            const ProjectTree& project_tree,
+                            const SyntaxTree& tree) -> void {
+  const auto start = writer.size();
+  writer << "namespace {";
+
+  const auto types = writer.size();
+  forward_decl_structs(writer, project_tree, tree, GeneratedFile::Source);
+  forward_decl_objects(writer, project_tree, tree, GeneratedFile::Source);
+  if (writer.size() == types) {
+    writer.truncate(start);
+  } else {
+    writer << newline << '}' << newline << newline;
+  }
 
-  // forward_decl_structs(writer, tree, GeneratedFile::Source);
-  // writer << newline;
-  // forward_decl_objects(writer, tree, GeneratedFile::Source);
-  // writer << newline;
-  // forward_decl_aliases(writer, nodes);
-  // writer << newline;
-  // forward_declare_funcs(writer, tree, GeneratedFile::Source);
-  // writer << newline;
+  forward_declare_funcs(writer, project_tree, tree, GeneratedFile::Source);
 }
 
-auto forward_declare_internal(std::ostream& writer, const SyntaxTree& tree) -> void {
+auto forward_declare_internal(OutputBuffer& writer,
+                              const ProjectTree& project_tree,
+                              const SyntaxTree& tree) -> void {
   writer << "/*" << newline << " *  Forward Declarations" << newline << " */" << newline << newline;
 
-  forward_declare_vars(writer, tree);
-  forward_decl_structs(writer, tree);
-  forward_decl_objects(writer, tree);
+  forward_declare_vars(writer, project_tree, tree);
+  forward_decl_structs(writer, project_tree, tree, GeneratedFile::HeaderInternal);
+  forward_decl_objects(writer, project_tree, tree, GeneratedFile::HeaderInternal);
   //forward_decl_aliases(writer, nodes);
-  forward_declare_funcs(writer, tree);
+  forward_declare_funcs(writer, project_tree, tree, GeneratedFile::HeaderInternal);
+}
+
+template <typename Definition, typename Write>
+auto write_type_definition(OutputBuffer& writer, const Definition& def, Write write) -> void {
+  writer << newline;
+  if (def.access() != AccessModifier::Private) {
+    write(writer, def);
+    return;
+  }
+
+  writer << "namespace {" << newline;
+  write(writer, def);
+  writer << '}' << newline;
 }
 
-auto write_definitions(std::ostream& writer, const SyntaxTree& source) -> void {
+// Unreachable definitions are left out, see eliminate_dead_code.
+auto write_definitions(OutputBuffer& writer,
+                       const ProjectTree& project_tree,
+                       const SyntaxTree& source) -> void {
   for (auto& var : source.variables()) {
-    write_def(writer, deref(var));
+    if (!project_tree.is_eliminated(*var)) {
+      write_linkage(writer, var->access());
+      write_def(writer, deref(var));
+    }
   }
 
   for (auto& str : source.structs()) {
-    writer << newline;
-    write_struct_definition(writer, deref(str));
+    if (!project_tree.is_eliminated(*str)) {
+      write_type_definition(writer, deref(str), write_struct_definition);
+    }
   }
 
   for (auto& object : source.objects()) {
-    writer << newline;
-    write_object_definition(writer, deref(object));
+    if (!project_tree.is_eliminated(*object)) {
+      write_type_definition(writer, deref(object), write_object_definition);
+    }
   }
 
   for (auto& fn : source.functions()) {
-    writer << newline;
-    write_definition(writer, deref(fn));
+    if (!project_tree.is_eliminated(*fn)) {
+      writer << newline;
+      write_linkage(writer, fn->access());
+      write_definition(writer, deref(fn));
+    }
   }
 }
 
-auto write_source_header(std::ostream& writer, const fs::path& rel_path) -> void {
+auto write_source_header(OutputBuffer& writer, const fs::path& rel_path) -> void {
   writer << "/*" << newline << " *  Generated by Typhon Compiler" << newline
-         << " *      Source File : " << rel_path << newline << " */" << newline << newline;
+         << " *      Source File : " << rel_path.generic_string() << newline << " */" << newline
+         << newline;
 }
 
 // const auto includes = std::vector<std::string_view>{"cstdint"};
 //
-// auto write_includes(std::ostream& writer) {
+// auto write_includes(OutputBuffer& writer) {
 //   for (auto& include : includes) {
 //     writer << "#include " << include << newline;
 //   }
@@ -108,36 +186,75 @@ auto write_source_header(std::ostream& writer, const fs::path& rel_path) -> void
 //   }
 // }
 
-auto generate_source_file(const NameSpace& ns, const SyntaxTree& syntax_tree) -> void {
+// Sources include their own internal header and those declaring what they use, a change to any
+// other file of the namespace leaves them alone.
+auto generate_source_file(OutputManifest& outputs,
+                          OutputBuffer& writer,
+                          const DeclarationIndex& index,
+                          const ProjectTree& project_tree,
+                          const SyntaxTree& syntax_tree) -> void {
   auto& source        = deref(syntax_tree.source());
   auto& src_file_path = source.gen_source_path();
   TRACE_PRINT("Generating : " << src_file_path << std::endl);
+  PROFILE_SCOPE("Generate Source", source.rel_path());
 
-  fs::create_directories(src_file_path.parent_path());
-  auto writer = std::ofstream{src_file_path};
+  writer.clear();
 
   TRACE_TIMER("Generator");
   write_source_header(writer, source.rel_path());
 
-  write_include(writer, ns.file_name()) << newline;
+  write_include(writer, source.gen_header_internal_path().filename().string());
+  if (auto* uses = project_tree.uses(source)) {
+    write_uses(writer, index, uses->uses);
+  }
+  writer << newline;
+
+  forward_declare_source(writer, project_tree, syntax_tree);
+  write_definitions(writer, project_tree, syntax_tree);
+
+  source.stats().generated_source_bytes = writer.size();
+  outputs.write(src_file_path, writer.view());
+}
+
+auto write_imports(OutputBuffer& writer,
+                   const DeclarationIndex& index,
+                   const SymbolTable* symbols,
+                   const SyntaxTree& tree) -> void {
+  if (!symbols) {
+    return;
+  }
 
-  forward_declare_source(writer, syntax_tree);
-  write_definitions(writer, syntax_tree);
+  // Declarations of the project are included by the file declaring them, only namespaces of
+  // referenced projects are included as a whole.
+  for (auto& pimport : tree.imports()) {
+    const auto full_name = deref(pimport).full_name();
+    if (!index.is_local(full_name) && symbols->namespace_scope(full_name) != invalid_scope_id) {
+      write_include(writer, namespace_file_name(full_name));
+    }
+  }
 }
 
-auto generate_internal_header(const NameSpace& ns, const SyntaxTree& syntax_tree) -> void {
+auto generate_internal_header(OutputManifest& outputs,
+                              OutputBuffer& writer,
+                              const DeclarationIndex& index,
+                              const ProjectTree& project_tree,
+                              const SyntaxTree& syntax_tree) -> void {
   auto& source        = deref(syntax_tree.source());
   auto& src_file_path = source.gen_header_internal_path();
   TRACE_PRINT("Generating : " << src_file_path << std::endl);
+  PROFILE_SCOPE("Generate Internal Header", source.rel_path());
 
-  fs::create_directories(src_file_path.parent_path());
-  auto writer = std::ofstream{src_file_path};
+  writer.clear();
 
   TRACE_TIMER("Generator");
   write_source_header(writer, source.rel_path());
 
   writer << "#pragma once" << newline << newline;
 
+  // Only defined when the project is built as a dynamic library, see generate_cmake.
+  writer << "#ifndef " << export_macro << newline << "#define " << export_macro << newline
+         << "#endif" << newline << newline;
+
   for (auto& pcinclude : syntax_tree.cincludes()) {
     auto& cinclude = deref(pcinclude);
     write_include(writer, cinclude.name());
@@ -153,13 +270,26 @@ auto generate_internal_header(const NameSpace& ns, const SyntaxTree& syntax_tree
   }
 
   writer << newline;
-  write_include(writer, ns.file_name()) << newline;
+  write_imports(writer, index, project_tree.symbols(), syntax_tree);
+  if (auto* uses = project_tree.uses(source)) {
+    write_uses(writer, index, uses->header_uses);
+  }
+  writer << newline;
+
+  forward_declare_internal(writer, project_tree, syntax_tree);
 
-  forward_declare_internal(writer, syntax_tree);
+  source.stats().generated_header_bytes = writer.size();
+  outputs.write(src_file_path, writer.view());
 }
 
-auto generate_namespace_header(const ProjectConfig& config, const NameSpace& ns) {
-  auto writer = std::ofstream{config.dir_gen_source() / ns.file_name()};
+// Generated files include the internal headers they use, the namespace header is what projects
+// importing the namespace include.
+auto generate_namespace_header(OutputManifest& outputs,
+                               OutputBuffer& writer,
+                               const ProjectConfig& config,
+                               const NameSpace& ns) {
+  PROFILE_SCOPE("Generate Namespace Header", ns.file_name());
+  writer.clear();
 
   write_source_header(writer, {});
   writer << "#pragma once" << newline << newline;
@@ -168,38 +298,58 @@ auto generate_namespace_header(const ProjectConfig& config, const NameSpace& ns)
     write_include(writer, deref(ns.parent()).file_name());
   }
 
-  for (auto& ptree : ns.trees()) {
-    auto& tree = deref(ptree);
-    write_include(writer, deref(tree.source()).gen_header_internal_path().filename().string());
+  for (auto* psource : ns.sources()) {
+    write_include(writer, deref(psource).gen_header_internal_path().filename().string());
   }
+
+  outputs.write(config.dir_gen_source() / ns.file_name(), writer.view());
 }
 
-auto generate(const ProjectConfig& config, const NameSpace& ns) -> void {
-  generate_namespace_header(config, ns);
+// One buffer is reused for every file, it stops allocating once it fits the largest of them.
+auto generate(OutputManifest& outputs,
+              OutputBuffer& writer,
+              const DeclarationIndex& index,
+              const ProjectConfig& config,
+              const ProjectTree& project_tree,
+              const NameSpace& ns) -> void {
+  generate_namespace_header(outputs, writer, config, ns);
   for (auto& ptree : ns.trees()) {
     auto& tree = deref(ptree);
-    generate_internal_header(ns, tree);
-    generate_source_file(ns, tree);
+    generate_internal_header(outputs, writer, index, project_tree, tree);
+    if (config.backend() == Backend::Llvm) {
+      generate_ir_module(outputs, writer, config, project_tree, tree);
+    } else {
+      generate_source_file(outputs, writer, index, project_tree, tree);
+    }
+  }
+
+  for (auto& retained : ns.retained()) {
+    auto& source = deref(retained.source);
+    outputs.retain(source.gen_header_internal_path());
+    outputs.retain(config.backend() == Backend::Llvm ? source.gen_ir_path()
+                                                     : source.gen_source_path());
   }
 
   for (auto& psub : ns.sub_spaces()) {
-    generate(config, deref(psub));
+    generate(outputs, writer, index, config, project_tree, deref(psub));
   }
 }
 
+auto write_cmake_source_path(const ProjectConfig& config,
+                             std::ostream& writer,
+                             const fs::path& file_name) -> void {
+  auto src_path = relative(file_name, config.dir_build()).string();
+  std::replace_if(
+      src_path.begin(), src_path.end(), [](auto c) { return c == '\\'; }, '/');
+
+  writer << indent << '"' << src_path << '"' << newline;
+}
+
 auto write_cmake_source_paths(const ProjectConfig& config,
                               std::ostream& writer,
                               const NameSpace& ns) -> void {
-  for (auto& ptree : ns.trees()) {
-    auto& tree     = deref(ptree);
-
-    auto file_name = deref(tree.source()).gen_source_path();
-
-    auto src_path  = relative(file_name, config.dir_build()).string();
-    std::replace_if(
-        src_path.begin(), src_path.end(), [](auto c) { return c == '\\'; }, '/');
-
-    writer << indent << '"' << src_path << '"' << newline;
+  for (auto* psource : ns.sources()) {
+    write_cmake_source_path(config, writer, deref(psource).gen_source_path());
   }
 
   for (auto& psub : ns.sub_spaces()) {
@@ -216,11 +366,179 @@ constexpr auto cmake_exe_prefix      = std::string_view{"add_executable( "};
 constexpr auto cmake_lib_prefix      = std::string_view{"add_library( "};
 
 constexpr auto cmake_lists_file_name = std::string_view{"CMakeLists.txt"};
+constexpr auto main_source_path      = std::string_view{"../../__main.cpp"};
+
+auto cmake_path(const fs::path& path) { return fs::absolute(path).generic_string(); }
+
+auto write_cmake_references(std::ostream& writer,
+                            const ProjectConfig& config,
+                            std::span<const ProjectConfig* const> references) -> void {
+  if (references.empty()) {
+    return;
+  }
+
+  writer << newline << "target_include_directories( " << config.name() << " PRIVATE" << newline;
+  for (auto* preference : references) {
+    writer << indent << '"' << cmake_path(deref(preference).dir_gen_source()) << '"' << newline;
+  }
+  writer << ')' << newline;
+
+  // Multi config generators place binaries in a directory per configuration.
+  writer << "target_link_directories( " << config.name() << " PRIVATE" << newline;
+  for (auto* preference : references) {
+    const auto bin = cmake_path(deref(preference).dir_binary());
+    writer << indent << '"' << bin << '"' << newline;
+    writer << indent << '"' << bin << "/$<CONFIG>\"" << newline;
+  }
+  writer << ')' << newline;
+
+  writer << "target_link_libraries( " << config.name() << " PRIVATE" << newline;
+  for (auto* preference : references) {
+    writer << indent << deref(preference).name() << newline;
+  }
+  writer << ')' << newline;
+}
+
+// Symbols of a dynamic library stay hidden unless their definition is public, see write_linkage.
+auto write_cmake_visibility(std::ostream& writer, const ProjectConfig& config) -> void {
+  writer << newline << "set_target_properties( " << config.name() << " PROPERTIES" << newline;
+  writer << indent << "CXX_VISIBILITY_PRESET hidden" << newline;
+  writer << indent << "VISIBILITY_INLINES_HIDDEN ON" << newline;
+  writer << ')' << newline;
+
+  const auto definition =
+      std::string{"target_compile_definitions( "} + config.name() + " PRIVATE \"";
+  writer << "if( WIN32 )" << newline;
+  writer << indent << definition << export_macro << "=__declspec(dllexport)\" )" << newline;
+  writer << "else()" << newline;
+  writer << indent << definition << export_macro
+         << "=__attribute__((visibility(\\\"default\\\")))\" )" << newline;
+  writer << "endif()" << newline;
+}
+
+auto write_cmake_precompiled_headers(std::ostream& writer,
+                                     const DeclarationIndex& index,
+                                     const ProjectConfig& config,
+                                     const ProjectTree& project_tree) -> void {
+  const auto headers = select_precompiled_headers(config, project_tree, index);
+  if (headers.empty()) {
+    return;
+  }
+
+  writer << newline << "target_precompile_headers( " << config.name() << " PRIVATE" << newline;
+  for (auto& header : headers) {
+    writer << indent << '"' << header << '"' << newline;
+  }
+  writer << ')' << newline;
+
+  // The entry point only declares main, it gains nothing from the generated headers.
+  if (config.binary_type() == BinaryType::Exe) {
+    writer << "set_source_files_properties( \"" << main_source_path
+           << "\" PROPERTIES SKIP_PRECOMPILE_HEADERS ON )" << newline;
+  }
+}
 
-auto generate_cmake(const ProjectConfig& config, const ProjectTree& source) -> void {
+const auto msvc_optimization_map = std::unordered_map<std::string_view, std::string_view>{
+    {"0", "/Od"},
+    {"1", "/O1"},
+    {"2", "/O2"},
+    {"3", "/O2"},
+    {"s", "/O1"},
+    {"z", "/O1"},
+};
+
+/**
+ * Flags of the selected configuration, on top of those of the CMake build type it is built as
+ *
+ * MSVC has no counterpart of -march, the target CPU only applies to the other compilers.
+ */
+auto write_cmake_configuration(std::ostream& writer, const ProjectConfig& config) -> void {
+  const auto& configuration = deref(config.configuration());
+  const auto& name          = config.name();
+
+  auto msvc                 = std::string{msvc_optimization_map.at(configuration.optimization())};
+  auto gnu                  = "-O" + configuration.optimization();
+  if (configuration.debug_info()) {
+    msvc += " /Zi";
+    gnu += " -g";
+  }
+  if (!configuration.target_cpu().empty()) {
+    gnu += " -march=" + configuration.target_cpu();
+  }
+
+  writer << newline << "if( MSVC )" << newline;
+  writer << indent << "target_compile_options( " << name << " PRIVATE " << msvc << " )" << newline;
+  writer << "else()" << newline;
+  writer << indent << "target_compile_options( " << name << " PRIVATE " << gnu << " )" << newline;
+  writer << "endif()" << newline;
+
+  if (configuration.lto()) {
+    writer << "set_target_properties( " << name << " PROPERTIES INTERPROCEDURAL_OPTIMIZATION ON )"
+           << newline;
+  }
+
+  if (!configuration.defines().empty()) {
+    writer << "target_compile_definitions( " << name << " PRIVATE";
+    for (auto& define : configuration.defines()) {
+      writer << ' ' << define;
+    }
+    writer << " )" << newline;
+  }
+}
+
+// MSVC records and reads the database when linking with link time code generation.
+auto write_cmake_profile_stage(std::ostream& writer,
+                               const ProjectConfig& config,
+                               std::string_view msvc_option,
+                               std::string_view compile_flags,
+                               std::string_view link_flags) -> void {
+  const auto& name = config.name();
+  writer << indent << "if( MSVC )" << newline;
+  writer << indent << indent << "target_compile_options( " << name << " PRIVATE /GL )" << newline;
+  writer << indent << indent << "target_link_options( " << name << " PRIVATE /LTCG \"/"
+         << msvc_option << ":PGD=${TYPHON_PROFILE_DIR}/" << name << ".pgd\" )" << newline;
+  writer << indent << "else()" << newline;
+  writer << indent << indent << "target_compile_options( " << name << " PRIVATE " << compile_flags
+         << " )" << newline;
+  if (!link_flags.empty()) {
+    writer << indent << indent << "target_link_options( " << name << " PRIVATE " << link_flags
+           << " )" << newline;
+  }
+  writer << indent << "endif()" << newline;
+}
+
+/**
+ * Flags of the stages of a profile guided build, selected by TYPHON_PROFILE
+ *
+ * Typhon drives the stages itself, configuring Generate, running the training command and then
+ * configuring Use.
+ */
+auto write_cmake_profile(std::ostream& writer, const ProjectConfig& config) -> void {
+  constexpr auto generate = std::string_view{"\"-fprofile-generate=${TYPHON_PROFILE_DIR}\""};
+  constexpr auto use      = std::string_view{
+      "\"-fprofile-use=${TYPHON_PROFILE_DIR}\" $<$<CXX_COMPILER_ID:GNU>:-Wno-missing-profile>"};
+
+  writer << newline << "set( TYPHON_PROFILE \"Off\" CACHE STRING \"Off, Generate or Use\" )"
+         << newline;
+  writer << "set( TYPHON_PROFILE_DIR \"${CMAKE_BINARY_DIR}/profile\" CACHE PATH "
+         << "\"Directory of the training profile\" )" << newline;
+  writer << "if( TYPHON_PROFILE STREQUAL \"Generate\" )" << newline;
+  write_cmake_profile_stage(writer, config, "GENPROFILE", generate, generate);
+  writer << "elseif( TYPHON_PROFILE STREQUAL \"Use\" )" << newline;
+  write_cmake_profile_stage(writer, config, "USEPROFILE", use, {});
+  writer << "endif()" << newline;
+}
+
+auto generate_cmake(OutputManifest& outputs,
+                    const DeclarationIndex& index,
+                    const ProjectConfig& config,
+                    const ProjectTree& source,
+                    std::span<const fs::path> unity_sources,
+                    std::span<const ProjectConfig* const> references) -> void {
+  PROFILE_SCOPE("Generate CMake");
   const auto cmake_file_path = config.dir_build() / cmake_lists_file_name;
 
-  auto writer                = std::ofstream{cmake_file_path};
+  auto writer                = std::ostringstream{};
   writer << cmake_minimim_version << newline << newline;
   writer << cmake_project_prefix << config.name() << cmake_project_postfix << newline << newline;
 
@@ -251,50 +569,242 @@ auto generate_cmake(const ProjectConfig& config, const ProjectTree& source) -> v
   }
 
   if (binary_type == BinaryType::Exe) {
-    writer << newline << indent << "\"../../__main.cpp\"" << newline;
+    writer << newline << indent << '"' << main_source_path << '"' << newline;
   }
 
-  write_cmake_source_paths(config, writer, deref(source.root()));
+  // Sources of a unity build are only compiled through the batches including them.
+  if (config.unity_build()) {
+    for (auto& path : unity_sources) {
+      write_cmake_source_path(config, writer, path);
+    }
+  } else {
+    write_cmake_source_paths(config, writer, deref(source.root()));
+  }
   writer << ')' << newline;
+
+  if (binary_type == BinaryType::Dyn) {
+    write_cmake_visibility(writer, config);
+  }
+
+  write_cmake_precompiled_headers(writer, index, config, source);
+
+  if (config.configuration()) {
+    write_cmake_configuration(writer, config);
+  }
+
+  if (config.profile_guided()) {
+    write_cmake_profile(writer, config);
+  }
+
+  write_cmake_references(writer, config, references);
+
+  outputs.write(cmake_file_path, writer.view());
+}
+
+auto run_tool(const ProcessCommand& command, std::string_view name) -> int {
+  std::cout << "[Typhon] " << name << " Command : " << to_command_line(command) << std::endl;
+  const auto result = [&] {
+    PROFILE_SCOPE(name, to_command_line(command));
+    return run_process(command);
+  }();
+  std::cout << result.output << std::flush;
+  return result.exit_code;
+}
+
+constexpr auto configure_stamp_file_name = std::string_view{"typhon.configure"};
+constexpr auto cmake_cache_file_name     = std::string_view{"CMakeCache.txt"};
+
+// Environment CMake reads when it picks and configures the toolchain.
+constexpr auto toolchain_variables = std::array{
+    "PATH",
+    "CC",
+    "CXX",
+    "CFLAGS",
+    "CXXFLAGS",
+    "LDFLAGS",
+    "CMAKE_GENERATOR",
+    "CMAKE_GENERATOR_PLATFORM",
+    "CMAKE_TOOLCHAIN_FILE",
+};
+
+auto configure_hash(const ProjectConfig& config, const ProcessCommand& command) -> ContentHash {
+  auto stream = std::ifstream{config.dir_build() / cmake_lists_file_name, std::ios::binary};
+  auto lists  = std::ostringstream{};
+  lists << stream.rdbuf();
+
+  auto hash = hash_content(lists.view());
+  hash      = hash_content(to_command_line(command), hash);
+  for (const auto* variable : toolchain_variables) {
+    const auto* value = std::getenv(variable);
+    const auto entry  = std::string{variable} + '=' + (value ? value : "") + '\n';
+    hash              = hash_content(entry, hash);
+  }
+  return hash;
+}
+
+auto read_configure_stamp(const fs::path& path) -> std::optional<ContentHash> {
+  auto stream = std::ifstream{path};
+  auto line   = std::string{};
+  if (!std::getline(stream, line)) {
+    return std::nullopt;
+  }
+  return from_hex(line);
 }
 
-// todo : redirect cmake and compiler output to pipe
-auto make(const ProjectConfig& config, const fs::path& build_path) -> void {
-  const auto cmake_command = std::string{"cmake -S \""} + config.dir_build().string() + "\" -B \"" +
-                             build_path.string() + '"';
+/**
+ * Configures the CMake project unless it was already configured from the same CMakeLists.txt, the
+ * same command and the same toolchain environment
+ */
+auto make(const ProjectConfig& config,
+          const fs::path& build_path,
+          std::span<const std::string> definitions) -> void {
+  auto command =
+      ProcessCommand{{"cmake", "-S", config.dir_build().string(), "-B", build_path.string()}};
+  command.arguments.insert(command.arguments.end(), definitions.begin(), definitions.end());
+  const auto stamp_path = build_path / configure_stamp_file_name;
+  const auto hash       = configure_hash(config, command);
+
+  const auto cached = fs::exists(build_path / cmake_cache_file_name);
+  if (cached && read_configure_stamp(stamp_path) == hash) {
+    std::cout << "[Typhon] CMake : configuration is up to date" << std::endl;
+    return;
+  }
+
+  // A configure that fails half way must not leave the previous stamp behind.
+  auto error = std::error_code{};
+  fs::remove(stamp_path, error);
 
-  std::cout << "[Typhon] CMake Command : " << cmake_command << std::endl;
   TRACE_TIMER("CMake");
-  const auto cmake_result = system(cmake_command.c_str());
-  if (cmake_result != 0) {
+  if (run_tool(command, "CMake") != 0) {
     std::cerr << "Error : failed to configure cmake." << std::endl;
     exit(-1);
   }
+
+  auto stamp = std::ofstream{stamp_path};
+  stamp << to_hex(hash) << newline;
+}
+
+// CMake build type whose default flags agree with the configuration, MSVC rejects the runtime
+// checks of Debug in an optimized build.
+auto cmake_build_type(const ProjectConfiguration& configuration) -> std::string {
+  if (configuration.optimization() == "0") {
+    return "Debug";
+  }
+  return configuration.debug_info() ? "RelWithDebInfo" : "Release";
 }
 
-// todo : build command needs to be implemented for different build systems
 auto build(const ProjectConfig& config, const fs::path& build_path) -> void {
   const auto solution_file = build_path / config.name() += ".sln";
-  const auto build_command = std::string{"msbuild \""} + solution_file.string() + '"';
+  auto command             = ProcessCommand{{"msbuild", solution_file.string()}};
+  if (auto* configuration = config.configuration()) {
+    command.arguments.push_back("/p:Configuration=" + cmake_build_type(*configuration));
+  }
 
-  std::cout << "[Typhon] Build Command : " << build_command << std::endl;
   TRACE_TIMER("Build");
-  const auto compile_result = system(build_command.c_str());
-  if (compile_result != 0) {
+  if (run_tool(command, "Build") != 0) {
     std::cerr << "Error : failed to compile." << std::endl;
     exit(-1);
   }
 }
 
-auto compile(const ProjectConfig& config) -> void {
+/**
+ * Builds the instrumented binary and trains it unless the profile was already recorded, then
+ * builds with the profile
+ */
+auto build_profile_guided(const ProjectConfig& config,
+                          const fs::path& build_path,
+                          std::vector<std::string> definitions) -> void {
+  if (config.binary_type() == BinaryType::Lib) {
+    std::cerr << "Error : a static library is never run, it can not be profile guided."
+              << std::endl;
+    exit(-1);
+  }
+
+  const auto profile = ProfileData{config, fnv_offset_basis};
+  definitions.push_back("-DTYPHON_PROFILE_DIR=" + cmake_path(profile.dir()));
+  if (!profile.is_complete()) {
+    profile.reset();
+    definitions.emplace_back("-DTYPHON_PROFILE=Generate");
+    make(config, build_path, definitions);
+    build(config, build_path);
+    profile.train(config);
+    profile.complete();
+    definitions.pop_back();
+  }
+  definitions.emplace_back("-DTYPHON_PROFILE=Use");
+  make(config, build_path, definitions);
+  build(config, build_path);
+}
+
+// Windows keeps building through the generated CMake project, elsewhere the compiler is run
+// directly so nothing has to be configured.
+auto compile(const ProjectConfig& config,
+             std::span<const ProjectConfig* const> references,
+             std::span<const fs::path> units,
+             const BuildOptions& options) -> void {
+#ifdef _WIN32
+  if (config.backend() == Backend::Llvm) {
+    std::cerr << "Error : the LLVM backend is only built natively." << std::endl;
+    exit(-1);
+  }
   const auto build_path = config.dir_build() / "build";
-  make(config, build_path);
+  auto definitions      = std::vector<std::string>{};
+  if (auto* configuration = config.configuration()) {
+    definitions.push_back("-DCMAKE_BUILD_TYPE=" + cmake_build_type(*configuration));
+  }
+  if (config.profile_guided()) {
+    build_profile_guided(config, build_path, std::move(definitions));
+    return;
+  }
+  make(config, build_path, definitions);
   build(config, build_path);
+#else
+  build_native(config, references, units, options);
+#endif
+}
+
+auto collect_source_paths(const ProjectConfig& config,
+                          const NameSpace& ns,
+                          std::vector<fs::path>& paths) -> void {
+  for (auto* psource : ns.sources()) {
+    auto& source = deref(psource);
+    paths.push_back(config.backend() == Backend::Llvm ? source.gen_ir_path()
+                                                      : source.gen_source_path());
+  }
+  for (auto& psub : ns.sub_spaces()) {
+    collect_source_paths(config, deref(psub), paths);
+  }
 }
 
-auto generate(const ProjectConfig& config, const ProjectTree& project_tree) -> void {
-  generate(config, deref(project_tree.root()));
-  generate_public_symbol_table(config, project_tree);
-  generate_cmake(config, project_tree);
-  compile(config);
+auto generate(const ProjectConfig& config,
+              const ProjectTree& project_tree,
+              std::span<const ProjectConfig* const> references) -> std::vector<fs::path> {
+  auto outputs     = OutputManifest{config};
+  auto writer      = OutputBuffer{config.codegen_mode() == CodegenMode::Readable};
+  const auto index = DeclarationIndex{project_tree};
+
+  generate(outputs, writer, index, config, project_tree, deref(project_tree.root()));
+  generate_public_symbol_table(outputs, config, project_tree);
+
+  // Modules are only built natively, unity batches and CMake projects compile C++ sources.
+  auto unity_sources = std::vector<fs::path>{};
+  if (config.backend() == Backend::Llvm) {
+    outputs.save();
+    auto units = std::vector<fs::path>{};
+    collect_source_paths(config, deref(project_tree.root()), units);
+    return units;
+  }
+  if (config.unity_build()) {
+    unity_sources = generate_unity_sources(outputs, config, project_tree);
+  }
+  generate_cmake(outputs, index, config, project_tree, unity_sources, references);
+
+  outputs.save();
+
+  if (config.unity_build()) {
+    return unity_sources;
+  }
+  auto units = std::vector<fs::path>{};
+  collect_source_paths(config, deref(project_tree.root()), units);
+  return units;
 }
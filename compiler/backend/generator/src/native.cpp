@@ -0,0 +1,667 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "native.hpp"
+
+#include <sstream>
+
+#include "hash.hpp"
+#include "object_cache.hpp"
+#include "process.hpp"
+#include "profile_data.hpp"
+#include "profiler.hpp"
+#include "timer.hpp"
+
+constexpr auto native_dir_name    = std::string_view{"native"};
+constexpr auto commands_file_name = std::string_view{"commands.manifest"};
+constexpr auto main_file_name     = std::string_view{"__main.cpp"};
+constexpr auto profdata_file_name = std::string_view{"default.profdata"};
+
+constexpr auto object_file_ext    = std::string_view{".o"};
+constexpr auto depfile_ext        = std::string_view{".d"};
+constexpr auto preprocessed_ext   = std::string_view{".ii"};
+constexpr auto bitcode_ext        = std::string_view{".bc"};
+constexpr auto raw_profile_ext    = std::string_view{".profraw"};
+constexpr auto static_lib_ext     = std::string_view{".a"};
+constexpr auto shared_lib_ext     = std::string_view{".so"};
+
+/**
+ * CommandManifest
+ * \brief Hash of the command every output of the native build was last produced with
+ *
+ * Each line is "<hex hash> <generic path of the output>".
+ */
+class CommandManifest final {
+  fs::path path_;
+  std::map<std::string, ContentHash> hashes_;
+
+ public:
+  explicit CommandManifest(fs::path path)
+      : path_{std::move(path)} {
+    auto stream = std::ifstream{path_};
+    auto line   = std::string{};
+    while (std::getline(stream, line)) {
+      const auto view = std::string_view{line};
+      if (view.size() <= hash_hex_length + 1 || view[hash_hex_length] != ' ') {
+        continue;
+      }
+      if (auto hash = from_hex(view.substr(0, hash_hex_length))) {
+        hashes_[std::string{view.substr(hash_hex_length + 1)}] = *hash;
+      }
+    }
+  }
+
+  NODISCARD auto matches(const fs::path& output, ContentHash hash) const -> bool {
+    auto it = hashes_.find(output.generic_string());
+    return it != hashes_.end() && it->second == hash;
+  }
+
+  auto set(const fs::path& output, ContentHash hash) -> void {
+    hashes_[output.generic_string()] = hash;
+  }
+
+  auto erase(const fs::path& output) -> void { hashes_.erase(output.generic_string()); }
+
+  auto save() const -> void {
+    fs::create_directories(path_.parent_path());
+    auto stream = std::ofstream{path_};
+    for (auto& [output, hash] : hashes_) {
+      stream << to_hex(hash) << ' ' << output << newline;
+    }
+  }
+};
+
+auto hash_command(const ProcessCommand& command) -> ContentHash {
+  auto hash = fnv_offset_basis;
+  for (auto& argument : command.arguments) {
+    hash = hash_content(argument, hash);
+    hash = hash_content({"\0", 1}, hash);
+  }
+  return hash;
+}
+
+auto tool(const char* variable, std::string_view fallback) -> std::string {
+  const auto* value = std::getenv(variable);
+  return value && *value ? std::string{value} : std::string{fallback};
+}
+
+auto native_binary_path(const ProjectConfig& config) -> fs::path {
+  switch (config.binary_type()) {
+    case BinaryType::Exe: {
+      return config.dir_binary() / config.name();
+    }
+    case BinaryType::Lib: {
+      return config.dir_binary() / ("lib" + config.name() + std::string{static_lib_ext});
+    }
+    case BinaryType::Dyn: {
+      return config.dir_binary() / ("lib" + config.name() + std::string{shared_lib_ext});
+    }
+  }
+  throw std::exception("not implemented!");
+}
+
+// A project built without a configuration is optimized at -O2, as it always was.
+auto optimization_level(const ProjectConfig& config) -> std::string {
+  const auto* configuration = config.configuration();
+  return configuration ? configuration->optimization() : std::string{"2"};
+}
+
+/**
+ * Optimization flags of the selected configuration, passed to the compiler and to the linker
+ */
+auto optimization_flags(const ProjectConfig& config) -> std::vector<std::string> {
+  auto flags                = std::vector<std::string>{"-O" + optimization_level(config)};
+  const auto* configuration = config.configuration();
+  if (!configuration) {
+    return flags;
+  }
+
+  if (!configuration->target_cpu().empty()) {
+    flags.push_back("-march=" + configuration->target_cpu());
+  }
+  if (configuration->debug_info()) {
+    flags.emplace_back("-g");
+  }
+  if (configuration->lto()) {
+    flags.emplace_back("-flto");
+  }
+  return flags;
+}
+
+auto compile_flags(const ProjectConfig& config, std::span<const ProjectConfig* const> references)
+    -> std::vector<std::string> {
+  auto flags = std::vector<std::string>{"-std=c++20"};
+  auto level = optimization_flags(config);
+  flags.insert(flags.end(), level.begin(), level.end());
+
+  if (auto* configuration = config.configuration()) {
+    for (auto& define : configuration->defines()) {
+      flags.push_back("-D" + define);
+    }
+  }
+
+  // Static libraries may end up in a dynamic library of a dependent project.
+  if (config.binary_type() != BinaryType::Exe) {
+    flags.emplace_back("-fPIC");
+  }
+
+  // Same visibility as the generated CMake project, see write_cmake_visibility.
+  if (config.binary_type() == BinaryType::Dyn) {
+    flags.emplace_back("-fvisibility=hidden");
+    flags.emplace_back("-fvisibility-inlines-hidden");
+    flags.emplace_back("-D__ty_export=__attribute__((visibility(\"default\")))");
+  }
+
+  for (auto* preference : references) {
+    flags.push_back("-I" + fs::absolute(deref(preference).dir_gen_source()).generic_string());
+  }
+  return flags;
+}
+
+// Units outside of the build directory, like the entry point, are placed below "__parent".
+auto object_path(const fs::path& native_dir, const fs::path& build_dir, const fs::path& unit)
+    -> fs::path {
+  const auto base     = fs::absolute(build_dir).lexically_normal();
+  const auto relative = fs::absolute(unit).lexically_normal().lexically_relative(base);
+
+  auto object         = native_dir;
+  for (auto& part : relative) {
+    object /= part == ".." ? fs::path{"__parent"} : part;
+  }
+  return object += object_file_ext;
+}
+
+/**
+ * Prerequisites listed by a make style depfile, escaped spaces and line continuations included
+ */
+auto parse_depfile(const fs::path& path) -> std::optional<std::vector<fs::path>> {
+  auto stream = std::ifstream{path};
+  if (!stream) {
+    return std::nullopt;
+  }
+  auto buffer = std::stringstream{};
+  buffer << stream.rdbuf();
+  const auto content = buffer.str();
+
+  // The target ends at the first colon followed by whitespace.
+  auto pos           = content.find(": ");
+  if (pos == std::string::npos) {
+    return std::nullopt;
+  }
+
+  auto prerequisites = std::vector<fs::path>{};
+  auto current       = std::string{};
+  for (pos += 2; pos < content.size(); ++pos) {
+    const auto c = content[pos];
+    if (c == '\\' && pos + 1 < content.size()) {
+      const auto escaped = content[pos + 1];
+      if (escaped == '\n' || escaped == '\r') {
+        ++pos;
+        continue;
+      }
+      if (escaped == ' ' || escaped == '\\') {
+        current += escaped;
+        ++pos;
+        continue;
+      }
+    }
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+      if (!current.empty()) {
+        prerequisites.emplace_back(std::move(current));
+        current.clear();
+      }
+      continue;
+    }
+    current += c;
+  }
+  if (!current.empty()) {
+    prerequisites.emplace_back(std::move(current));
+  }
+  return prerequisites;
+}
+
+auto is_newer_than(const fs::path& path, fs::file_time_type time) -> bool {
+  auto error         = std::error_code{};
+  const auto written = fs::last_write_time(path, error);
+  return error || written > time;
+}
+
+auto is_up_to_date(const fs::path& object, std::span<const fs::path> prerequisites) -> bool {
+  auto error       = std::error_code{};
+  const auto built = fs::last_write_time(object, error);
+  if (error) {
+    return false;
+  }
+  return std::none_of(prerequisites.begin(), prerequisites.end(),
+                      [&](auto& prerequisite) { return is_newer_than(prerequisite, built); });
+}
+
+auto link_command(const ProjectConfig& config,
+                  std::span<const ProjectConfig* const> references,
+                  std::span<const fs::path> objects,
+                  std::span<const std::string> flags,
+                  const fs::path& binary) -> ProcessCommand {
+  auto command = ProcessCommand{};
+  auto& args   = command.arguments;
+
+  if (config.binary_type() == BinaryType::Lib) {
+    args = {tool("AR", "ar"), "rcs", binary.string()};
+    for (auto& object : objects) {
+      args.push_back(object.string());
+    }
+    return command;
+  }
+
+  args.push_back(tool("CXX", "c++"));
+  if (config.binary_type() == BinaryType::Dyn) {
+    args.emplace_back("-shared");
+    args.push_back("-Wl,-soname," + binary.filename().string());
+  }
+  for (auto& object : objects) {
+    args.push_back(object.string());
+  }
+  args.insert(args.end(), flags.begin(), flags.end());
+  args.emplace_back("-o");
+  args.push_back(binary.string());
+
+  // Libraries are passed by path, so a stale library of another binary type is never picked.
+  for (auto* preference : references) {
+    auto& reference = deref(preference);
+    const auto path = fs::absolute(native_binary_path(reference));
+    args.push_back(path.string());
+    if (reference.binary_type() == BinaryType::Dyn) {
+      args.push_back("-Wl,-rpath," + path.parent_path().string());
+    }
+  }
+  return command;
+}
+
+/**
+ * StaleUnit
+ * \brief Translation unit whose object has to be restored from the cache or compiled
+ */
+struct StaleUnit final {
+  fs::path object;
+  ProcessCommand command;
+  ContentHash hash;
+  ProcessCommand preprocess;
+  std::optional<ContentHash> key;
+
+  // Run before the command for IR modules, whose objects are not cached.
+  std::optional<ProcessCommand> optimize;
+};
+
+/**
+ * StageFlags
+ * \brief Flags a stage of a profile guided build adds to the compile and link commands
+ */
+struct StageFlags final {
+  std::vector<std::string> compile;
+  std::vector<std::string> link;
+};
+
+// The version banner stands in for the compiler, null when the compiler can not be run.
+auto compiler_version(const std::string& compiler) -> std::optional<std::string> {
+  auto result = run_process({{compiler, "--version"}});
+  if (result.exit_code != 0) {
+    return std::nullopt;
+  }
+  return std::move(result.output);
+}
+
+auto compiler_identity(const std::string& compiler) -> std::optional<ContentHash> {
+  const auto version = compiler_version(compiler);
+  return version ? std::optional{hash_content(*version)} : std::nullopt;
+}
+
+/**
+ * Keys every stale unit by its preprocessed source and restores the cached ones, returns the units
+ * that still have to be compiled
+ *
+ * Preprocessing writes the depfile as compiling would, so a restored object is up to date on the
+ * next build. Line markers are left out, the key does not depend on where the project lives.
+ */
+auto restore_cached(ObjectCache& cache,
+                    CommandManifest& manifest,
+                    std::vector<StaleUnit> stale,
+                    const std::vector<std::string>& flags,
+                    uint32_t jobs) -> std::vector<StaleUnit> {
+  const auto& compiler = stale.front().command.arguments.front();
+  const auto identity  = compiler_identity(compiler);
+  if (!identity) {
+    return stale;
+  }
+
+  auto base = *identity;
+  for (auto& flag : flags) {
+    base = hash_content(flag, base);
+    base = hash_content({"\0", 1}, base);
+  }
+
+  auto commands = std::vector<ProcessCommand>{};
+  for (auto& unit : stale) {
+    commands.push_back(unit.preprocess);
+  }
+
+  run_processes(commands, jobs, [&](size_t index, const ProcessResult& result) {
+    auto& preprocessed = commands[index].arguments.back();
+    if (result.exit_code == 0) {
+      auto stream = std::ifstream{preprocessed, std::ios::binary};
+      auto buffer = std::ostringstream{};
+      buffer << stream.rdbuf();
+      stale[index].key = hash_content(buffer.view(), base);
+    }
+    auto error = std::error_code{};
+    fs::remove(preprocessed, error);
+  });
+
+  auto misses = std::vector<StaleUnit>{};
+  for (auto& unit : stale) {
+    if (unit.key && cache.restore(*unit.key, unit.object)) {
+      manifest.set(unit.object, unit.hash);
+    } else {
+      misses.push_back(std::move(unit));
+    }
+  }
+  return misses;
+}
+
+/**
+ * Commands lowering an IR module to an object, null when the object is up to date
+ *
+ * opt and llc stand in for the C++ compiler, a module includes nothing so the object only depends
+ * on the module itself.
+ */
+auto stale_module(const ProjectConfig& config,
+                  const fs::path& unit,
+                  const fs::path& object,
+                  const CommandManifest& manifest) -> std::optional<StaleUnit> {
+  const auto bitcode   = fs::path{object}.replace_extension(bitcode_ext);
+  const auto opt       = tool("OPT", "opt");
+  const auto llc       = tool("LLC", "llc");
+
+  // llc only knows the numbered levels, the size levels lower like -O2.
+  const auto level     = optimization_level(config);
+  const auto llc_level = level == "s" || level == "z" ? std::string{"2"} : level;
+
+  auto optimize        = ProcessCommand{{opt, "-O" + level, unit.string(), "-o",
+                                         bitcode.string()}};
+  auto command         = ProcessCommand{{llc, "-O" + llc_level, "-filetype=obj",
+                                         "-relocation-model=pic", bitcode.string(), "-o",
+                                         object.string()}};
+
+  // Both stages are part of the hash, changing either rebuilds the object.
+  auto stages = optimize;
+  stages.arguments.insert(stages.arguments.end(), command.arguments.begin(),
+                          command.arguments.end());
+  const auto hash = hash_command(stages);
+  if (manifest.matches(object, hash) && is_up_to_date(object, {&unit, 1})) {
+    return std::nullopt;
+  }
+  return StaleUnit{object, std::move(command), hash, {}, std::nullopt, std::move(optimize)};
+}
+
+/**
+ * Runs opt over the stale modules, returns the number that failed, those are dropped
+ */
+auto optimize_modules(std::vector<StaleUnit>& modules, CommandManifest& manifest, uint32_t jobs)
+    -> size_t {
+  auto commands = std::vector<ProcessCommand>{};
+  for (auto& module : modules) {
+    commands.push_back(std::move(*module.optimize));
+  }
+
+  auto optimized = std::vector<bool>(modules.size());
+  run_processes(commands, jobs, [&](size_t index, const ProcessResult& result) {
+    std::cout << result.output << std::flush;
+    optimized[index] = result.exit_code == 0;
+  });
+
+  auto failed = size_t{0};
+  auto kept   = std::vector<StaleUnit>{};
+  for (auto i = size_t{0}; i < modules.size(); ++i) {
+    if (optimized[i]) {
+      kept.push_back(std::move(modules[i]));
+    } else {
+      manifest.erase(modules[i].object);
+      ++failed;
+    }
+  }
+  modules = std::move(kept);
+  return failed;
+}
+
+/**
+ * Compiles the stale units and links the binary, the flags of the stage are part of the commands
+ * so a unit compiled by another stage is stale
+ */
+auto build_stage(const ProjectConfig& config,
+                 std::span<const ProjectConfig* const> references,
+                 std::span<const fs::path> all_units,
+                 const BuildOptions& options,
+                 const StageFlags& stage) -> void {
+  const auto native_dir = config.dir_build() / native_dir_name;
+  auto manifest         = CommandManifest{native_dir / commands_file_name};
+
+  const auto compiler   = tool("CXX", "c++");
+  auto flags            = compile_flags(config, references);
+  flags.insert(flags.end(), stage.compile.begin(), stage.compile.end());
+
+  auto objects = std::vector<fs::path>{};
+  auto pending = std::vector<StaleUnit>{};
+  auto modules = std::vector<StaleUnit>{};
+  for (auto& unit : all_units) {
+    const auto object  = object_path(native_dir, config.dir_build(), unit);
+    const auto depfile = fs::path{object}.replace_extension(depfile_ext);
+    const auto output  = fs::path{object}.replace_extension(preprocessed_ext);
+    objects.push_back(object);
+
+    if (unit.extension() == gen_ir_file_ext) {
+      if (auto module = stale_module(config, unit, object, manifest)) {
+        fs::create_directories(object.parent_path());
+        modules.push_back(std::move(*module));
+      }
+      continue;
+    }
+
+    auto command = ProcessCommand{{compiler}};
+    auto& args   = command.arguments;
+    args.insert(args.end(), flags.begin(), flags.end());
+    args.insert(args.end(), {"-MMD", "-MF", depfile.string(), "-c", unit.string(), "-o",
+                             object.string()});
+
+    const auto hash          = hash_command(command);
+    const auto prerequisites = parse_depfile(depfile);
+    if (manifest.matches(object, hash) && prerequisites && is_up_to_date(object, *prerequisites)) {
+      continue;
+    }
+    fs::create_directories(object.parent_path());
+
+    auto preprocess = ProcessCommand{{compiler}};
+    auto& pre_args  = preprocess.arguments;
+    pre_args.insert(pre_args.end(), flags.begin(), flags.end());
+    pre_args.insert(pre_args.end(), {"-E", "-P", "-MMD", "-MF", depfile.string(), "-MT",
+                                     object.string(), unit.string(), "-o", output.string()});
+    pending.push_back({object, std::move(command), hash, std::move(preprocess), std::nullopt,
+                       std::nullopt});
+  }
+
+  const auto stale_count = pending.size();
+  auto cache             = std::optional<ObjectCache>{};
+  if (!options.cache_dir.empty() && !pending.empty()) {
+    cache.emplace(options.cache_dir, options.cache_size);
+    pending = restore_cached(*cache, manifest, std::move(pending), flags, options.jobs);
+  }
+
+  std::cout << "[Typhon] Compile : " << pending.size() + modules.size() << " of "
+            << all_units.size() << " translation units" << std::endl;
+
+  auto failed = optimize_modules(modules, manifest, options.jobs);
+  std::move(modules.begin(), modules.end(), std::back_inserter(pending));
+
+  auto commands = std::vector<ProcessCommand>{};
+  for (auto& unit : pending) {
+    commands.push_back(std::move(unit.command));
+  }
+
+  run_processes(commands, options.jobs, [&](size_t index, const ProcessResult& result) {
+    std::cout << result.output << std::flush;
+    auto& unit = pending[index];
+    if (result.exit_code != 0) {
+      manifest.erase(unit.object);
+      ++failed;
+      return;
+    }
+    manifest.set(unit.object, unit.hash);
+    if (cache && unit.key) {
+      cache->store(*unit.key, unit.object);
+    }
+  });
+  manifest.save();
+
+  if (cache) {
+    cache->trim();
+    std::cout << "[Typhon] Object Cache : " << cache->hits() << " of " << stale_count
+              << " hits, " << cache->stored() << " stored, " << cache->evicted() << " evicted"
+              << std::endl;
+  }
+
+  if (failed != 0) {
+    std::cerr << "Error : failed to compile " << failed << " translation units." << std::endl;
+    exit(-1);
+  }
+
+  const auto binary = native_binary_path(config);
+  auto link_flags   = optimization_flags(config);
+  link_flags.insert(link_flags.end(), stage.link.begin(), stage.link.end());
+  const auto link   = link_command(config, references, objects, link_flags, binary);
+  const auto hash   = hash_command(link);
+
+  auto error        = std::error_code{};
+  const auto linked = fs::last_write_time(binary, error);
+  auto inputs       = objects;
+  for (auto* preference : references) {
+    inputs.push_back(native_binary_path(deref(preference)));
+  }
+
+  // Binaries of references count as inputs, a static library is copied into the binary.
+  const auto stale = error || !manifest.matches(binary, hash) ||
+                     std::any_of(inputs.begin(), inputs.end(),
+                                 [&](auto& input) { return is_newer_than(input, linked); });
+  if (!stale) {
+    return;
+  }
+
+  // Archives are only ever added to, a fresh one drops objects that are gone.
+  fs::create_directories(binary.parent_path());
+  fs::remove(binary, error);
+
+  std::cout << "[Typhon] Link : " << binary.string() << std::endl;
+  const auto result = [&] {
+    PROFILE_SCOPE("Link", config.name());
+    return run_process(link);
+  }();
+  std::cout << result.output << std::flush;
+
+  if (result.exit_code != 0) {
+    manifest.erase(binary);
+    manifest.save();
+    std::cerr << "Error : failed to link." << std::endl;
+    exit(-1);
+  }
+  manifest.set(binary, hash);
+  manifest.save();
+}
+
+/**
+ * Merges the raw profiles clang writes into the profile -fprofile-use reads from the directory
+ */
+auto merge_raw_profiles(const fs::path& dir) -> void {
+  auto command = ProcessCommand{{tool("PROFDATA", "llvm-profdata"), "merge", "-o",
+                                 (dir / profdata_file_name).string()}};
+  for (auto& entry : fs::directory_iterator(dir)) {
+    if (entry.path().extension() == raw_profile_ext) {
+      command.arguments.push_back(entry.path().string());
+    }
+  }
+
+  const auto result = run_process(command);
+  std::cout << result.output << std::flush;
+  if (result.exit_code != 0) {
+    std::cerr << "Error : failed to merge the training profiles." << std::endl;
+    exit(-1);
+  }
+}
+
+/**
+ * Records the training profile unless it was recorded from the same sources, returns the flags of
+ * the optimized stage
+ *
+ * The instrumented stage writes its objects where the optimized stage does, GCC names the counters
+ * of a unit after its object. IR modules are lowered by llc and are not instrumented.
+ */
+auto record_profile(const ProjectConfig& config,
+                    std::span<const ProjectConfig* const> references,
+                    std::span<const fs::path> all_units,
+                    const BuildOptions& options) -> StageFlags {
+  if (config.binary_type() == BinaryType::Lib) {
+    std::cerr << "Error : a static library is never run, it can not be profile guided."
+              << std::endl;
+    exit(-1);
+  }
+
+  const auto compiler = tool("CXX", "c++");
+  const auto version  = compiler_version(compiler);
+  if (!version) {
+    std::cerr << "Error : failed to run the compiler \"" << compiler << "\"." << std::endl;
+    exit(-1);
+  }
+  const auto clang = version->find("clang") != std::string::npos;
+
+  auto seed        = hash_content(*version);
+  for (auto& flag : compile_flags(config, references)) {
+    seed = hash_content(flag, seed);
+    seed = hash_content({"\0", 1}, seed);
+  }
+
+  const auto profile = ProfileData{config, seed};
+  const auto dir     = fs::absolute(profile.dir()).string();
+  if (profile.is_complete()) {
+    std::cout << "[Typhon] Profile : " << profile.dir().string() << " is up to date" << std::endl;
+  } else {
+    std::cout << "[Typhon] Profile : recording " << profile.dir().string() << std::endl;
+    profile.reset();
+
+    const auto generate = "-fprofile-generate=" + dir;
+    build_stage(config, references, all_units, options, {{generate}, {generate}});
+    profile.train(config);
+    if (clang) {
+      merge_raw_profiles(profile.dir());
+    }
+    profile.complete();
+  }
+
+  // Units the training never reached have no counters, that is expected.
+  auto use = StageFlags{{"-fprofile-use=" + dir}, {}};
+  if (!clang) {
+    use.compile.emplace_back("-Wno-missing-profile");
+  }
+  return use;
+}
+
+auto build_native(const ProjectConfig& config,
+                  std::span<const ProjectConfig* const> references,
+                  std::span<const fs::path> units,
+                  const BuildOptions& options) -> void {
+  TRACE_TIMER("Native Build");
+  PROFILE_SCOPE("Native Build", config.name());
+  auto all_units = std::vector<fs::path>{units.begin(), units.end()};
+  if (config.binary_type() == BinaryType::Exe) {
+    all_units.push_back(config.dir_project() / main_file_name);
+  }
+
+  const auto stage = config.profile_guided()
+                         ? record_profile(config, references, all_units, options)
+                         : StageFlags{};
+  build_stage(config, references, all_units, options, stage);
+}
@@ -0,0 +1,27 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "generator.hpp"
+
+/**
+ * Path of the binary a project builds, libraries follow the lib<name> convention
+ */
+auto native_binary_path(const ProjectConfig& config) -> fs::path;
+
+/**
+ * Compiles the translation units with the C++ compiler and links them into the project binary
+ *
+ * Units are compiled on at most jobs processes at a time. A unit is up to date when it was
+ * compiled with the same command and its object is newer than every file of its depfile. Objects
+ * of stale units are restored from the object cache when it is enabled.
+ */
+auto build_native(const ProjectConfig& config,
+                  std::span<const ProjectConfig* const> references,
+                  std::span<const fs::path> units,
+                  const BuildOptions& options) -> void;
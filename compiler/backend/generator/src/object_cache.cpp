@@ -0,0 +1,96 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "object_cache.hpp"
+
+#include <random>
+
+constexpr auto entry_file_ext = std::string_view{".o"};
+constexpr auto temp_file_ext  = std::string_view{".tmp"};
+
+// Entries are spread over directories named by the first two digits of their key.
+auto ObjectCache::entry_path(ContentHash key) const -> fs::path {
+  const auto hex = to_hex(key);
+  return dir_ / hex.substr(0, 2) / (hex + std::string{entry_file_ext});
+}
+
+auto ObjectCache::restore(ContentHash key, const fs::path& object) -> bool {
+  const auto entry = entry_path(key);
+
+  auto error       = std::error_code{};
+  fs::copy_file(entry, object, fs::copy_options::overwrite_existing, error);
+  if (error) {
+    ++misses_;
+    return false;
+  }
+
+  // The entry was used, so it is the last one to go. The object is written now, so it is newer
+  // than its prerequisites.
+  fs::last_write_time(entry, fs::file_time_type::clock::now(), error);
+  ++hits_;
+  return true;
+}
+
+// Builds sharing the cache may store the same key at once, each writes its own temporary file and
+// the rename decides.
+auto ObjectCache::store(ContentHash key, const fs::path& object) -> void {
+  const auto entry = entry_path(key);
+  auto error       = std::error_code{};
+  fs::create_directories(entry.parent_path(), error);
+
+  auto random      = std::random_device{};
+  const auto nonce = to_hex((ContentHash{random()} << 32) | random());
+  const auto temp  = fs::path{entry} += '.' + nonce + std::string{temp_file_ext};
+
+  fs::copy_file(object, temp, fs::copy_options::overwrite_existing, error);
+  if (!error) {
+    fs::rename(temp, entry, error);
+  }
+  if (error) {
+    fs::remove(temp, error);
+    return;
+  }
+  ++stored_;
+}
+
+auto ObjectCache::trim() -> void {
+  struct Entry final {
+    fs::path path;
+    uint64_t size;
+    fs::file_time_type used;
+  };
+
+  auto entries = std::vector<Entry>{};
+  auto total   = uint64_t{0};
+  auto error   = std::error_code{};
+  for (auto it = fs::recursive_directory_iterator{dir_, error};
+       !error && it != fs::recursive_directory_iterator{}; it.increment(error)) {
+    // Entries may disappear while another build trims, they are skipped.
+    auto entry_error = std::error_code{};
+    if (!it->is_regular_file(entry_error) || it->path().extension() != entry_file_ext) {
+      continue;
+    }
+    const auto size = it->file_size(entry_error);
+    const auto used = it->last_write_time(entry_error);
+    if (!entry_error) {
+      entries.push_back({it->path(), size, used});
+      total += size;
+    }
+  }
+
+  if (total <= max_size_) {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](auto& lhs, auto& rhs) { return lhs.used < rhs.used; });
+  for (auto& entry : entries) {
+    if (total <= max_size_) {
+      break;
+    }
+    if (fs::remove(entry.path, error)) {
+      total -= entry.size;
+      ++evicted_;
+    }
+  }
+}
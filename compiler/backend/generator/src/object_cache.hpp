@@ -0,0 +1,56 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "hash.hpp"
+
+/**
+ * ObjectCache
+ * \brief Content addressed store of object files shared by every project and build directory
+ *
+ * Objects are keyed by the preprocessed translation unit, the compiler identity and the flags.
+ * Every hit refreshes the mtime of its entry, trimming removes the least recently used entries
+ * until the cache fits its size.
+ */
+class ObjectCache final {
+  fs::path dir_;
+  uint64_t max_size_;
+
+  uint64_t hits_    = 0;
+  uint64_t misses_  = 0;
+  uint64_t stored_  = 0;
+  uint64_t evicted_ = 0;
+
+ public:
+  explicit ObjectCache(fs::path dir, uint64_t max_size)
+      : dir_{std::move(dir)},
+        max_size_{max_size} {}
+
+  NODISCARD auto hits() const { return hits_; }
+  NODISCARD auto misses() const { return misses_; }
+  NODISCARD auto stored() const { return stored_; }
+  NODISCARD auto evicted() const { return evicted_; }
+
+  /**
+   * Copies the object cached under key to object, false on a miss
+   */
+  auto restore(ContentHash key, const fs::path& object) -> bool;
+
+  /**
+   * Adds object under key, an entry appears only once it is completely written
+   */
+  auto store(ContentHash key, const fs::path& object) -> void;
+
+  /**
+   * Removes the least recently used entries until the cache fits its size
+   */
+  auto trim() -> void;
+
+ private:
+  NODISCARD auto entry_path(ContentHash key) const -> fs::path;
+};
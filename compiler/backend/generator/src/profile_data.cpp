@@ -0,0 +1,69 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "profile_data.hpp"
+
+#include <sstream>
+
+#include "process.hpp"
+#include "profiler.hpp"
+
+constexpr auto profile_dir_name = std::string_view{"profile"};
+constexpr auto stamp_file_name  = std::string_view{"typhon.profile"};
+constexpr auto main_file_name   = std::string_view{"__main.cpp"};
+
+// Files are hashed by their path below the project, the key does not depend on where it lives.
+auto hash_file(const fs::path& project_dir, const fs::path& file, ContentHash hash) -> ContentHash {
+  auto stream  = std::ifstream{project_dir / file, std::ios::binary};
+  auto content = std::ostringstream{};
+  content << stream.rdbuf();
+
+  hash = hash_content(file.generic_string(), hash);
+  return hash_content(content.view(), hash);
+}
+
+ProfileData::ProfileData(const ProjectConfig& config, ContentHash seed) {
+  auto files = std::vector<fs::path>{};
+  for (auto& entry : fs::recursive_directory_iterator(config.dir_gen_source())) {
+    if (entry.is_regular_file()) {
+      files.push_back(fs::relative(entry.path(), config.dir_project()));
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  auto hash = seed;
+  for (auto& file : files) {
+    hash = hash_file(config.dir_project(), file, hash);
+  }
+  hash = hash_file(config.dir_project(), main_file_name, hash);
+  for (auto& argument : config.training_command()) {
+    hash = hash_content(argument, hash);
+    hash = hash_content({"\0", 1}, hash);
+  }
+
+  dir_ = config.dir_build() / profile_dir_name / to_hex(hash);
+}
+
+auto ProfileData::is_complete() const -> bool { return fs::exists(dir_ / stamp_file_name); }
+
+auto ProfileData::reset() const -> void {
+  fs::remove_all(dir_.parent_path());
+  fs::create_directories(dir_);
+}
+
+auto ProfileData::train(const ProjectConfig& config) const -> void {
+  const auto command = ProcessCommand{config.training_command()};
+  std::cout << "[Typhon] Training Command : " << to_command_line(command) << std::endl;
+  const auto result = [&] {
+    PROFILE_SCOPE("Training", config.name());
+    return run_process(command);
+  }();
+  std::cout << result.output << std::flush;
+
+  if (result.exit_code != 0) {
+    std::cerr << "Error : training failed with exit code " << result.exit_code << '.' << std::endl;
+    exit(-1);
+  }
+}
+
+auto ProfileData::complete() const -> void { auto stamp = std::ofstream{dir_ / stamp_file_name}; }
@@ -0,0 +1,42 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "hash.hpp"
+#include "project_config.hpp"
+
+/**
+ * ProfileData
+ * \brief Training profile of a profile guided build, recorded below the build directory
+ *
+ * A profile is keyed by the generated sources, the entry point and the training command, seeded
+ * with whatever identifies the toolchain recording it. The directory of a profile is only used
+ * once its training completed, a new training removes the profiles of every other key.
+ */
+class ProfileData final {
+  fs::path dir_;
+
+ public:
+  explicit ProfileData(const ProjectConfig& config, ContentHash seed);
+
+  NODISCARD auto& dir() const { return dir_; }
+
+  NODISCARD auto is_complete() const -> bool;
+
+  /**
+   * Removes every recorded profile and creates the empty directory of this one
+   */
+  auto reset() const -> void;
+
+  /**
+   * Runs the training command of the project against its instrumented binary
+   */
+  auto train(const ProjectConfig& config) const -> void;
+
+  auto complete() const -> void;
+};
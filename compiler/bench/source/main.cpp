@@ -0,0 +1,273 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include <charconv>
+#include <iomanip>
+
+#include "driver.hpp"
+#include "json/writer.hpp"
+#include "timer.hpp"
+
+#include "synthetic_project.hpp"
+#include "symbol_file_bench.hpp"
+#include "output_bench.hpp"
+
+struct BenchOptions final {
+  std::vector<uint32_t> file_counts   = {16, 64, 256, 1024};
+  std::vector<uint32_t> thread_counts = {1, 2, 4, 8};
+  SyntheticProjectShape shape;
+  uint32_t repeat  = 3;
+  uint32_t symbols = 0;
+  uint32_t emit    = 0;
+  fs::path dir     = fs::absolute("bench_projects");
+  fs::path json_path;
+};
+
+struct BenchResult final {
+  uint32_t files   = 0;
+  uint32_t threads = 0;
+  PhaseTimes times;
+  double total_seconds = 0;
+};
+
+/* Options */
+
+auto parse_count(std::string_view name, std::string_view value) -> uint32_t {
+  auto count        = uint32_t{0};
+  auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), count);
+  if (value.empty() || error != std::errc{} || end != value.data() + value.size()) {
+    std::cerr << "Error : \"" << name << "\" expects a number, got \"" << value << '"' << std::endl;
+    exit(-1);
+  }
+  return count;
+}
+
+auto parse_counts(std::string_view name, std::string_view value) -> std::vector<uint32_t> {
+  auto counts = std::vector<uint32_t>{};
+  while (true) {
+    const auto split = value.find(',');
+    counts.push_back(parse_count(name, value.substr(0, split)));
+    if (split == std::string_view::npos) {
+      return counts;
+    }
+    value.remove_prefix(split + 1);
+  }
+}
+
+using option_handler = void (*)(BenchOptions& options, std::string_view value);
+
+auto files_handler(BenchOptions& options, const std::string_view value) -> void {
+  options.file_counts = parse_counts("--files", value);
+}
+
+auto threads_handler(BenchOptions& options, const std::string_view value) -> void {
+  options.thread_counts = parse_counts("--threads", value);
+}
+
+auto depth_handler(BenchOptions& options, const std::string_view value) -> void {
+  options.shape.depth = parse_count("--depth", value);
+}
+
+auto functions_handler(BenchOptions& options, const std::string_view value) -> void {
+  options.shape.functions = parse_count("--functions", value);
+}
+
+auto complexity_handler(BenchOptions& options, const std::string_view value) -> void {
+  options.shape.complexity = parse_count("--complexity", value);
+}
+
+auto repeat_handler(BenchOptions& options, const std::string_view value) -> void {
+  options.repeat = std::max(parse_count("--repeat", value), 1u);
+}
+
+auto symbols_handler(BenchOptions& options, const std::string_view value) -> void {
+  options.symbols = parse_count("--symbols", value);
+}
+
+auto emit_handler(BenchOptions& options, const std::string_view value) -> void {
+  options.emit = parse_count("--emit", value);
+}
+
+auto dir_handler(BenchOptions& options, const std::string_view value) -> void {
+  options.dir = fs::absolute(value);
+}
+
+auto json_handler(BenchOptions& options, const std::string_view value) -> void {
+  options.json_path = fs::absolute(value);
+}
+
+const auto option_handlers = std::unordered_map<std::string_view, option_handler>{
+    {"--files",      files_handler     },
+    {"--threads",    threads_handler   },
+    {"--depth",      depth_handler     },
+    {"--functions",  functions_handler },
+    {"--complexity", complexity_handler},
+    {"--repeat",     repeat_handler    },
+    {"--symbols",    symbols_handler   },
+    {"--emit",       emit_handler      },
+    {"--dir",        dir_handler       },
+    {"--json",       json_handler      },
+};
+
+auto parse_options(int argc, const char* argv[]) -> BenchOptions {
+  auto options = BenchOptions{};
+
+  for (auto i = 1; i < argc; ++i) {
+    const auto arg   = std::string_view{argv[i]};
+    const auto split = arg.find('=');
+    const auto name  = arg.substr(0, split);
+    const auto value = split == std::string_view::npos ? std::string_view{} : arg.substr(split + 1);
+
+    if (auto it = option_handlers.find(name); it != option_handlers.end()) {
+      auto handler = it->second;
+      handler(options, value);
+    } else {
+      std::cerr << "Error : Unknown option \"" << arg << '"' << std::endl;
+      exit(-1);
+    }
+  }
+
+  return options;
+}
+
+/* Measurement */
+
+// Runs the frontend and generator once, the native build is skipped so only tyc is measured.
+auto run_once(uint32_t threads) -> BenchResult {
+  auto compiler = Compiler{CompilerOptions{.jobs = threads}};
+  fs::remove_all(compiler.config().dir_build());
+
+  const auto watch  = Stopwatch{};
+  auto project_tree = compiler.run_frontend();
+  compiler.run_backend(project_tree);
+
+  return BenchResult{.threads = threads, .times = compiler.times(), .total_seconds = watch.elapsed()};
+}
+
+// Keeps the fastest repetition, the minimum is the least noisy estimate on a shared machine.
+auto run_best(uint32_t files, uint32_t threads, uint32_t repeat) -> BenchResult {
+  auto best = run_once(threads);
+  for (auto i = uint32_t{1}; i < repeat; ++i) {
+    auto result = run_once(threads);
+    if (result.total_seconds < best.total_seconds) {
+      best = result;
+    }
+  }
+  best.files = files;
+  return best;
+}
+
+/* Reporting */
+
+auto print_header() {
+  std::cout << std::setw(8) << "files" << std::setw(9) << "threads" << std::setw(11) << "parse"
+            << std::setw(11) << "place" << std::setw(11) << "generate" << std::setw(11) << "total"
+            << std::setw(10) << "speedup" << std::setw(12) << "files/s" << newline;
+}
+
+auto print_result(const BenchResult& result, double baseline_seconds) {
+  const auto& times = result.times;
+  std::cout << std::fixed << std::setprecision(4) << std::setw(8) << result.files << std::setw(9)
+            << result.threads << std::setw(11) << times.parse_seconds << std::setw(11)
+            << times.check_seconds << std::setw(11) << times.backend_seconds << std::setw(11)
+            << result.total_seconds << std::setprecision(2) << std::setw(9)
+            << baseline_seconds / result.total_seconds << 'x' << std::setprecision(0)
+            << std::setw(12) << result.files / result.total_seconds << std::endl;
+}
+
+auto write_json(const fs::path& path, const BenchOptions& options,
+                const std::vector<BenchResult>& results) {
+  auto stream = std::ofstream{path};
+  auto writer = json::Writer{stream};
+
+  writer.begin_object();
+  writer.key("shape").begin_object();
+  writer.field("depth", uint64_t{options.shape.depth});
+  writer.field("functions", uint64_t{options.shape.functions});
+  writer.field("complexity", uint64_t{options.shape.complexity});
+  writer.end_object();
+
+  writer.key("results").begin_array();
+  for (auto& result : results) {
+    writer.begin_object();
+    writer.field("files", uint64_t{result.files});
+    writer.field("threads", uint64_t{result.threads});
+    writer.field("parse_seconds", result.times.parse_seconds);
+    writer.field("place_seconds", result.times.check_seconds);
+    writer.field("generate_seconds", result.times.backend_seconds);
+    writer.field("total_seconds", result.total_seconds);
+    writer.end_object();
+  }
+  writer.end_array();
+
+  writer.end_object();
+  stream << newline;
+}
+
+auto print_symbol_file_result(const SymbolFileBenchResult& result) {
+  std::cout << std::setw(10) << "symbols" << std::setw(12) << "namespaces" << std::setw(12)
+            << "bytes" << std::setw(12) << "write ms" << std::setw(12) << "open us" << std::setw(12)
+            << "lookup ns" << newline;
+  std::cout << std::fixed << std::setw(10) << result.symbols << std::setw(12) << result.namespaces
+            << std::setw(12) << result.bytes << std::setprecision(3) << std::setw(12)
+            << result.write_seconds * 1e3 << std::setw(12) << result.open_seconds * 1e6
+            << std::setprecision(1) << std::setw(12) << result.lookup_seconds * 1e9 << std::endl;
+}
+
+auto print_output_result(const OutputBenchResult& result) {
+  const auto megabytes = static_cast<double>(result.bytes) / (1 << 20);
+  std::cout << std::setw(10) << "megabytes" << std::setw(14) << "stream MB/s" << std::setw(14)
+            << "buffer MB/s" << std::setw(10) << "speedup" << newline;
+  std::cout << std::fixed << std::setprecision(1) << std::setw(10) << megabytes << std::setw(14)
+            << megabytes / result.stream_seconds << std::setw(14)
+            << megabytes / result.buffer_seconds << std::setprecision(2) << std::setw(9)
+            << result.stream_seconds / result.buffer_seconds << 'x' << std::endl;
+}
+
+auto main(int argc, const char* argv[]) -> int {
+  std::ios_base::sync_with_stdio(false);
+
+  const auto options = parse_options(argc, argv);
+
+  // The symbol table and output benchmarks replace the frontend sweep.
+  if (options.symbols > 0) {
+    print_symbol_file_result(run_symbol_file_bench(options.dir, options.symbols));
+    return 0;
+  }
+  if (options.emit > 0) {
+    print_output_result(run_output_bench(options.emit, options.repeat));
+    return 0;
+  }
+  const auto cwd     = fs::current_path();
+  auto results       = std::vector<BenchResult>{};
+
+  print_header();
+  for (auto files : options.file_counts) {
+    auto shape  = options.shape;
+    shape.files = files;
+
+    const auto project_dir = options.dir / ("files_" + std::to_string(files));
+    write_synthetic_project(project_dir, shape);
+
+    // Project paths resolve against the working directory, like a tyc invocation.
+    fs::current_path(project_dir);
+
+    // Speedup is relative to the first thread count of the sweep.
+    auto baseline_seconds = 0.0;
+    for (auto threads : options.thread_counts) {
+      auto& result = results.emplace_back(run_best(files, threads, options.repeat));
+      if (baseline_seconds == 0) {
+        baseline_seconds = result.total_seconds;
+      }
+      print_result(result, baseline_seconds);
+    }
+
+    fs::current_path(cwd);
+  }
+
+  if (!options.json_path.empty()) {
+    write_json(options.json_path, options, results);
+  }
+
+  return 0;
+}
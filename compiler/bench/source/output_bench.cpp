@@ -0,0 +1,63 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "output_bench.hpp"
+
+#include <sstream>
+
+#include "output_buffer.hpp"
+#include "timer.hpp"
+
+constexpr auto bench_file_size = size_t{64} << 10;
+constexpr auto prefix          = std::string_view{"__ty_"};
+
+// One function of the shape generate_source_file writes, through either writer.
+template <typename Writer>
+auto write_function(Writer& writer, uint32_t index) -> void {
+  writer << "auto " << prefix << "function_" << index << '(' << prefix << "i32 " << prefix
+         << "lhs, " << prefix << "i32 " << prefix << "rhs) -> " << prefix << "i32 {" << newline;
+  for (auto i = uint32_t{0}; i < 4; ++i) {
+    writer << "auto " << prefix << "local_" << i << " = " << prefix << "lhs * " << index + i
+           << " + " << prefix << "rhs;" << newline;
+  }
+  writer << "return " << prefix << "local_0;" << newline << '}' << newline << newline;
+}
+
+template <typename Writer, typename Reset, typename Size>
+auto emit(Writer& writer, size_t bytes, Reset reset, Size size) -> double {
+  const auto watch = Stopwatch{};
+  auto index       = uint32_t{0};
+  auto written     = size_t{0};
+  while (written < bytes) {
+    reset(writer);
+    while (size(writer) < bench_file_size) {
+      write_function(writer, index++);
+    }
+    written += size(writer);
+  }
+  return watch.elapsed();
+}
+
+auto run_output_bench(uint32_t megabytes, uint32_t repeat) -> OutputBenchResult {
+  auto result  = OutputBenchResult{};
+  result.bytes = size_t{megabytes} << 20;
+
+  auto stream  = std::ostringstream{};
+  auto buffer  = OutputBuffer{};
+  for (auto i = uint32_t{0}; i < std::max(repeat, 1u); ++i) {
+    const auto stream_seconds = emit(
+        stream, result.bytes, [](auto& writer) { writer = std::ostringstream{}; },
+        [](auto& writer) { return writer.view().size(); });
+    const auto buffer_seconds = emit(
+        buffer, result.bytes, [](auto& writer) { writer.clear(); },
+        [](auto& writer) { return writer.size(); });
+
+    if (i == 0 || stream_seconds < result.stream_seconds) {
+      result.stream_seconds = stream_seconds;
+    }
+    if (i == 0 || buffer_seconds < result.buffer_seconds) {
+      result.buffer_seconds = buffer_seconds;
+    }
+  }
+  return result;
+}
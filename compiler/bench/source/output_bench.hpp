@@ -0,0 +1,27 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "common.hpp"
+
+struct OutputBenchResult final {
+  size_t bytes          = 0;
+  double stream_seconds = 0;
+  double buffer_seconds = 0;
+};
+
+/**
+ * run_output_bench
+ * \brief Emits the same generated function text through a string stream and an output buffer
+ *
+ * Text is written in the pattern of the generator, short tokens, identifiers, numbers and newline
+ * manipulators, in files of the size of a generated source until it reaches megabytes. The stream
+ * is created for every file as the generator used to, the buffer is cleared and reused. The
+ * fastest of repeat runs is kept.
+ */
+auto run_output_bench(uint32_t megabytes, uint32_t repeat) -> OutputBenchResult;
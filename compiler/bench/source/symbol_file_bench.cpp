@@ -0,0 +1,68 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "symbol_file_bench.hpp"
+
+#include "symbol_file.hpp"
+#include "timer.hpp"
+
+constexpr auto symbols_per_namespace = uint32_t{64};
+
+auto bench_namespace_name(uint32_t index) -> std::string {
+  return "Core::Module" + std::to_string(index / 16) + "::Part" + std::to_string(index);
+}
+
+auto bench_symbol_name(uint32_t index) -> std::string { return "symbol_" + std::to_string(index); }
+
+auto run_symbol_file_bench(const fs::path& dir, uint32_t symbols) -> SymbolFileBenchResult {
+  auto result       = SymbolFileBenchResult{};
+  result.symbols    = symbols;
+  result.namespaces = (symbols + symbols_per_namespace - 1) / symbols_per_namespace;
+
+  const auto write_watch = Stopwatch{};
+  auto writer            = SymbolFileWriter{"Bench.Core"};
+  for (auto ns = uint32_t{0}; ns < result.namespaces; ++ns) {
+    const auto index = writer.add_namespace(bench_namespace_name(ns));
+    const auto first = ns * symbols_per_namespace;
+    for (auto i = first; i < std::min(first + symbols_per_namespace, symbols); ++i) {
+      writer.add_symbol(index, 0, 0, false, bench_symbol_name(i), "(i32,i32)->i32");
+    }
+  }
+
+  const auto content = writer.serialize();
+  const auto path    = dir / "Bench.Core.tysym";
+  fs::create_directories(dir);
+  auto stream = std::ofstream{path, std::ios::binary};
+  stream.write(content.data(), static_cast<std::streamsize>(content.size()));
+  stream.close();
+  result.write_seconds = write_watch.elapsed();
+  result.bytes         = content.size();
+
+  const auto open_watch = Stopwatch{};
+  auto file             = SymbolFile::open(path);
+  result.open_seconds   = open_watch.elapsed();
+  if (!file) {
+    std::cerr << "Error : failed to open " << path << std::endl;
+    exit(-1);
+  }
+
+  // Names are built up front so the loop only measures resolution.
+  auto queries = std::vector<std::pair<std::string, std::string>>{};
+  queries.reserve(symbols);
+  for (auto i = uint32_t{0}; i < symbols; ++i) {
+    queries.emplace_back(bench_namespace_name(i / symbols_per_namespace), bench_symbol_name(i));
+  }
+
+  auto found              = size_t{0};
+  const auto lookup_watch = Stopwatch{};
+  for (auto& [ns, name] : queries) {
+    found += file->find_symbol(ns, name) != nullptr ? 1 : 0;
+  }
+  result.lookup_seconds = symbols == 0 ? 0 : lookup_watch.elapsed() / symbols;
+
+  if (found != symbols) {
+    std::cerr << "Error : resolved " << found << " of " << symbols << " symbols" << std::endl;
+    exit(-1);
+  }
+  return result;
+}
@@ -0,0 +1,28 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "common.hpp"
+
+struct SymbolFileBenchResult final {
+  uint32_t namespaces   = 0;
+  uint32_t symbols      = 0;
+  size_t bytes          = 0;
+  double write_seconds  = 0;
+  double open_seconds   = 0;
+  double lookup_seconds = 0;
+};
+
+/**
+ * run_symbol_file_bench
+ * \brief Writes a library sized public symbol table, then times mapping it and resolving symbols
+ *
+ * Open time covers mapping and header validation only, lookup time is the mean of resolving every
+ * symbol by namespace and name against the mapped file.
+ */
+auto run_symbol_file_bench(const fs::path& dir, uint32_t symbols) -> SymbolFileBenchResult;
@@ -0,0 +1,101 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "synthetic_project.hpp"
+
+constexpr auto project_name     = std::string_view{"Typhon.Bench"};
+constexpr auto namespace_fanout = uint32_t{4};
+
+constexpr auto binary_operators = std::array<std::string_view, 3>{"+", "-", "*"};
+
+auto write_project_file(const fs::path& dir) {
+  auto stream = std::ofstream{dir / "bench.typroj"};
+  stream << R"(<?xml version="1.0" encoding="UTF-8" ?>)" << newline;
+  stream << R"(<Project xmlns="Typhon.Project">)" << newline;
+  stream << "    <ProjectName>" << project_name << "</ProjectName>" << newline;
+  stream << "    <BinaryType>Lib</BinaryType>" << newline;
+  stream << "    <SourceDir>src</SourceDir>" << newline;
+  stream << "    <BuildDir>obj</BuildDir>" << newline;
+  stream << "    <BinaryDir>bin</BinaryDir>" << newline;
+  stream << "    <LinkStd>false</LinkStd>" << newline;
+  stream << "</Project>" << newline;
+}
+
+auto write_ctype_file(const fs::path& dir) {
+  auto stream = std::ofstream{dir / "ctype.ty"};
+  stream << R"(__c_include "cstdint";)" << newline;
+  stream << R"(__c_type i32 : "int32_t";)" << newline;
+}
+
+auto function_name(uint32_t file, uint32_t function) -> std::string {
+  return "f" + std::to_string(file) + "_" + std::to_string(function);
+}
+
+auto write_operand(std::ostream& stream, uint32_t file, uint32_t function, uint32_t index) {
+  switch (index % 4) {
+    case 0:
+      stream << 'a';
+      break;
+    case 1:
+      stream << 'b';
+      break;
+    case 2:
+      stream << index + 1;
+      break;
+    default:
+      if (function > 0) {
+        stream << function_name(file, function - 1) << "(a, b)";
+      } else {
+        stream << 'a';
+      }
+  }
+}
+
+auto write_expression(std::ostream& stream, uint32_t file, uint32_t function, uint32_t complexity) {
+  write_operand(stream, file, function, 0);
+  for (auto i = uint32_t{1}; i <= complexity; ++i) {
+    stream << ' ' << binary_operators[i % binary_operators.size()] << ' ';
+    write_operand(stream, file, function, i);
+  }
+}
+
+auto write_namespace(std::ostream& stream, uint32_t file, uint32_t depth) {
+  if (depth == 0) {
+    return;
+  }
+
+  stream << "namespace Bench";
+  auto index = file;
+  for (auto level = uint32_t{1}; level < depth; ++level) {
+    stream << "::N" << index % namespace_fanout;
+    index /= namespace_fanout;
+  }
+  stream << ';' << newline << newline;
+}
+
+auto write_source_file(const fs::path& dir, uint32_t file, const SyntheticProjectShape& shape) {
+  auto stream = std::ofstream{dir / ("file" + std::to_string(file) + ".ty")};
+  write_namespace(stream, file, shape.depth);
+
+  for (auto function = uint32_t{0}; function < shape.functions; ++function) {
+    stream << "func " << function_name(file, function) << "(a : i32, b : i32) -> i32 {" << newline;
+    stream << "\tvar result = ";
+    write_expression(stream, file, function, shape.complexity);
+    stream << ';' << newline;
+    stream << "\treturn result;" << newline;
+    stream << '}' << newline << newline;
+  }
+}
+
+auto write_synthetic_project(const fs::path& dir, const SyntheticProjectShape& shape) -> void {
+  const auto source_dir = dir / "src";
+  fs::remove_all(dir);
+  fs::create_directories(source_dir);
+
+  write_project_file(dir);
+  write_ctype_file(source_dir);
+
+  for (auto file = uint32_t{0}; file < shape.files; ++file) {
+    write_source_file(source_dir, file, shape);
+  }
+}
@@ -0,0 +1,26 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "common.hpp"
+
+struct SyntheticProjectShape final {
+  uint32_t files      = 64;
+  uint32_t depth      = 2;
+  uint32_t functions  = 8;
+  uint32_t complexity = 4;
+};
+
+/**
+ * write_synthetic_project
+ * \brief Writes a typroj and a source tree of generated functions into dir
+ *
+ * Files are spread over a namespace tree of the requested depth, each function body holds a
+ * single expression with complexity binary operators that also calls the previous function.
+ */
+auto write_synthetic_project(const fs::path& dir, const SyntheticProjectShape& shape) -> void;
@@ -0,0 +1,63 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <optional>
+
+#include "common.hpp"
+
+using ContentHash = uint64_t;
+
+constexpr auto fnv_offset_basis = ContentHash{14695981039346656037ull};
+constexpr auto fnv_prime        = ContentHash{1099511628211ull};
+
+/**
+ * hash_content
+ * \brief 64 bit FNV-1a, used to detect content changes not as a cryptographic digest
+ */
+constexpr auto hash_content(std::string_view data, ContentHash seed = fnv_offset_basis)
+    -> ContentHash {
+  auto hash = seed;
+  for (auto c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= fnv_prime;
+  }
+  return hash;
+}
+
+constexpr auto hash_hex_length = size_t{16};
+
+inline auto to_hex(ContentHash hash) -> std::string {
+  constexpr auto digits = std::string_view{"0123456789abcdef"};
+
+  auto hex              = std::string(hash_hex_length, '0');
+  for (auto i = hash_hex_length; i > 0; --i) {
+    hex[i - 1] = digits[hash & 0xf];
+    hash >>= 4;
+  }
+  return hex;
+}
+
+inline auto from_hex(std::string_view hex) -> std::optional<ContentHash> {
+  if (hex.size() != hash_hex_length) {
+    return std::nullopt;
+  }
+
+  auto hash = ContentHash{0};
+  for (auto c : hex) {
+    hash <<= 4;
+    if (c >= '0' && c <= '9') {
+      hash |= static_cast<ContentHash>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      hash |= static_cast<ContentHash>(c - 'a' + 10);
+    } else {
+      return std::nullopt;
+    }
+  }
+  return hash;
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "common.hpp"
+
+namespace json {
+
+/**
+ * Writer
+ * \brief Minimal streaming json writer, tracks separators so callers only emit structure
+ */
+class Writer final {
+  std::ostream& writer_;
+  std::vector<bool> first_;
+  bool key_pending_ = false;
+
+  auto write_separator() -> void;
+  auto write_string(std::string_view value) -> void;
+
+ public:
+  explicit Writer(std::ostream& writer)
+      : writer_{writer} {}
+
+  auto begin_object() -> Writer&;
+  auto end_object() -> Writer&;
+  auto begin_array() -> Writer&;
+  auto end_array() -> Writer&;
+
+  auto key(std::string_view name) -> Writer&;
+
+  auto value(std::string_view value) -> Writer&;
+  auto value(const char* value) -> Writer& { return this->value(std::string_view{value}); }
+  auto value(bool value) -> Writer&;
+  auto value(uint64_t value) -> Writer&;
+  auto value(int64_t value) -> Writer&;
+  auto value(double value) -> Writer&;
+
+  template <typename T>
+  auto field(std::string_view name, const T& value) -> Writer& {
+    return key(name).value(value);
+  }
+};
+
+}  // namespace json
@@ -0,0 +1,46 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "common.hpp"
+
+/**
+ * MappedFile
+ * \brief Read only memory mapping of a whole file, pages are loaded on first access
+ */
+class MappedFile final {
+  const std::byte* data_ = nullptr;
+  size_t size_           = 0;
+
+#ifdef _WIN32
+  void* file_    = nullptr;
+  void* mapping_ = nullptr;
+#else
+  int file_ = -1;
+#endif
+
+ public:
+  MappedFile() = default;
+  MappedFile(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+  auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+  MappedFile(const MappedFile&)                    = delete;
+  auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+  NODISCARD auto data() const { return data_; }
+  NODISCARD auto size() const { return size_; }
+  NODISCARD auto is_open() const { return data_ != nullptr; }
+
+  /**
+   * Maps path, returns false when the file is missing or empty
+   */
+  auto open(const fs::path& path) -> bool;
+  auto close() -> void;
+};
@@ -0,0 +1,112 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <array>
+#include <charconv>
+#include <concepts>
+
+#include "common.hpp"
+
+/**
+ * OutputBuffer
+ * \brief Append only text buffer a generated file is written into before it is stored at once
+ *
+ * Appends go straight into one string, without the sentry, locale and virtual calls a stream pays
+ * for every insertion. Clearing keeps the capacity, so a buffer reused for every file stops
+ * allocating once it has grown to the largest one.
+ *
+ * Indentation is tracked as a level and written before the first append of a line, blank lines
+ * stay empty. A compact buffer tracks the level but writes no indentation.
+ */
+class OutputBuffer final {
+  std::string data_;
+  uint32_t level_  = 0;
+  bool line_start_ = true;
+  bool indented_   = true;
+
+ public:
+  OutputBuffer() = default;
+  explicit OutputBuffer(bool indented)
+      : indented_{indented} {}
+
+  NODISCARD auto view() const -> std::string_view { return data_; }
+  NODISCARD auto size() const { return data_.size(); }
+  NODISCARD auto empty() const { return data_.empty(); }
+  NODISCARD auto level() const { return level_; }
+
+  auto append(std::string_view text) -> OutputBuffer& {
+    start_line();
+    data_.append(text);
+    return *this;
+  }
+
+  auto append(char c) -> OutputBuffer& {
+    start_line();
+    data_.push_back(c);
+    return *this;
+  }
+
+  template <std::integral T>
+    requires(!std::same_as<T, char> && !std::same_as<T, bool>)
+  auto append(T value) -> OutputBuffer& {
+    auto digits       = std::array<char, 24>{};
+    auto [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    return append(std::string_view{digits.data(), end});
+  }
+
+  auto newline() -> OutputBuffer& {
+    data_.push_back('\n');
+    line_start_ = true;
+    return *this;
+  }
+
+  auto indent() -> void { ++level_; }
+  auto dedent() -> void { --level_; }
+
+  /**
+   * Drops everything appended after size, used to take back a wrapper that stayed empty
+   */
+  auto truncate(size_t size) -> void {
+    data_.resize(size);
+    line_start_ = data_.empty() || data_.back() == '\n';
+  }
+
+  auto clear() -> void {
+    data_.clear();
+    level_      = 0;
+    line_start_ = true;
+  }
+
+  auto operator<<(std::string_view text) -> OutputBuffer& { return append(text); }
+  auto operator<<(char c) -> OutputBuffer& { return append(c); }
+
+  template <std::integral T>
+    requires(!std::same_as<T, char> && !std::same_as<T, bool>)
+  auto operator<<(T value) -> OutputBuffer& {
+    return append(value);
+  }
+
+  auto operator<<(OutputBuffer& (*manipulator)(OutputBuffer&)) -> OutputBuffer& {
+    return manipulator(*this);
+  }
+
+ private:
+  auto start_line() -> void {
+    if (line_start_) {
+      line_start_ = false;
+      if (indented_) {
+        data_.append(level_, '\t');
+      }
+    }
+  }
+};
+
+inline OutputBuffer& newline(OutputBuffer& out) {
+  return out.newline();
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include "common.hpp"
+
+/**
+ * Number of workers for a pass over item_count items, zero jobs selects the hardware concurrency
+ */
+inline auto worker_count(uint32_t jobs, size_t item_count) -> size_t {
+  auto count = static_cast<size_t>(jobs);
+  if (count == 0) {
+    count = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  return std::max(std::min(count, item_count), size_t{1});
+}
+
+/**
+ * Invokes fn(worker, item) for every item on a fixed set of workers pulling from a shared index
+ *
+ * Worker indices are dense, so callers can keep one buffer per worker and merge them afterwards
+ * instead of synchronizing. Trace builds run sequentially to keep their output ordered.
+ */
+template <typename Fn>
+auto parallel_for(size_t item_count, uint32_t jobs, const Fn& fn) -> void {
+#ifdef TRACE
+  for (auto i = size_t{0}; i < item_count; ++i) {
+    fn(size_t{0}, i);
+  }
+#else
+  auto next_item = std::atomic_size_t{0};
+  auto worker    = [&](size_t index) {
+    for (auto i = next_item++; i < item_count; i = next_item++) {
+      fn(index, i);
+    }
+  };
+
+  const auto count = worker_count(jobs, item_count);
+  auto workers     = std::vector<std::future<void>>{};
+  workers.reserve(count);
+  for (auto index = size_t{0}; index < count; ++index) {
+    workers.push_back(std::async(std::launch::async, worker, index));
+  }
+
+  for (auto& future : workers) {
+    future.get();
+  }
+#endif
+}
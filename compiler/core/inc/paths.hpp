@@ -9,12 +9,16 @@
 
 #include "common.hpp"
 
-constexpr auto source_file_ext  = std::string_view{".ty"};
-constexpr auto project_file_ext = std::string_view{".typroj"};
-//constexpr auto solution_file_ext = std::string_view{".tysln"};
+constexpr auto source_file_ext   = std::string_view{".ty"};
+constexpr auto project_file_ext  = std::string_view{".typroj"};
+constexpr auto solution_file_ext = std::string_view{".tysln"};
 
 constexpr auto gen_src_file_ext = std::string_view{".cpp"};
 constexpr auto gen_hdr_file_ext = std::string_view{".hpp"};
+constexpr auto gen_ir_file_ext  = std::string_view{".ll"};
+constexpr auto symbol_file_ext  = std::string_view{".tysym"};
+
+auto read_all(const fs::path& path) -> std::string;
 
 // constexpr auto src_dir_name     = std::string_view{"src"};
 // const auto src_dir_path         = fs::proximate(src_dir_name);
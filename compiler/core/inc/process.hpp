@@ -0,0 +1,49 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <functional>
+
+#include "common.hpp"
+
+/**
+ * ProcessCommand
+ * \brief Program and arguments of a child process, the program is looked up on the path
+ */
+struct ProcessCommand final {
+  std::vector<std::string> arguments;
+};
+
+/**
+ * ProcessResult
+ * \brief Exit code of a child process and everything it wrote to stdout and stderr
+ */
+struct ProcessResult final {
+  int exit_code = -1;
+  std::string output;
+};
+
+using ProcessCallback = std::function<void(size_t index, const ProcessResult& result)>;
+
+/**
+ * Runs commands on at most jobs child processes at a time, zero jobs selects the hardware
+ * concurrency
+ *
+ * Output is captured through a pipe per process instead of being interleaved on the console, done
+ * is called on the calling thread in the order the processes finish.
+ */
+auto run_processes(std::span<const ProcessCommand> commands,
+                   uint32_t jobs,
+                   const ProcessCallback& done) -> void;
+
+auto run_process(const ProcessCommand& command) -> ProcessResult;
+
+/**
+ * Command line spelling of a command, arguments with spaces or quotes are quoted
+ */
+auto to_command_line(const ProcessCommand& command) -> std::string;
@@ -0,0 +1,94 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <atomic>
+
+#include "common.hpp"
+
+/**
+ * Profiler
+ * \brief Records nested per-thread spans and writes them as chrome trace-event json
+ *
+ * Recording is disabled until enable() is called, a disabled scope costs a single relaxed load.
+ * The trace is written at process exit so builds that bail out through exit() are still captured.
+ */
+class Profiler final {
+ public:
+  using clock = chrono::steady_clock;
+
+  struct Span final {
+    std::string_view name;
+    std::string detail;
+    clock::time_point begin;
+    clock::time_point end;
+  };
+
+ private:
+  static inline std::atomic_bool enabled_ = false;
+
+ public:
+  NODISCARD static auto enabled() -> bool { return enabled_.load(std::memory_order_relaxed); }
+
+  static auto enable(const fs::path& trace_path) -> void;
+
+  static auto record(Span span) -> void;
+
+  static auto write_chrome_trace(const fs::path& path) -> void;
+};
+
+/**
+ * ProfileScope
+ * \brief Records a span covering its lifetime when the profiler is enabled
+ */
+class ProfileScope final {
+  using clock = Profiler::clock;
+
+  bool active_;
+  std::string_view name_;
+  std::string detail_;
+  clock::time_point begin_;
+
+ public:
+  explicit ProfileScope(std::string_view name)
+      : active_{Profiler::enabled()},
+        name_{name} {
+    if (active_) {
+      begin_ = clock::now();
+    }
+  }
+
+  explicit ProfileScope(std::string_view name, std::string_view detail)
+      : ProfileScope{name} {
+    if (active_) {
+      detail_ = detail;
+    }
+  }
+
+  explicit ProfileScope(std::string_view name, const std::string& detail)
+      : ProfileScope{name, std::string_view{detail}} {}
+
+  explicit ProfileScope(std::string_view name, const fs::path& detail)
+      : ProfileScope{name} {
+    if (active_) {
+      detail_ = detail.generic_string();
+    }
+  }
+
+  ProfileScope(const ProfileScope&)                    = delete;
+  auto operator=(const ProfileScope&) -> ProfileScope& = delete;
+
+  ~ProfileScope() {
+    if (active_) {
+      Profiler::record({name_, std::move(detail_), begin_, clock::now()});
+    }
+  }
+};
+
+#define PROFILE_SCOPE(...) \
+  const auto _profile_scope_ = ProfileScope { __VA_ARGS__ }
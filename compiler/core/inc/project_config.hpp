@@ -16,20 +16,112 @@ enum class BinaryType : uint8_t {
   Dyn
 };
 
+/**
+ * Backend
+ * \brief What the generator lowers checked sources to
+ *
+ * Llvm writes a textual IR module per source in place of the C++ source, headers are still written
+ * so C++ projects can use the binary.
+ */
+enum class Backend : uint8_t {
+  Cpp,
+  Llvm
+};
+
+/**
+ * BuildType
+ * \brief Settings a configuration starts from before its own elements override them
+ */
+enum class BuildType : uint8_t {
+  Debug,
+  Release,
+  Profile
+};
+
+/**
+ * CodegenMode
+ * \brief Layout of the generated sources
+ *
+ * Readable sources are indented for whoever reads or debugs them, compact ones leave the
+ * indentation out.
+ */
+enum class CodegenMode : uint8_t {
+  Readable,
+  Compact
+};
+
+/**
+ * ProjectConfiguration
+ * \brief Named optimization and code generation settings a project is built with
+ *
+ * The selected configuration builds below its own subdirectory of the build and binary
+ * directories, switching configurations leaves the outputs of the others in place.
+ */
 class ProjectConfiguration final {
  public:
   using Pointer      = std::unique_ptr<ProjectConfiguration>;
   using ConstPointer = std::unique_ptr<const ProjectConfiguration>;
 
  private:
+  std::string name_;
+  std::string optimization_ = "2";
+  std::string target_cpu_;
+  bool lto_                 = false;
+  bool debug_info_          = false;
+  CodegenMode codegen_mode_ = CodegenMode::Readable;
+  std::vector<std::string> defines_;
+
+ public:
+  explicit ProjectConfiguration(std::string name)
+      : name_{std::move(name)} {}
+
+  NODISCARD auto& name() const { return name_; }
+
+  // Level of -O, one of 0, 1, 2, 3, s or z.
+  NODISCARD auto& optimization() const { return optimization_; }
+
+  // Value of -march, empty keeps the default target of the compiler.
+  NODISCARD auto& target_cpu() const { return target_cpu_; }
+  NODISCARD auto lto() const { return lto_; }
+  NODISCARD auto debug_info() const { return debug_info_; }
+  NODISCARD auto codegen_mode() const { return codegen_mode_; }
+  NODISCARD auto& defines() const { return defines_; }
+
+  auto set_optimization(const std::string_view level) { optimization_ = level; }
+  auto set_target_cpu(const std::string_view cpu) { target_cpu_ = cpu; }
+  auto set_lto(bool lto) { lto_ = lto; }
+  auto set_debug_info(bool debug_info) { debug_info_ = debug_info; }
+  auto set_codegen_mode(CodegenMode mode) { codegen_mode_ = mode; }
+  auto add_define(const std::string_view define) { defines_.emplace_back(define); }
+
+  /**
+   * Resets the settings to those of the build type
+   */
+  auto set_build_type(BuildType type) -> void;
 };
 
+/**
+ * ProjectReference
+ * \brief Another project whose public symbols and binary this project uses
+ */
 class ProjectReference final {
  public:
-  using Pointer      = std::unique_ptr<ProjectConfiguration>;
-  using ConstPointer = std::unique_ptr<const ProjectConfiguration>;
+  using Pointer      = std::unique_ptr<ProjectReference>;
+  using ConstPointer = std::unique_ptr<const ProjectReference>;
 
  private:
+  std::string name_;
+  fs::path path_;
+
+ public:
+  explicit ProjectReference(std::string name, fs::path path = {})
+      : name_{std::move(name)},
+        path_{std::move(path)} {}
+
+  NODISCARD auto& name() const { return name_; }
+
+  // Project file of the reference, empty when a solution resolves it by name.
+  NODISCARD auto& path() const { return path_; }
 };
 
 class ProjectConfig {
@@ -46,31 +138,57 @@ class ProjectConfig {
 #endif
 
   BinaryType binary_type_ = BinaryType::Exe;
+  Backend backend_        = Backend::Cpp;
   bool link_core_         = true;
   bool link_std_          = true;
 
+  bool unity_build_          = false;
+  uint32_t unity_batch_size_ = 8;
+
+  std::vector<std::string> training_command_;
+
   std::string name_;
-  fs::path source_dir_ = fs::proximate("src");
-  fs::path obj_dir_    = fs::proximate("obj");
-  fs::path bin_dir_    = fs::proximate("bin");
+  fs::path project_dir_ = fs::current_path();
+  fs::path source_dir_  = fs::proximate("src");
+  fs::path obj_dir_     = fs::proximate("obj");
+  fs::path bin_dir_     = fs::proximate("bin");
 
-  fs::path gen_dir_    = obj_dir_ / gen_dir_name;
-  fs::path gen_src_    = gen_dir_ / gen_src_dir_name;
+  fs::path gen_dir_     = obj_dir_ / gen_dir_name;
+  fs::path gen_src_     = gen_dir_ / gen_src_dir_name;
 
 #ifdef TRACE
   fs::path trace_dir_ = obj_dir_ / trace_dir_name;
 #endif
 
   std::vector<ProjectConfiguration::ConstPointer> configurations_;
+  const ProjectConfiguration* configuration_ = nullptr;
   std::vector<ProjectReference::ConstPointer> references_;
 
  public:
   NODISCARD auto binary_type() const { return binary_type_; }
+  NODISCARD auto backend() const { return backend_; }
   NODISCARD auto link_core() const { return link_core_; }
   NODISCARD auto link_std() const { return link_std_; }
 
+  // Generated sources of a namespace are compiled in batches of unity_batch_size.
+  NODISCARD auto unity_build() const { return unity_build_; }
+  NODISCARD auto unity_batch_size() const { return unity_batch_size_; }
+
+  // The binary is built instrumented, trained with training_command, then rebuilt with the profile.
+  NODISCARD auto profile_guided() const { return !training_command_.empty(); }
+  NODISCARD auto& training_command() const { return training_command_; }
+
   NODISCARD auto& name() const { return name_; }
+  NODISCARD auto& references() const { return references_; }
+  NODISCARD auto& configurations() const { return configurations_; }
+
+  // Selected configuration, null when the project is built without one.
+  NODISCARD auto* configuration() const { return configuration_; }
+  NODISCARD auto codegen_mode() const {
+    return configuration_ ? configuration_->codegen_mode() : CodegenMode::Readable;
+  }
 
+  NODISCARD auto& dir_project() const { return project_dir_; }
   NODISCARD auto& dir_source() const { return source_dir_; }
   NODISCARD auto& dir_build() const { return obj_dir_; }
   NODISCARD auto& dir_binary() const { return bin_dir_; }
@@ -78,25 +196,70 @@ class ProjectConfig {
   //NODISCARD auto& dir_gen() const { return gen_dir_; }
   NODISCARD auto& dir_gen_source() const { return gen_src_; }
 
+  // Public symbol table published next to the binary for dependent projects.
+  NODISCARD auto path_symbols() const { return bin_dir_ / name_ += symbol_file_ext; }
+
 #ifdef TRACE
   NODISCARD auto& dir_trace() const { return trace_dir_; }
 #endif
 
   auto set_name(const std::string_view name) { name_ = name; }
-  auto set_source_dir(const std::string_view path) { source_dir_ = path; }
+
+  /**
+   * Moves the project to dir, the default directories are placed below it
+   *
+   * Directories stay relative to the working directory, so a project loaded from it keeps the
+   * paths it always had.
+   */
+  auto set_project_dir(const fs::path& dir) -> void;
+
+  auto set_source_dir(const std::string_view path) {
+    source_dir_ = fs::proximate(project_dir_ / path);
+  }
   auto set_build_dir(const std::string_view path) {
-    obj_dir_ = path;
+    obj_dir_ = fs::proximate(project_dir_ / path);
     //gen_dir_     = obj_dir_ / gen_dir_name;
     gen_src_ = obj_dir_ / gen_src_dir_name;
 #ifdef TRACE
     trace_dir_ = obj_dir_ / trace_dir_name;
 #endif
   }
-  auto set_binary_dir(const std::string_view path) { bin_dir_ = path; }
+  auto set_binary_dir(const std::string_view path) {
+    bin_dir_ = fs::proximate(project_dir_ / path);
+  }
 
   auto set_binary_type(BinaryType type) { binary_type_ = type; }
+  auto set_backend(Backend backend) { backend_ = backend; }
   auto set_link_core(bool link_core) { link_core_ = link_core; }
   auto set_link_std(bool link_std) { link_std_ = link_std; }
+  auto set_unity_build(bool unity_build) { unity_build_ = unity_build; }
+  auto set_unity_batch_size(uint32_t batch_size) { unity_batch_size_ = batch_size; }
+  auto set_training_command(std::vector<std::string> command) {
+    training_command_ = std::move(command);
+  }
+
+  auto add_configuration(ProjectConfiguration::ConstPointer configuration) {
+    configurations_.push_back(std::move(configuration));
+  }
+
+  /**
+   * Builds with the configuration of the name, the built in Debug, Release and Profile exist
+   * unless the project declares its own
+   *
+   * The build and binary directories move to a subdirectory named after the configuration.
+   */
+  auto select_configuration(const std::string_view name) -> void;
+
+  auto add_reference(std::string name, fs::path path) {
+    references_.push_back(std::make_unique<ProjectReference>(std::move(name), std::move(path)));
+  }
+
+  /**
+   * Loads the single project file found in dir_path, an empty configuration selects none
+   */
+  static auto load(const fs::path& dir_path = fs::current_path(),
+                   const std::string_view configuration = {}) -> ConstPointer;
 
-  static auto load(const fs::path& dir_path = fs::current_path()) -> ConstPointer;
+  static auto load_file(const fs::path& file_path, const std::string_view configuration = {})
+      -> ConstPointer;
 };
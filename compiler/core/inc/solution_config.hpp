@@ -0,0 +1,53 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "project_config.hpp"
+
+/**
+ * SolutionConfig
+ * \brief A set of projects built together, references between them are resolved by name
+ */
+class SolutionConfig final {
+ public:
+  using Pointer      = std::unique_ptr<SolutionConfig>;
+  using ConstPointer = std::unique_ptr<const SolutionConfig>;
+
+ private:
+  std::string name_;
+  fs::path solution_dir_;
+  std::string configuration_;
+  std::vector<ProjectConfig::ConstPointer> projects_;
+
+ public:
+  NODISCARD auto& name() const { return name_; }
+  NODISCARD auto& dir_solution() const { return solution_dir_; }
+  NODISCARD auto& projects() const { return projects_; }
+
+  // Configuration every project of the solution is built with, empty selects none.
+  NODISCARD auto& configuration() const { return configuration_; }
+
+  auto set_name(const std::string_view name) { name_ = name; }
+  auto set_solution_dir(const fs::path& dir) { solution_dir_ = dir; }
+  auto set_configuration(const std::string_view name) { configuration_ = name; }
+
+  auto add_project(ProjectConfig::ConstPointer project) {
+    projects_.push_back(std::move(project));
+  }
+
+  /**
+   * Finds the solution file in dir_path, returns an empty path when there is none
+   */
+  static auto find(const fs::path& dir_path = fs::current_path()) -> fs::path;
+
+  /**
+   * Loads the solution and every project it lists, project paths are relative to the solution
+   */
+  static auto load_file(const fs::path& file_path, const std::string_view configuration = {})
+      -> ConstPointer;
+};
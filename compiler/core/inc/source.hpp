@@ -11,6 +11,25 @@
 #include "paths.hpp"
 #include "project_config.hpp"
 
+/**
+ * SourceStatistics
+ * \brief Per file compilation counters, filled in by the phases that process the file
+ */
+struct SourceStatistics final {
+  uint64_t bytes                   = 0;
+  uint64_t tokens                  = 0;
+  uint64_t syntax_nodes            = 0;
+
+  double lex_seconds               = 0;
+  double parse_seconds             = 0;
+
+  uint64_t generated_source_bytes  = 0;
+  uint64_t generated_header_bytes  = 0;
+
+  uint64_t eliminated_definitions  = 0;
+  uint64_t eliminated_syntax_nodes = 0;
+};
+
 class SourceContext final {
  public:
   using Pointer = std::shared_ptr<SourceContext>;
@@ -22,19 +41,23 @@ class SourceContext final {
   fs::path gen_source_path_;
   fs::path gen_header_internal_path_;
   fs::path gen_header_public_path_;
+  fs::path gen_ir_path_;
 
 #ifdef TRACE
   fs::path gen_token_path_;
   fs::path gen_syntax_path_;
 #endif
 
+  SourceStatistics stats_;
+
  public:
   explicit SourceContext(const ProjectConfig& config, const fs::path& file_path)
       : path_{file_path},
         rel_path_{fs::relative(file_path, config.dir_source())},
         gen_source_path_{config.dir_gen_source() / rel_path_.stem() += gen_src_file_ext},
         gen_header_internal_path_{config.dir_gen_source() / rel_path_.stem() += gen_hdr_file_ext},
-        gen_header_public_path_{config.dir_gen_source() / rel_path_.stem() += gen_hdr_file_ext}
+        gen_header_public_path_{config.dir_gen_source() / rel_path_.stem() += gen_hdr_file_ext},
+        gen_ir_path_{config.dir_gen_source() / rel_path_.stem() += gen_ir_file_ext}
 #ifdef TRACE
         ,
         gen_token_path_{config.dir_trace() / rel_path_ += tok_file_ext},
@@ -53,8 +76,14 @@ class SourceContext final {
   NODISCARD auto& gen_header_internal_path() const { return gen_header_internal_path_; }
   NODISCARD auto& gen_header_public_path() const { return gen_header_public_path_; }
 
+  // Module written in place of the source by the LLVM backend.
+  NODISCARD auto& gen_ir_path() const { return gen_ir_path_; }
+
   NODISCARD auto filename() const { return path_.filename(); }
 
+  NODISCARD auto& stats() const { return stats_; }
+  NODISCARD auto& stats() { return stats_; }
+
 #ifdef TRACE
   NODISCARD auto& gen_token_path() const { return gen_token_path_; }
   NODISCARD auto& gen_syntax_path() const { return gen_syntax_path_; }
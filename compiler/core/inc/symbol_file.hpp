@@ -0,0 +1,171 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <bit>
+#include <optional>
+
+#include "hash.hpp"
+#include "mapped_file.hpp"
+
+/*
+ * Binary public symbol table (.tysym)
+ *
+ * Little endian, every offset is relative to the start of the file and every section is 8 byte
+ * aligned so entries can be read in place from a memory mapping.
+ *
+ *   SymbolFileHeader
+ *   SymbolFileNamespace[namespace_count]  sorted by (hash, full name)
+ *   SymbolFileSymbol[symbol_count]        grouped by namespace, each group sorted by (hash, name)
+ *   string table                          utf-8 bytes referenced by offset and length
+ *
+ * Hashes are FNV-1a of the full namespace name or of the symbol name. Lookups binary search the
+ * namespace index, then the symbol range of that namespace, so only the touched pages are read.
+ * The header holds the hash of everything after it, readers compare tables without reading them.
+ */
+
+static_assert(std::endian::native == std::endian::little, "tysym files are little endian");
+
+constexpr auto symbol_file_magic         = uint32_t{0x4d595354};  // "TSYM"
+constexpr auto symbol_file_version       = uint32_t{2};
+constexpr auto symbol_file_section_align = size_t{8};
+
+struct SymbolFileString final {
+  uint32_t offset;
+  uint32_t length;
+};
+
+struct SymbolFileHeader final {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t file_size;
+  uint32_t reserved;
+  uint64_t content_hash;
+
+  SymbolFileString project;
+
+  uint32_t namespace_count;
+  uint32_t namespace_offset;
+  uint32_t symbol_count;
+  uint32_t symbol_offset;
+  uint32_t string_offset;
+  uint32_t string_size;
+};
+
+struct SymbolFileNamespace final {
+  uint64_t hash;
+  SymbolFileString full_name;
+  uint32_t first_symbol;
+  uint32_t symbol_count;
+};
+
+struct SymbolFileSymbol final {
+  uint64_t hash;
+  SymbolFileString name;
+
+  // C name of a ctype, type of a variable or signature of a function.
+  SymbolFileString detail;
+
+  uint8_t kind;
+  uint8_t access;
+  uint8_t is_mutable;
+  uint8_t reserved[5];
+};
+
+static_assert(sizeof(SymbolFileHeader) == 56);
+static_assert(sizeof(SymbolFileNamespace) == 24);
+static_assert(sizeof(SymbolFileSymbol) == 32);
+
+/**
+ * SymbolFileWriter
+ * \brief Collects namespaces and symbols in any order and serializes them into the binary layout
+ */
+class SymbolFileWriter final {
+  struct PendingSymbol final {
+    SymbolFileSymbol symbol;
+    std::string name;
+  };
+
+  struct PendingNamespace final {
+    std::string full_name;
+    std::vector<PendingSymbol> symbols;
+  };
+
+  std::string project_;
+  std::vector<PendingNamespace> namespaces_;
+  std::unordered_map<std::string, size_t> namespace_index_;
+
+  std::string strings_;
+  std::unordered_map<std::string, uint32_t> string_index_;
+
+ public:
+  explicit SymbolFileWriter(std::string project);
+
+  /**
+   * Returns the index of a namespace, creating it on first use
+   */
+  auto add_namespace(std::string_view full_name) -> size_t;
+
+  auto add_symbol(size_t name_space,
+                  uint8_t kind,
+                  uint8_t access,
+                  bool is_mutable,
+                  std::string_view name,
+                  std::string_view detail) -> void;
+
+  NODISCARD auto serialize() -> std::string;
+
+ private:
+  auto add_string(std::string_view value) -> SymbolFileString;
+};
+
+/**
+ * SymbolFile
+ * \brief Zero copy reader over a mapped .tysym, opening validates only the header and sections
+ */
+class SymbolFile final {
+ public:
+  using ConstPointer = std::unique_ptr<const SymbolFile>;
+
+ private:
+  MappedFile file_;
+  const SymbolFileHeader* header_        = nullptr;
+  const SymbolFileNamespace* namespaces_ = nullptr;
+  const SymbolFileSymbol* symbols_       = nullptr;
+  const char* strings_                   = nullptr;
+
+  SymbolFile() = default;
+
+ public:
+  /**
+   * Maps a symbol file, returns null when it is missing, truncated or of another version
+   */
+  static auto open(const fs::path& path) -> ConstPointer;
+
+  NODISCARD auto project() const -> std::string_view { return string(header_->project); }
+
+  NODISCARD auto content_hash() const -> ContentHash { return header_->content_hash; }
+
+  NODISCARD auto namespaces() const -> std::span<const SymbolFileNamespace> {
+    return {namespaces_, header_->namespace_count};
+  }
+
+  // Entries are not validated on open, ranges outside their section read as empty.
+  NODISCARD auto symbols(const SymbolFileNamespace& ns) const -> std::span<const SymbolFileSymbol>;
+  NODISCARD auto string(const SymbolFileString& value) const -> std::string_view;
+
+  NODISCARD auto find_namespace(std::string_view full_name) const -> const SymbolFileNamespace*;
+
+  NODISCARD auto find_symbol(const SymbolFileNamespace& ns, std::string_view name) const
+      -> const SymbolFileSymbol*;
+
+  NODISCARD auto find_symbol(std::string_view full_name, std::string_view name) const
+      -> const SymbolFileSymbol*;
+};
+
+using SymbolFileCollection = std::vector<SymbolFile::ConstPointer>;
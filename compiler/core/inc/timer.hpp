@@ -29,6 +29,24 @@ class Timer final {
   ~Timer() { TRACE_PRINT(name_ << " : " << std::fixed << elapsed() << " secs" << std::endl); }
 };
 
+/**
+ * Stopwatch
+ * \brief Silent counterpart to Timer for measurements that are reported elsewhere
+ */
+class Stopwatch final {
+  using clock = chrono::steady_clock;
+
+  clock::time_point start_time_;
+
+ public:
+  Stopwatch()
+      : start_time_{clock::now()} {}
+
+  NODISCARD auto elapsed() const -> double {
+    return chrono::duration<double>{clock::now() - start_time_}.count();
+  }
+};
+
 #ifdef TRACE
 #define TRACE_TIMER(name) \
   const auto _trace_timer_ = Timer { name }
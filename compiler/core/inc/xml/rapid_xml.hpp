@@ -71,4 +71,10 @@ inline auto get_node_value(const node& node) {
   return std::string_view{node.value(), node.value_size()};
 }
 
+inline auto get_attribute_value(const node& node, std::string_view name) {
+  auto* attribute = node.first_attribute(name.data(), name.size());
+  return attribute ? std::string_view{attribute->value(), attribute->value_size()}
+                   : std::string_view{};
+}
+
 }  // namespace xml
\ No newline at end of file
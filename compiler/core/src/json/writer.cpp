@@ -0,0 +1,123 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "json/writer.hpp"
+
+namespace json {
+
+auto Writer::write_separator() -> void {
+  if (key_pending_) {
+    key_pending_ = false;
+    return;
+  }
+
+  if (first_.empty()) {
+    return;
+  }
+
+  if (first_.back()) {
+    first_.back() = false;
+  } else {
+    writer_ << ',';
+  }
+}
+
+constexpr auto hex_digits = std::string_view{"0123456789abcdef"};
+
+auto Writer::write_string(std::string_view value) -> void {
+  writer_ << '"';
+  for (auto c : value) {
+    switch (c) {
+      case '"':
+        writer_ << "\\\"";
+        break;
+      case '\\':
+        writer_ << "\\\\";
+        break;
+      case '\n':
+        writer_ << "\\n";
+        break;
+      case '\r':
+        writer_ << "\\r";
+        break;
+      case '\t':
+        writer_ << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          writer_ << "\\u00" << hex_digits[(c >> 4) & 0xf] << hex_digits[c & 0xf];
+        } else {
+          writer_ << c;
+        }
+    }
+  }
+  writer_ << '"';
+}
+
+auto Writer::begin_object() -> Writer& {
+  write_separator();
+  writer_ << '{';
+  first_.push_back(true);
+  return *this;
+}
+
+auto Writer::end_object() -> Writer& {
+  assert(!first_.empty());
+  first_.pop_back();
+  writer_ << '}';
+  return *this;
+}
+
+auto Writer::begin_array() -> Writer& {
+  write_separator();
+  writer_ << '[';
+  first_.push_back(true);
+  return *this;
+}
+
+auto Writer::end_array() -> Writer& {
+  assert(!first_.empty());
+  first_.pop_back();
+  writer_ << ']';
+  return *this;
+}
+
+auto Writer::key(std::string_view name) -> Writer& {
+  write_separator();
+  write_string(name);
+  writer_ << ':';
+  key_pending_ = true;
+  return *this;
+}
+
+auto Writer::value(std::string_view value) -> Writer& {
+  write_separator();
+  write_string(value);
+  return *this;
+}
+
+auto Writer::value(bool value) -> Writer& {
+  write_separator();
+  writer_ << (value ? "true" : "false");
+  return *this;
+}
+
+auto Writer::value(uint64_t value) -> Writer& {
+  write_separator();
+  writer_ << value;
+  return *this;
+}
+
+auto Writer::value(int64_t value) -> Writer& {
+  write_separator();
+  writer_ << value;
+  return *this;
+}
+
+auto Writer::value(double value) -> Writer& {
+  write_separator();
+  writer_ << std::fixed << value << std::defaultfloat;
+  return *this;
+}
+
+}  // namespace json
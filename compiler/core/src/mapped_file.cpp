@@ -0,0 +1,134 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)},
+#ifdef _WIN32
+      file_{std::exchange(other.file_, nullptr)},
+      mapping_{std::exchange(other.mapping_, nullptr)} {
+}
+#else
+      file_{std::exchange(other.file_, -1)} {
+}
+#endif
+
+MappedFile::~MappedFile() { close(); }
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile& {
+  if (this != &other) {
+    close();
+    data_    = std::exchange(other.data_, nullptr);
+    size_    = std::exchange(other.size_, 0);
+#ifdef _WIN32
+    file_    = std::exchange(other.file_, nullptr);
+    mapping_ = std::exchange(other.mapping_, nullptr);
+#else
+    file_    = std::exchange(other.file_, -1);
+#endif
+  }
+  return *this;
+}
+
+#ifdef _WIN32
+
+auto MappedFile::open(const fs::path& path) -> bool {
+  close();
+
+  file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                      FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    file_ = nullptr;
+    return false;
+  }
+
+  auto size = LARGE_INTEGER{};
+  if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+    close();
+    return false;
+  }
+
+  mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping_ == nullptr) {
+    close();
+    return false;
+  }
+
+  data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr) {
+    close();
+    return false;
+  }
+  size_ = static_cast<size_t>(size.QuadPart);
+  return true;
+}
+
+auto MappedFile::close() -> void {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    CloseHandle(mapping_);
+  }
+  if (file_ != nullptr) {
+    CloseHandle(file_);
+  }
+  data_    = nullptr;
+  size_    = 0;
+  file_    = nullptr;
+  mapping_ = nullptr;
+}
+
+#else
+
+auto MappedFile::open(const fs::path& path) -> bool {
+  close();
+
+  file_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file_ < 0) {
+    return false;
+  }
+
+  struct stat status {};
+  if (fstat(file_, &status) != 0 || status.st_size == 0) {
+    close();
+    return false;
+  }
+
+  auto* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file_, 0);
+  if (data == MAP_FAILED) {
+    close();
+    return false;
+  }
+
+  data_ = static_cast<const std::byte*>(data);
+  size_ = static_cast<size_t>(status.st_size);
+  return true;
+}
+
+auto MappedFile::close() -> void {
+  if (data_ != nullptr) {
+    munmap(const_cast<std::byte*>(data_), size_);
+  }
+  if (file_ >= 0) {
+    ::close(file_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  file_ = -1;
+}
+
+#endif
@@ -2,3 +2,12 @@
 // All Rights Reserved.
 
 #include "paths.hpp"
+
+#include <sstream>
+
+auto read_all(const fs::path& path) -> std::string {
+  auto buffer = std::stringstream{};
+  auto file   = std::ifstream{path};
+  buffer << file.rdbuf();
+  return buffer.str();
+}
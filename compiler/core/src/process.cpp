@@ -0,0 +1,202 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "process.hpp"
+
+#include "parallel.hpp"
+
+#include <cerrno>
+
+#ifdef _WIN32
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+auto to_command_line(const ProcessCommand& command) -> std::string {
+  auto line = std::string{};
+  for (auto& argument : command.arguments) {
+    if (!line.empty()) {
+      line += ' ';
+    }
+
+    if (!argument.empty() && argument.find_first_of(" \t\"") == std::string::npos) {
+      line += argument;
+      continue;
+    }
+
+    line += '"';
+    for (auto c : argument) {
+      if (c == '"' || c == '\\') {
+        line += '\\';
+      }
+      line += c;
+    }
+    line += '"';
+  }
+  return line;
+}
+
+#ifdef _WIN32
+
+// Windows runs one process at a time through the shell, its output is still captured.
+auto run_processes(std::span<const ProcessCommand> commands,
+                   uint32_t jobs,
+                   const ProcessCallback& done) -> void {
+  for (auto i = size_t{0}; i < commands.size(); ++i) {
+    auto result     = ProcessResult{};
+    const auto line = to_command_line(commands[i]) + " 2>&1";
+    if (auto* pipe = _popen(line.c_str(), "r")) {
+      auto buffer = std::array<char, 4096>{};
+      while (const auto read = fread(buffer.data(), 1, buffer.size(), pipe)) {
+        result.output.append(buffer.data(), read);
+      }
+      result.exit_code = _pclose(pipe);
+    }
+    done(i, result);
+  }
+}
+
+#else
+
+/**
+ * RunningProcess
+ * \brief Child process whose output has not reached its end yet
+ */
+struct RunningProcess final {
+  size_t index;
+  pid_t pid;
+  int output;
+  ProcessResult result;
+};
+
+// Both ends are created close on exec in one call where the platform allows it, a child spawned
+// by another thread in between setting the flags would otherwise inherit them.
+auto open_pipe(std::array<int, 2>& fds) -> bool {
+#ifdef __linux__
+  return pipe2(fds.data(), O_CLOEXEC) == 0;
+#else
+  if (pipe(fds.data()) != 0) {
+    return false;
+  }
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+  return true;
+#endif
+}
+
+// Stdout and stderr of the child both go to the write end of a pipe. The read end is closed on
+// exec, so children started later do not keep it open.
+auto spawn(const ProcessCommand& command, pid_t& pid) -> int {
+  auto fds = std::array<int, 2>{};
+  if (command.arguments.empty() || !open_pipe(fds)) {
+    return -1;
+  }
+
+  auto actions = posix_spawn_file_actions_t{};
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+
+  auto argv = std::vector<char*>{};
+  for (auto& argument : command.arguments) {
+    argv.push_back(const_cast<char*>(argument.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  const auto result = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  close(fds[1]);
+
+  if (result != 0) {
+    close(fds[0]);
+    return -1;
+  }
+  return fds[0];
+}
+
+auto wait_exit_code(pid_t pid) -> int {
+  auto status = 0;
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR) {
+      return -1;
+    }
+  }
+  if (WIFEXITED(status)) {
+    return WEXITSTATUS(status);
+  }
+  return WIFSIGNALED(status) ? 128 + WTERMSIG(status) : -1;
+}
+
+auto run_processes(std::span<const ProcessCommand> commands,
+                   uint32_t jobs,
+                   const ProcessCallback& done) -> void {
+  const auto limit = worker_count(jobs, commands.size());
+  auto running     = std::vector<RunningProcess>{};
+  auto polled      = std::vector<pollfd>{};
+  auto next        = size_t{0};
+  auto buffer      = std::array<char, 4096>{};
+
+  while (next < commands.size() || !running.empty()) {
+    while (running.size() < limit && next < commands.size()) {
+      const auto index = next++;
+      auto pid         = pid_t{};
+      const auto fd    = spawn(commands[index], pid);
+      if (fd < 0) {
+        done(index, {-1, "failed to start \"" + to_command_line(commands[index]) + "\"\n"});
+        continue;
+      }
+      running.push_back({index, pid, fd, {}});
+    }
+
+    if (running.empty()) {
+      continue;
+    }
+
+    polled.clear();
+    for (auto& process : running) {
+      polled.push_back({process.output, POLLIN, 0});
+    }
+    if (poll(polled.data(), polled.size(), -1) < 0) {
+      continue;
+    }
+
+    // Erasing back to front keeps the indices of polled and running in step.
+    for (auto i = running.size(); i > 0; --i) {
+      auto& process = running[i - 1];
+      if (polled[i - 1].revents == 0) {
+        continue;
+      }
+
+      const auto read_size = read(process.output, buffer.data(), buffer.size());
+      if (read_size > 0) {
+        process.result.output.append(buffer.data(), static_cast<size_t>(read_size));
+        continue;
+      }
+      if (read_size < 0 && errno == EINTR) {
+        continue;
+      }
+
+      close(process.output);
+      process.result.exit_code = wait_exit_code(process.pid);
+      done(process.index, process.result);
+      running.erase(running.begin() + static_cast<ptrdiff_t>(i - 1));
+    }
+  }
+}
+
+#endif
+
+auto run_process(const ProcessCommand& command) -> ProcessResult {
+  auto result = ProcessResult{};
+  run_processes({&command, 1}, 1, [&](size_t, const ProcessResult& finished) {
+    result = finished;
+  });
+  return result;
+}
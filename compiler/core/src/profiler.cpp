@@ -0,0 +1,106 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "profiler.hpp"
+
+#include <mutex>
+
+#include "json/writer.hpp"
+
+namespace {
+
+struct ThreadSpans final {
+  uint32_t id;
+  std::vector<Profiler::Span> spans;
+};
+
+// Buffers are owned by the registry so spans outlive the worker threads that recorded them.
+std::mutex registry_mutex_;
+std::vector<std::unique_ptr<ThreadSpans>> registry_;
+Profiler::clock::time_point start_time_;
+fs::path trace_path_;
+
+auto register_thread() -> ThreadSpans& {
+  const auto lock = std::lock_guard{registry_mutex_};
+  auto id         = static_cast<uint32_t>(registry_.size());
+  return *registry_.emplace_back(std::make_unique<ThreadSpans>(ThreadSpans{id, {}}));
+}
+
+auto thread_spans() -> ThreadSpans& {
+  thread_local auto& spans = register_thread();
+  return spans;
+}
+
+auto to_microseconds(Profiler::clock::duration duration) -> double {
+  return chrono::duration<double, std::micro>{duration}.count();
+}
+
+}  // namespace
+
+auto Profiler::enable(const fs::path& trace_path) -> void {
+  start_time_ = clock::now();
+  trace_path_ = trace_path;
+
+  // Registers the enabling thread first so it is reported as the main thread.
+  thread_spans();
+  std::atexit([] { write_chrome_trace(trace_path_); });
+
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+auto Profiler::record(Span span) -> void { thread_spans().spans.emplace_back(std::move(span)); }
+
+constexpr auto trace_process_id = uint64_t{1};
+
+auto Profiler::write_chrome_trace(const fs::path& path) -> void {
+  const auto lock = std::lock_guard{registry_mutex_};
+
+  if (path.has_parent_path()) {
+    fs::create_directories(path.parent_path());
+  }
+
+  auto stream = std::ofstream{path};
+  if (stream.fail()) {
+    std::cerr << "Error : failed to open time trace file " << path << std::endl;
+    return;
+  }
+
+  auto writer = json::Writer{stream};
+  writer.begin_object();
+  writer.field("displayTimeUnit", "ms");
+  writer.key("traceEvents").begin_array();
+
+  for (auto& pthread : registry_) {
+    auto& thread = deref(pthread);
+
+    writer.begin_object()
+        .field("name", "thread_name")
+        .field("ph", "M")
+        .field("pid", trace_process_id)
+        .field("tid", uint64_t{thread.id});
+    writer.key("args").begin_object();
+    writer.field("name", thread.id == 0 ? std::string{"tyc"} : "worker " + std::to_string(thread.id));
+    writer.end_object();
+    writer.end_object();
+
+    for (auto& span : thread.spans) {
+      writer.begin_object()
+          .field("name", span.name)
+          .field("ph", "X")
+          .field("pid", trace_process_id)
+          .field("tid", uint64_t{thread.id})
+          .field("ts", to_microseconds(span.begin - start_time_))
+          .field("dur", to_microseconds(span.end - span.begin));
+      if (!span.detail.empty()) {
+        writer.key("args").begin_object();
+        writer.field("detail", span.detail);
+        writer.end_object();
+      }
+      writer.end_object();
+    }
+  }
+
+  writer.end_array();
+  writer.end_object();
+  stream << newline;
+}
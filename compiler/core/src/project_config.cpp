@@ -5,6 +5,11 @@
 
 #include "xml/rapid_xml.hpp"
 
+#include <charconv>
+#include <iterator>
+#include <sstream>
+#include <unordered_set>
+
 const auto binary_type_map = std::unordered_map<std::string_view, BinaryType>{
     {"Exe", BinaryType::Exe},
     {"Lib", BinaryType::Lib},
@@ -20,6 +25,11 @@ auto get_binary_type(const std::string_view view) -> BinaryType {
   exit(-1);
 }
 
+const auto backend_map = std::unordered_map<std::string_view, Backend>{
+    {"Cpp",  Backend::Cpp },
+    {"Llvm", Backend::Llvm},
+};
+
 auto find_project_file(const fs::path& dir_path) -> fs::path {
   auto project_file_paths = std::vector<fs::path>{};
 
@@ -42,13 +52,6 @@ auto find_project_file(const fs::path& dir_path) -> fs::path {
   return project_file_paths.front();
 }
 
-auto read_all(const fs::path& path) -> std::string {
-  auto buffer = std::stringstream{};
-  auto file   = std::ifstream{path};
-  buffer << file.rdbuf();
-  return buffer.str();
-}
-
 using project_node_handler = void (*)(ProjectConfig& config, const xml::node& node);
 
 auto project_name_handler(ProjectConfig& config, const xml::node& node) -> void {
@@ -94,6 +97,16 @@ auto project_binary_type_handler(ProjectConfig& config, const xml::node& node) -
   config.set_binary_type(bin_type);
 }
 
+auto project_backend_handler(ProjectConfig& config, const xml::node& node) -> void {
+  const auto value = xml::get_node_value(node);
+  if (auto it = backend_map.find(value); it != backend_map.end()) {
+    config.set_backend(it->second);
+  } else {
+    std::cerr << "Error : Unknown backend \"" << value << '"' << std::endl;
+    exit(-1);
+  }
+}
+
 auto to_lower(const std::string_view str) -> std::string {
   auto lower = std::string{};
   for (auto c : str) {
@@ -133,19 +146,279 @@ auto project_link_std_handler(ProjectConfig& config, const xml::node& node) -> v
   }
 }
 
+constexpr auto batch_size_attribute_name = std::string_view{"BatchSize"};
+
+auto project_unity_build_handler(ProjectConfig& config, const xml::node& node) -> void {
+  auto value = xml::get_node_value(node);
+  auto lower = to_lower(value);
+
+  if (lower == true_string) {
+    config.set_unity_build(true);
+  } else if (lower == false_string) {
+    config.set_unity_build(false);
+  } else {
+    std::cerr << "Error : Unknown UnityBuild value \"" << value << '"' << std::endl;
+    exit(-1);
+  }
+
+  auto batch_size = xml::get_attribute_value(node, batch_size_attribute_name);
+  if (batch_size.empty()) {
+    return;
+  }
+
+  const auto* last  = batch_size.data() + batch_size.size();
+  auto size         = uint32_t{0};
+  auto [end, error] = std::from_chars(batch_size.data(), last, size);
+  if (error != std::errc{} || end != last || size == 0) {
+    std::cerr << "Error : Invalid UnityBuild batch size \"" << batch_size << '"' << std::endl;
+    exit(-1);
+  }
+  config.set_unity_batch_size(size);
+}
+
+constexpr auto training_attribute_name = std::string_view{"Training"};
+
+// The training command is split on whitespace, a relative program path is relative to the project.
+auto project_profile_guided_handler(ProjectConfig& config, const xml::node& node) -> void {
+  auto value = xml::get_node_value(node);
+  auto lower = to_lower(value);
+
+  if (lower == false_string) {
+    config.set_training_command({});
+    return;
+  }
+  if (lower != true_string) {
+    std::cerr << "Error : Unknown ProfileGuided value \"" << value << '"' << std::endl;
+    exit(-1);
+  }
+
+  auto training = xml::get_attribute_value(node, training_attribute_name);
+  auto stream   = std::istringstream{std::string{training}};
+  auto command  = std::vector<std::string>{std::istream_iterator<std::string>{stream}, {}};
+  if (command.empty()) {
+    std::cerr << "Error : ProfileGuided requires a \"Training\" command." << std::endl;
+    exit(-1);
+  }
+
+  auto program = fs::path{command.front()};
+  if (program.is_relative() && program.has_parent_path()) {
+    command.front() = (config.dir_project() / program).lexically_normal().string();
+  }
+  config.set_training_command(std::move(command));
+}
+
+const auto build_type_map = std::unordered_map<std::string_view, BuildType>{
+    {"Debug",   BuildType::Debug  },
+    {"Release", BuildType::Release},
+    {"Profile", BuildType::Profile},
+};
+
+const auto codegen_mode_map = std::unordered_map<std::string_view, CodegenMode>{
+    {"Readable", CodegenMode::Readable},
+    {"Compact",  CodegenMode::Compact },
+};
+
+const auto optimization_levels = std::unordered_set<std::string_view>{"0", "1", "2", "3", "s", "z"};
+
+auto ProjectConfiguration::set_build_type(BuildType type) -> void {
+  switch (type) {
+    case BuildType::Debug: {
+      optimization_ = "0";
+      lto_          = false;
+      debug_info_   = true;
+      codegen_mode_ = CodegenMode::Readable;
+      return;
+    }
+    case BuildType::Release: {
+      optimization_ = "3";
+      lto_          = true;
+      debug_info_   = false;
+      codegen_mode_ = CodegenMode::Compact;
+      return;
+    }
+    case BuildType::Profile: {
+      optimization_ = "2";
+      lto_          = false;
+      debug_info_   = true;
+      codegen_mode_ = CodegenMode::Readable;
+      return;
+    }
+  }
+  throw std::exception("not implemented!");
+}
+
+auto get_bool(const xml::node& node) -> bool {
+  auto value = xml::get_node_value(node);
+  auto lower = to_lower(value);
+
+  if (lower == true_string) {
+    return true;
+  }
+  if (lower == false_string) {
+    return false;
+  }
+  std::cerr << "Error : Unknown " << xml::get_node_name(node) << " value \"" << value << '"'
+            << std::endl;
+  exit(-1);
+}
+
+using configuration_node_handler = void (*)(ProjectConfiguration& configuration,
+                                            const xml::node& node);
+
+auto configuration_optimization_handler(ProjectConfiguration& configuration,
+                                        const xml::node& node) -> void {
+  auto value = xml::get_node_value(node);
+  if (!optimization_levels.contains(value)) {
+    std::cerr << "Error : Unknown Optimization level \"" << value << '"' << std::endl;
+    exit(-1);
+  }
+  configuration.set_optimization(value);
+}
+
+auto configuration_target_cpu_handler(ProjectConfiguration& configuration, const xml::node& node)
+    -> void {
+  configuration.set_target_cpu(xml::get_node_value(node));
+}
+
+auto configuration_lto_handler(ProjectConfiguration& configuration, const xml::node& node) -> void {
+  configuration.set_lto(get_bool(node));
+}
+
+auto configuration_debug_info_handler(ProjectConfiguration& configuration, const xml::node& node)
+    -> void {
+  configuration.set_debug_info(get_bool(node));
+}
+
+auto configuration_codegen_handler(ProjectConfiguration& configuration, const xml::node& node)
+    -> void {
+  auto value = xml::get_node_value(node);
+  if (auto it = codegen_mode_map.find(value); it != codegen_mode_map.end()) {
+    configuration.set_codegen_mode(it->second);
+  } else {
+    std::cerr << "Error : Unknown Codegen mode \"" << value << '"' << std::endl;
+    exit(-1);
+  }
+}
+
+constexpr auto define_node_name = std::string_view{"Define"};
+
+auto configuration_defines_handler(ProjectConfiguration& configuration, const xml::node& node)
+    -> void {
+  for (auto pnode = node.first_node(); pnode; pnode = pnode->next_sibling()) {
+    auto& define   = deref(pnode);
+    auto node_name = xml::get_node_name(define);
+    if (node_name != define_node_name) {
+      std::cerr << "Error : Unknown defines node \"" << node_name << '"' << std::endl;
+      exit(-1);
+    }
+    configuration.add_define(xml::get_node_value(define));
+  }
+}
+
+const auto configuration_node_handlers =
+    std::unordered_map<std::string_view, configuration_node_handler>{
+        {"Optimization", configuration_optimization_handler},
+        {"TargetCpu",    configuration_target_cpu_handler  },
+        {"Lto",          configuration_lto_handler         },
+        {"DebugInfo",    configuration_debug_info_handler  },
+        {"Codegen",      configuration_codegen_handler     },
+        {"Defines",      configuration_defines_handler     },
+};
+
+constexpr auto configuration_node_name   = std::string_view{"Configuration"};
+constexpr auto name_attribute_name       = std::string_view{"Name"};
+constexpr auto build_type_attribute_name = std::string_view{"BuildType"};
+
+// A configuration is named after its build type unless it is given a name, one named after a
+// build type without giving one starts from that build type.
+auto create_configuration(const xml::node& node) -> ProjectConfiguration::ConstPointer {
+  auto name       = xml::get_attribute_value(node, name_attribute_name);
+  auto build_type = xml::get_attribute_value(node, build_type_attribute_name);
+  if (name.empty() && build_type.empty()) {
+    std::cerr << "Error : Configuration requires a \"Name\" or a \"BuildType\"." << std::endl;
+    exit(-1);
+  }
+
+  auto configuration = std::make_unique<ProjectConfiguration>(
+      std::string{name.empty() ? build_type : name});
+  auto type_name     = build_type.empty() ? name : build_type;
+  if (auto it = build_type_map.find(type_name); it != build_type_map.end()) {
+    configuration->set_build_type(it->second);
+  } else if (!build_type.empty()) {
+    std::cerr << "Error : Unknown BuildType \"" << build_type << '"' << std::endl;
+    exit(-1);
+  }
+
+  for (auto pnode = node.first_node(); pnode; pnode = pnode->next_sibling()) {
+    auto& child    = deref(pnode);
+    auto node_name = xml::get_node_name(child);
+
+    if (auto it = configuration_node_handlers.find(node_name);
+        it != configuration_node_handlers.end()) {
+      auto handler = it->second;
+      handler(*configuration, child);
+    } else {
+      std::cerr << "Error : Unknown configuration node \"" << node_name << '"' << std::endl;
+      exit(-1);
+    }
+  }
+  return configuration;
+}
+
 auto project_configurations_handler(ProjectConfig& config, const xml::node& node) -> void {
-  // todo : implement
+  for (auto pnode = node.first_node(); pnode; pnode = pnode->next_sibling()) {
+    auto& child    = deref(pnode);
+    auto node_name = xml::get_node_name(child);
+    if (node_name != configuration_node_name) {
+      std::cerr << "Error : Unknown configurations node \"" << node_name << '"' << std::endl;
+      exit(-1);
+    }
+
+    auto configuration = create_configuration(child);
+    for (auto& pexisting : config.configurations()) {
+      if (deref(pexisting).name() == configuration->name()) {
+        std::cerr << "Error : Duplicate configuration \"" << configuration->name() << '"'
+                  << std::endl;
+        exit(-1);
+      }
+    }
+    config.add_configuration(std::move(configuration));
+  }
 }
 
+constexpr auto reference_node_name = std::string_view{"Project"};
+constexpr auto path_attribute_name = std::string_view{"Path"};
+
+// Reference paths are written relative to the project file.
 auto project_references_handler(ProjectConfig& config, const xml::node& node) -> void {
-  // todo : implement
+  for (auto pnode = node.first_node(); pnode; pnode = pnode->next_sibling()) {
+    auto& reference = deref(pnode);
+    auto node_name  = xml::get_node_name(reference);
+    if (node_name != reference_node_name) {
+      std::cerr << "Error : Unknown reference node \"" << node_name << '"' << std::endl;
+      exit(-1);
+    }
+
+    auto name = xml::get_attribute_value(reference, name_attribute_name);
+    if (name.empty()) {
+      std::cerr << "Error : Project reference requires a \"Name\"." << std::endl;
+      exit(-1);
+    }
+
+    auto path = xml::get_attribute_value(reference, path_attribute_name);
+    config.add_reference(std::string{name},
+                         path.empty() ? fs::path{} : config.dir_project() / path);
+  }
 }
 
 const auto project_node_handlers = std::unordered_map<std::string_view, project_node_handler>{
     {"ProjectName",    project_name_handler          },
     {"BinaryType",     project_binary_type_handler   },
+    {"Backend",        project_backend_handler       },
     {"LinkCore",       project_link_core_handler     },
     {"LinkStd",        project_link_std_handler      },
+    {"UnityBuild",     project_unity_build_handler   },
+    {"ProfileGuided",  project_profile_guided_handler},
     {"Configurations", project_configurations_handler},
     {"References",     project_references_handler    },
     {"SourceDir",      project_source_dir_handler    },
@@ -153,8 +426,11 @@ const auto project_node_handlers = std::unordered_map<std::string_view, project_
     {"BinaryDir",      project_binary_dir_handler    },
 };
 
-auto create_project_config(const xml::node& xml) -> ProjectConfig::ConstPointer {
+auto create_project_config(const xml::node& xml,
+                           const fs::path& dir_path,
+                           const std::string_view configuration) -> ProjectConfig::ConstPointer {
   auto project = std::make_unique<ProjectConfig>();
+  project->set_project_dir(dir_path);
 
   for (auto pnode = xml.first_node(); pnode; pnode = pnode->next_sibling()) {
     auto& node     = deref(pnode);
@@ -169,16 +445,71 @@ auto create_project_config(const xml::node& xml) -> ProjectConfig::ConstPointer
     }
   }
 
+  if (!configuration.empty()) {
+    project->select_configuration(configuration);
+  }
   return project;
 }
 
 constexpr auto project_node_name = std::string_view{"Project"};
 
-auto ProjectConfig::load(const fs::path& dir_path) -> ConstPointer {
-  auto file_path = find_project_file(dir_path);
-  auto buffer    = read_all(file_path);
+auto ProjectConfig::set_project_dir(const fs::path& dir) -> void {
+  project_dir_ = fs::absolute(dir);
+  source_dir_  = fs::proximate(project_dir_ / "src");
+  obj_dir_     = fs::proximate(project_dir_ / "obj");
+  bin_dir_     = fs::proximate(project_dir_ / "bin");
+
+  gen_dir_     = obj_dir_ / gen_dir_name;
+  gen_src_     = gen_dir_ / gen_src_dir_name;
+
+#ifdef TRACE
+  trace_dir_ = obj_dir_ / trace_dir_name;
+#endif
+}
+
+auto ProjectConfig::select_configuration(const std::string_view name) -> void {
+  auto it = std::find_if(configurations_.begin(), configurations_.end(),
+                         [&](auto& pconfiguration) { return pconfiguration->name() == name; });
+  if (it == configurations_.end()) {
+    auto type = build_type_map.find(name);
+    if (type == build_type_map.end()) {
+      std::cerr << "Error : Project \"" << name_ << "\" has no configuration \"" << name << '"'
+                << std::endl;
+      exit(-1);
+    }
+    auto built_in = std::make_unique<ProjectConfiguration>(std::string{name});
+    built_in->set_build_type(type->second);
+    configurations_.push_back(std::move(built_in));
+    it = std::prev(configurations_.end());
+  }
+  configuration_ = it->get();
+
+  // Generated directories keep their place below the build directory.
+  const auto build_dir = obj_dir_ / name;
+  gen_dir_             = build_dir / gen_dir_.lexically_relative(obj_dir_);
+  gen_src_             = build_dir / gen_src_.lexically_relative(obj_dir_);
+#ifdef TRACE
+  trace_dir_ = build_dir / trace_dir_.lexically_relative(obj_dir_);
+#endif
+  obj_dir_ = build_dir;
+  bin_dir_ = bin_dir_ / name;
+}
+
+auto ProjectConfig::load(const fs::path& dir_path, const std::string_view configuration)
+    -> ConstPointer {
+  return load_file(find_project_file(dir_path), configuration);
+}
+
+auto ProjectConfig::load_file(const fs::path& file_path, const std::string_view configuration)
+    -> ConstPointer {
+  if (!fs::is_regular_file(file_path)) {
+    std::cerr << "Error : Project file \"" << file_path.string() << "\" not found." << std::endl;
+    exit(-1);
+  }
+
+  auto buffer = read_all(file_path);
 
-  auto doc       = xml::document{};
+  auto doc    = xml::document{};
   doc.parse<0>(buffer.data());
 
   auto project_node = doc.first_node(project_node_name.data(), project_node_name.size());
@@ -187,5 +518,6 @@ auto ProjectConfig::load(const fs::path& dir_path) -> ConstPointer {
     exit(-1);
   }
 
-  return create_project_config(deref(project_node));
+  return create_project_config(deref(project_node), fs::absolute(file_path).parent_path(),
+                               configuration);
 }
@@ -0,0 +1,105 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "solution_config.hpp"
+
+#include "xml/rapid_xml.hpp"
+
+auto SolutionConfig::find(const fs::path& dir_path) -> fs::path {
+  auto solution_file_paths = std::vector<fs::path>{};
+
+  {
+    auto it = fs::directory_iterator{dir_path};
+    std::copy_if(
+        begin(it), end(it), std::back_inserter(solution_file_paths), [](auto entry) -> bool {
+          return entry.is_regular_file() && entry.path().extension() == solution_file_ext;
+        });
+  }
+
+  if (solution_file_paths.size() > 1) {
+    std::cerr << "Only one solution file allowed!" << std::endl;
+    std::exit(-1);
+  }
+
+  return solution_file_paths.empty() ? fs::path{} : solution_file_paths.front();
+}
+
+using solution_node_handler = void (*)(SolutionConfig& config, const xml::node& node);
+
+auto solution_name_handler(SolutionConfig& config, const xml::node& node) -> void {
+  auto name = xml::get_node_value(node);
+  if (name.empty()) {
+    std::cerr << "Error : Empty \"SolutionName\" not allowed." << std::endl;
+    exit(-1);
+  }
+
+  config.set_name(name);
+}
+
+constexpr auto project_node_name   = std::string_view{"Project"};
+constexpr auto path_attribute_name = std::string_view{"Path"};
+
+auto solution_projects_handler(SolutionConfig& config, const xml::node& node) -> void {
+  for (auto pnode = node.first_node(); pnode; pnode = pnode->next_sibling()) {
+    auto& project  = deref(pnode);
+    auto node_name = xml::get_node_name(project);
+    if (node_name != project_node_name) {
+      std::cerr << "Error : Unknown solution project node \"" << node_name << '"' << std::endl;
+      exit(-1);
+    }
+
+    auto path = xml::get_attribute_value(project, path_attribute_name);
+    if (path.empty()) {
+      std::cerr << "Error : Solution project requires a \"Path\"." << std::endl;
+      exit(-1);
+    }
+
+    config.add_project(
+        ProjectConfig::load_file(config.dir_solution() / path, config.configuration()));
+  }
+}
+
+const auto solution_node_handlers = std::unordered_map<std::string_view, solution_node_handler>{
+    {"SolutionName", solution_name_handler    },
+    {"Projects",     solution_projects_handler},
+};
+
+constexpr auto solution_node_name = std::string_view{"Solution"};
+
+auto SolutionConfig::load_file(const fs::path& file_path, const std::string_view configuration)
+    -> ConstPointer {
+  if (!fs::is_regular_file(file_path)) {
+    std::cerr << "Error : Solution file \"" << file_path.string() << "\" not found." << std::endl;
+    exit(-1);
+  }
+
+  auto buffer = read_all(file_path);
+
+  auto doc    = xml::document{};
+  doc.parse<0>(buffer.data());
+
+  auto solution_node = doc.first_node(solution_node_name.data(), solution_node_name.size());
+  if (!solution_node) {
+    std::cerr << "Error : Solution file missing root \"Solution\" xml node." << std::endl;
+    exit(-1);
+  }
+
+  auto solution = std::make_unique<SolutionConfig>();
+  solution->set_solution_dir(fs::absolute(file_path).parent_path());
+  solution->set_configuration(configuration);
+
+  for (auto pnode = solution_node->first_node(); pnode; pnode = pnode->next_sibling()) {
+    auto& node     = deref(pnode);
+    auto node_name = xml::get_node_name(node);
+
+    if (auto it = solution_node_handlers.find(node_name); it != solution_node_handlers.end()) {
+      auto handler = it->second;
+      handler(*solution, node);
+    } else {
+      std::cerr << "Error : Unknown solution node \"" << node_name << '"' << std::endl;
+      exit(-1);
+    }
+  }
+
+  return solution;
+}
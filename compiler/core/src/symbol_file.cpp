@@ -0,0 +1,202 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "symbol_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+/* Writer */
+
+SymbolFileWriter::SymbolFileWriter(std::string project)
+    : project_{std::move(project)} {}
+
+auto SymbolFileWriter::add_namespace(std::string_view full_name) -> size_t {
+  auto [it, inserted] = namespace_index_.try_emplace(std::string{full_name}, namespaces_.size());
+  if (inserted) {
+    namespaces_.push_back({std::string{full_name}, {}});
+  }
+  return it->second;
+}
+
+auto SymbolFileWriter::add_symbol(size_t name_space,
+                                  uint8_t kind,
+                                  uint8_t access,
+                                  bool is_mutable,
+                                  std::string_view name,
+                                  std::string_view detail) -> void {
+  auto symbol       = SymbolFileSymbol{};
+  symbol.hash       = hash_content(name);
+  symbol.detail     = add_string(detail);
+  symbol.kind       = kind;
+  symbol.access     = access;
+  symbol.is_mutable = is_mutable ? 1 : 0;
+
+  // Names are added to the string table once symbols are ordered, see serialize().
+  namespaces_[name_space].symbols.push_back({symbol, std::string{name}});
+}
+
+auto SymbolFileWriter::add_string(std::string_view value) -> SymbolFileString {
+  auto [it, inserted] =
+      string_index_.try_emplace(std::string{value}, static_cast<uint32_t>(strings_.size()));
+  if (inserted) {
+    strings_.append(value);
+  }
+  return {it->second, static_cast<uint32_t>(value.size())};
+}
+
+constexpr auto align_section(size_t offset) -> size_t {
+  return (offset + symbol_file_section_align - 1) & ~(symbol_file_section_align - 1);
+}
+
+template <typename T>
+auto write_at(std::string& buffer, size_t offset, const T& value) -> void {
+  std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+auto SymbolFileWriter::serialize() -> std::string {
+  auto by_hash = [](auto hash_lhs, auto& lhs, auto hash_rhs, auto& rhs) {
+    return hash_lhs != hash_rhs ? hash_lhs < hash_rhs : lhs < rhs;
+  };
+
+  auto order = std::vector<size_t>(namespaces_.size());
+  for (auto i = size_t{0}; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](auto lhs, auto rhs) {
+    auto& left  = namespaces_[lhs].full_name;
+    auto& right = namespaces_[rhs].full_name;
+    return by_hash(hash_content(left), left, hash_content(right), right);
+  });
+
+  auto header    = SymbolFileHeader{};
+  header.magic   = symbol_file_magic;
+  header.version = symbol_file_version;
+  header.project = add_string(project_);
+
+  auto index     = std::vector<SymbolFileNamespace>{};
+  auto symbols   = std::vector<SymbolFileSymbol>{};
+  for (auto i : order) {
+    auto& ns = namespaces_[i];
+    std::sort(ns.symbols.begin(), ns.symbols.end(), [&](auto& lhs, auto& rhs) {
+      return by_hash(lhs.symbol.hash, lhs.name, rhs.symbol.hash, rhs.name);
+    });
+
+    index.push_back({hash_content(ns.full_name),
+                     add_string(ns.full_name),
+                     static_cast<uint32_t>(symbols.size()),
+                     static_cast<uint32_t>(ns.symbols.size())});
+    for (auto& pending : ns.symbols) {
+      pending.symbol.name = add_string(pending.name);
+      symbols.push_back(pending.symbol);
+    }
+  }
+
+  header.namespace_count  = static_cast<uint32_t>(index.size());
+  header.namespace_offset = static_cast<uint32_t>(align_section(sizeof(SymbolFileHeader)));
+  header.symbol_count     = static_cast<uint32_t>(symbols.size());
+  header.symbol_offset    = static_cast<uint32_t>(
+      align_section(header.namespace_offset + index.size() * sizeof(SymbolFileNamespace)));
+  header.string_offset    = static_cast<uint32_t>(
+      align_section(header.symbol_offset + symbols.size() * sizeof(SymbolFileSymbol)));
+  header.string_size      = static_cast<uint32_t>(strings_.size());
+  header.file_size        = header.string_offset + header.string_size;
+
+  auto buffer = std::string(header.file_size, '\0');
+  write_at(buffer, 0, header);
+  for (auto i = size_t{0}; i < index.size(); ++i) {
+    write_at(buffer, header.namespace_offset + i * sizeof(SymbolFileNamespace), index[i]);
+  }
+  for (auto i = size_t{0}; i < symbols.size(); ++i) {
+    write_at(buffer, header.symbol_offset + i * sizeof(SymbolFileSymbol), symbols[i]);
+  }
+  std::memcpy(buffer.data() + header.string_offset, strings_.data(), strings_.size());
+
+  header.content_hash = hash_content(std::string_view{buffer}.substr(sizeof(SymbolFileHeader)));
+  write_at(buffer, 0, header);
+  return buffer;
+}
+
+/* Reader */
+
+constexpr auto section_fits(size_t offset, size_t size, size_t file_size) -> bool {
+  return offset % symbol_file_section_align == 0 && offset <= file_size &&
+         size <= file_size - offset;
+}
+
+auto SymbolFile::open(const fs::path& path) -> ConstPointer {
+  auto file = MappedFile{};
+  if (!file.open(path) || file.size() < sizeof(SymbolFileHeader)) {
+    return nullptr;
+  }
+
+  auto* header = reinterpret_cast<const SymbolFileHeader*>(file.data());
+  if (header->magic != symbol_file_magic || header->version != symbol_file_version ||
+      header->file_size != file.size()) {
+    return nullptr;
+  }
+
+  const auto size = file.size();
+  if (!section_fits(header->namespace_offset,
+                    size_t{header->namespace_count} * sizeof(SymbolFileNamespace), size) ||
+      !section_fits(header->symbol_offset, size_t{header->symbol_count} * sizeof(SymbolFileSymbol),
+                    size) ||
+      !section_fits(header->string_offset, header->string_size, size)) {
+    return nullptr;
+  }
+
+  auto symbol_file         = std::unique_ptr<SymbolFile>{new SymbolFile{}};
+  auto* base               = file.data();
+  symbol_file->header_     = header;
+  symbol_file->namespaces_ =
+      reinterpret_cast<const SymbolFileNamespace*>(base + header->namespace_offset);
+  symbol_file->symbols_ = reinterpret_cast<const SymbolFileSymbol*>(base + header->symbol_offset);
+  symbol_file->strings_ = reinterpret_cast<const char*>(base + header->string_offset);
+  symbol_file->file_    = std::move(file);
+  return symbol_file;
+}
+
+auto SymbolFile::symbols(const SymbolFileNamespace& ns) const -> std::span<const SymbolFileSymbol> {
+  if (ns.first_symbol > header_->symbol_count ||
+      ns.symbol_count > header_->symbol_count - ns.first_symbol) {
+    return {};
+  }
+  return {symbols_ + ns.first_symbol, ns.symbol_count};
+}
+
+auto SymbolFile::string(const SymbolFileString& value) const -> std::string_view {
+  if (value.offset > header_->string_size || value.length > header_->string_size - value.offset) {
+    return {};
+  }
+  return {strings_ + value.offset, value.length};
+}
+
+// Entries are ordered by hash, ties between colliding hashes are ordered by name.
+template <typename Entry, typename Name>
+auto find_entry(std::span<const Entry> entries, std::string_view key, const Name& name)
+    -> const Entry* {
+  const auto hash = hash_content(key);
+  auto it         = std::lower_bound(entries.begin(), entries.end(), hash,
+                                     [](auto& entry, auto value) { return entry.hash < value; });
+  for (; it != entries.end() && it->hash == hash; ++it) {
+    if (name(*it) == key) {
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
+auto SymbolFile::find_namespace(std::string_view full_name) const -> const SymbolFileNamespace* {
+  return find_entry(namespaces(), full_name, [&](auto& ns) { return string(ns.full_name); });
+}
+
+auto SymbolFile::find_symbol(const SymbolFileNamespace& ns, std::string_view name) const
+    -> const SymbolFileSymbol* {
+  return find_entry(symbols(ns), name, [&](auto& symbol) { return string(symbol.name); });
+}
+
+auto SymbolFile::find_symbol(std::string_view full_name, std::string_view name) const
+    -> const SymbolFileSymbol* {
+  auto* ns = find_namespace(full_name);
+  return ns == nullptr ? nullptr : find_symbol(*ns, name);
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "project_tree.hpp"
+#include "dependency_db.hpp"
+#include "generator.hpp"
+#include "statistics.hpp"
+
+struct CompilerOptions final {
+  bool collect_stats        = false;
+
+  // Number of parse workers and compiler processes, zero selects the hardware concurrency.
+  uint32_t jobs             = 0;
+
+  // Object cache shared by every build, empty disables the cache.
+  fs::path cache_dir        = {};
+  uint64_t cache_size       = default_cache_size;
+
+  // Configuration projects are built with, empty builds them without one.
+  std::string configuration = {};
+};
+
+auto find_source_files(const ProjectConfig& config) -> SourceCollection;
+
+/**
+ * Parses sources on a pool of workers, each placing its trees into the project as it goes
+ */
+auto parse_sources(const SourceCollection& sources,
+                   const CompilerOptions& options,
+                   const ProjectTree& project_tree) -> std::vector<SourceRecord>;
+
+/**
+ * Compiler
+ * \brief Drives a single project through the frontend, the generator and the native build
+ */
+class Compiler final {
+  CompilerOptions options_;
+  ProjectConfig::ConstPointer owned_config_;
+  std::vector<ProjectConfig::ConstPointer> owned_references_;
+
+  const ProjectConfig* config_ = nullptr;
+  std::vector<const ProjectConfig*> references_;
+
+  SourceCollection sources_;
+  std::vector<fs::path> units_;
+  DependencyDatabase deps_;
+  PhaseTimes times_;
+
+ public:
+  /**
+   * Builds the project of the working directory, references are loaded from their path and
+   * references known only by name are left to a solution
+   */
+  explicit Compiler(const CompilerOptions& options);
+
+  /**
+   * Builds a project of a solution, the solution owns the project and its resolved references
+   */
+  Compiler(const CompilerOptions& options,
+           const ProjectConfig& config,
+           std::vector<const ProjectConfig*> references);
+
+  NODISCARD auto& config() const { return deref(config_); }
+  NODISCARD auto& references() const { return references_; }
+  NODISCARD auto& sources() const { return sources_; }
+  NODISCARD auto& times() const { return times_; }
+
+  auto run_frontend() -> ProjectTree;
+  auto run_backend(const ProjectTree& project_tree) -> void;
+  auto run_native() -> void;
+  auto write_stats() -> void;
+
+  auto run() -> int;
+};
@@ -0,0 +1,65 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "checker.hpp"
+#include "dependency_db.hpp"
+
+struct SourceFingerprint final {
+  ContentHash content_hash = 0;
+  uint64_t size            = 0;
+  int64_t write_time       = 0;
+};
+
+/**
+ * RebuildPlan
+ * \brief Partition of the project sources into files that must be parsed and files that are kept
+ */
+struct RebuildPlan final {
+  SourceCollection changed;
+  SourceCollection unchanged;
+  std::unordered_map<const SourceContext*, SourceFingerprint> fingerprints;
+
+  // Namespaces whose visible declarations differ from the previous build.
+  std::set<std::string> changed_namespaces;
+};
+
+/**
+ * Compares sources against the database, records of removed files are dropped
+ *
+ * A file is unchanged when its content hash matches and its generated outputs still exist, size
+ * and write time are checked first so unchanged files are not read.
+ */
+auto plan_rebuild(DependencyDatabase& deps, const SourceCollection& sources) -> RebuildPlan;
+
+/**
+ * Stores records of freshly parsed sources and collects namespaces whose surface changed
+ */
+auto record_sources(DependencyDatabase& deps,
+                    RebuildPlan& plan,
+                    const SourceCollection& sources,
+                    std::vector<SourceRecord> records) -> void;
+
+/**
+ * Moves unchanged files that see a changed namespace into the changed set, returning them
+ */
+auto take_dependents(const DependencyDatabase& deps, RebuildPlan& plan) -> SourceCollection;
+
+/**
+ * Moves unchanged files that left out definitions a changed file can see into the changed set,
+ * returning them
+ *
+ * A rebuilt file may start to use a definition that was eliminated from the outputs of a file that
+ * is kept as is, so such files are rebuilt until no changed file sees one of them.
+ */
+auto take_eliminating(const DependencyDatabase& deps, RebuildPlan& plan) -> SourceCollection;
+
+/**
+ * Stores what the outputs of every parsed source use from other files and what they leave out
+ */
+auto record_reachability(DependencyDatabase& deps, const DeadCodeReport& report) -> void;
@@ -0,0 +1,46 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "driver.hpp"
+#include "solution_config.hpp"
+
+/**
+ * SolutionBuilder
+ * \brief Builds the projects of a solution in reference order, independent projects concurrently
+ *
+ * References form a directed acyclic graph resolved by project name. A project starts as soon as
+ * the public symbol tables of its references are written, while their native builds may still be
+ * running. Its own native build waits for the native builds of its references.
+ */
+class SolutionBuilder final {
+  struct Node final {
+    const ProjectConfig* config = nullptr;
+    std::vector<size_t> references;
+    std::vector<size_t> dependents;
+  };
+
+  struct State;
+
+  CompilerOptions options_;
+  SolutionConfig::ConstPointer solution_;
+  std::vector<Node> nodes_;
+
+ public:
+  /**
+   * Resolves the references of every project, unknown references and cycles are errors
+   */
+  SolutionBuilder(const CompilerOptions& options, SolutionConfig::ConstPointer solution);
+
+  NODISCARD auto& solution() const { return deref(solution_); }
+
+  auto run() -> int;
+
+ private:
+  auto build_project(size_t index, State& state) const -> void;
+};
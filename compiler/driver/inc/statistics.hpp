@@ -0,0 +1,22 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "source.hpp"
+
+struct PhaseTimes final {
+  double parse_seconds    = 0;
+  double check_seconds    = 0;
+  double frontend_seconds = 0;
+  double backend_seconds  = 0;
+};
+
+auto write_statistics(const fs::path& path,
+                      const ProjectConfig& config,
+                      const SourceCollection& sources,
+                      const PhaseTimes& times) -> void;
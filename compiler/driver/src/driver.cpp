@@ -0,0 +1,241 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "driver.hpp"
+#include "incremental.hpp"
+
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "checker.hpp"
+#include "generator.hpp"
+#include "timer.hpp"
+#include "parallel.hpp"
+#include "profiler.hpp"
+
+auto write_tokens(const SourceContext& source, const TokenCollection& tokens) -> void {
+#ifdef TRACE
+  const auto& token_path = source.gen_token_path();
+  fs::create_directories(token_path.parent_path());
+
+  auto token_file = std::ofstream{token_path};
+  token_file << tokens;
+#endif
+}
+
+auto write_syntax(const SourceContext& source, const SyntaxTree& tree) -> void {
+#ifdef TRACE
+  const auto& syntax_path = source.gen_syntax_path();
+  fs::create_directories(syntax_path.parent_path());
+
+  auto syntax_file = std::ofstream{syntax_path};
+  syntax_file << tree;
+#endif
+}
+
+auto find_source_files(const ProjectConfig& config) -> SourceCollection {
+  PROFILE_SCOPE("Find Sources");
+  if (!fs::exists(config.dir_source())) {
+    std::cerr << "No source folder found" << std::endl;
+    exit(-1);
+  }
+
+  auto sources = SourceCollection{};
+
+  for (auto& entry : fs::recursive_directory_iterator(config.dir_source())) {
+    if (entry.is_regular_file() && entry.path().extension() == source_file_ext) {
+      auto& path = entry.path();
+      sources.emplace_back(std::make_unique<SourceContext>(config, path));
+    }
+  }
+
+  // Directory iteration order is unspecified, sorting keeps generated output stable.
+  std::sort(sources.begin(), sources.end(),
+            [](auto& lhs, auto& rhs) { return lhs->rel_path() < rhs->rel_path(); });
+  return sources;
+}
+
+// todo : implement already compiled optimization
+auto parse_source(const SourceContext::Pointer& psource, TypeGraph& types, bool collect_stats)
+    -> std::unique_ptr<SyntaxTree> {
+  auto& source = deref(psource);
+  auto& stats  = source.stats();
+  TRACE_PRINT("Compiling : " << source.absolute_path() << std::endl);
+  PROFILE_SCOPE("Compile", source.rel_path());
+
+  const auto lex_watch = Stopwatch{};
+  auto tokens          = lex(psource);
+  stats.lex_seconds    = lex_watch.elapsed();
+  write_tokens(source, tokens);
+
+  const auto parse_watch = Stopwatch{};
+  auto syntax            = parse(tokens, types);
+  stats.parse_seconds    = parse_watch.elapsed();
+  write_syntax(source, *syntax);
+
+  if (collect_stats) {
+    stats.bytes        = fs::file_size(source.path());
+    stats.tokens       = tokens.tokens().size();
+    stats.syntax_nodes = count_syntax_nodes(*syntax);
+  }
+
+  return syntax;
+}
+
+// Trees are placed by the worker that parsed them, only their records are returned.
+auto parse_sources(const SourceCollection& sources,
+                   const CompilerOptions& options,
+                   const ProjectTree& project_tree) -> std::vector<SourceRecord> {
+  auto records = std::vector<SourceRecord>(sources.size());
+
+  parallel_for(sources.size(), options.jobs, [&](size_t, size_t i) {
+    auto tree  = parse_source(sources[i], project_tree.types(), options.collect_stats);
+    records[i] = create_source_record(*tree);
+    place_tree(project_tree, std::move(tree));
+  });
+
+  return records;
+}
+
+constexpr auto stats_file_name = std::string_view{"stats.json"};
+
+Compiler::Compiler(const CompilerOptions& options)
+    : options_{options},
+      owned_config_{ProjectConfig::load(fs::current_path(), options.configuration)},
+      config_{owned_config_.get()} {
+  if (!config_) {
+    throw std::exception("Failed to load project config");
+  }
+
+  for (auto& preference : config_->references()) {
+    auto& reference = deref(preference);
+    if (!reference.path().empty()) {
+      auto& owned = owned_references_.emplace_back(
+          ProjectConfig::load_file(reference.path(), options_.configuration));
+      references_.push_back(owned.get());
+    }
+  }
+}
+
+Compiler::Compiler(const CompilerOptions& options,
+                   const ProjectConfig& config,
+                   std::vector<const ProjectConfig*> references)
+    : options_{options},
+      config_{&config},
+      references_{std::move(references)} {}
+
+// Reference tables are read before planning, a changed table invalidates every source.
+auto load_references(DependencyDatabase& deps, std::span<const ProjectConfig* const> references)
+    -> SymbolFileCollection {
+  PROFILE_SCOPE("Load References");
+  auto symbol_files = SymbolFileCollection{};
+  auto hashes       = std::map<std::string, ContentHash>{};
+
+  for (auto* preference : references) {
+    auto& reference = deref(preference);
+    auto file       = SymbolFile::open(reference.path_symbols());
+    if (!file) {
+      std::cerr << "Error : Missing public symbol table of reference \"" << reference.name()
+                << "\" at " << reference.path_symbols().string() << std::endl;
+      exit(-1);
+    }
+
+    hashes[reference.name()] = file->content_hash();
+    symbol_files.push_back(std::move(file));
+  }
+
+  if (deps.references() != hashes) {
+    deps.clear();
+    deps.set_references(std::move(hashes));
+  }
+  return symbol_files;
+}
+
+auto Compiler::run_frontend() -> ProjectTree {
+  TRACE_TIMER("Frontend");
+  PROFILE_SCOPE("Frontend");
+  const auto watch = Stopwatch{};
+  auto& config     = deref(config_);
+
+  sources_         = find_source_files(config);
+  deps_            = DependencyDatabase{config};
+  auto references  = load_references(deps_, references_);
+
+  // Modules are lowered from syntax, symbols of retained sources carry no signature to call with.
+  if (config.backend() == Backend::Llvm) {
+    deps_.clear();
+  }
+  auto plan = plan_rebuild(deps_, sources_);
+
+  auto project_tree = ProjectTree{};
+
+  // Dependents are only known once the surface of the changed files has been compared.
+  const auto parse_watch = Stopwatch{};
+  record_sources(deps_, plan, plan.changed, parse_sources(plan.changed, options_, project_tree));
+
+  auto dependents = take_dependents(deps_, plan);
+  record_sources(deps_, plan, dependents, parse_sources(dependents, options_, project_tree));
+
+  auto eliminating = take_eliminating(deps_, plan);
+  record_sources(deps_, plan, eliminating, parse_sources(eliminating, options_, project_tree));
+  times_.parse_seconds = parse_watch.elapsed();
+
+  TRACE_PRINT("Rebuilding : " << plan.changed.size() << " of " << sources_.size() << " sources"
+                              << std::endl);
+
+  auto retained = RetainedSourceCollection{};
+  for (auto& psource : plan.unchanged) {
+    retained.push_back({psource, deps_.find(deref(psource))});
+  }
+
+  const auto check_watch = Stopwatch{};
+  check(project_tree, std::move(retained), references, options_.jobs);
+  fold_constants(project_tree, options_.jobs);
+
+  const auto report = eliminate_dead_code(project_tree, config.binary_type(), options_.jobs);
+  record_reachability(deps_, report);
+  times_.check_seconds = check_watch.elapsed();
+
+  std::cout << "[Typhon] Dead Code : " << report.eliminated << " of " << report.definitions
+            << " definitions, " << report.eliminated_nodes << " of " << report.syntax_nodes
+            << " syntax nodes eliminated" << std::endl;
+
+  times_.frontend_seconds = watch.elapsed();
+  return project_tree;
+}
+
+auto Compiler::run_backend(const ProjectTree& project_tree) -> void {
+  TRACE_TIMER("Backend");
+  PROFILE_SCOPE("Backend");
+  const auto watch = Stopwatch{};
+
+  auto& config     = deref(config_);
+  units_           = generate(config, project_tree, references_);
+  deps_.save();
+
+  times_.backend_seconds = watch.elapsed();
+}
+
+auto Compiler::write_stats() -> void {
+  auto& config    = deref(config_);
+  const auto path = config.dir_build() / stats_file_name;
+  write_statistics(path, config, sources_, times_);
+  std::cout << "[Typhon] Statistics : " << path.string() << std::endl;
+}
+
+auto Compiler::run_native() -> void {
+  PROFILE_SCOPE("Native", deref(config_).name());
+  const auto build = BuildOptions{options_.jobs, options_.cache_dir, options_.cache_size};
+  compile(deref(config_), references_, units_, build);
+}
+
+auto Compiler::run() -> int {
+  auto project_tree = run_frontend();
+  run_backend(project_tree);
+
+  if (options_.collect_stats) {
+    write_stats();
+  }
+
+  run_native();
+  return 0;
+}
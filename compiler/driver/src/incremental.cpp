@@ -0,0 +1,153 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "incremental.hpp"
+
+#include <sstream>
+
+#include "profiler.hpp"
+
+auto fingerprint(const SourceContext& source, const SourceRecord* record) -> SourceFingerprint {
+  auto result       = SourceFingerprint{};
+  result.size       = fs::file_size(source.path());
+  result.write_time = fs::last_write_time(source.path()).time_since_epoch().count();
+
+  if (record && record->size == result.size && record->write_time == result.write_time) {
+    result.content_hash = record->content_hash;
+    return result;
+  }
+
+  auto buffer = std::stringstream{};
+  auto file   = std::ifstream{source.path(), std::ios::binary};
+  buffer << file.rdbuf();
+  result.content_hash = hash_content(buffer.view());
+  return result;
+}
+
+auto outputs_exist(const SourceContext& source) -> bool {
+  return fs::exists(source.gen_source_path()) && fs::exists(source.gen_header_internal_path());
+}
+
+auto plan_rebuild(DependencyDatabase& deps, const SourceCollection& sources) -> RebuildPlan {
+  PROFILE_SCOPE("Plan Rebuild");
+  auto plan    = RebuildPlan{};
+  auto present = std::unordered_set<std::string>{};
+
+  for (auto& psource : sources) {
+    auto& source = deref(psource);
+    auto* record = deps.find(source);
+    auto print   = fingerprint(source, record);
+
+    present.insert(source.rel_path().generic_string());
+    plan.fingerprints[&source] = print;
+
+    if (record && record->content_hash == print.content_hash && outputs_exist(source)) {
+      // Touched but identical files keep their record, only the cheap check is refreshed.
+      record->size       = print.size;
+      record->write_time = print.write_time;
+      plan.unchanged.push_back(psource);
+    } else {
+      plan.changed.push_back(psource);
+    }
+  }
+
+  auto removed = std::vector<std::string>{};
+  for (auto& [path, record] : deps.records()) {
+    if (!present.contains(path)) {
+      plan.changed_namespaces.insert(record.name_space);
+      removed.push_back(path);
+    }
+  }
+
+  for (auto& path : removed) {
+    deps.erase(path);
+  }
+
+  return plan;
+}
+
+auto record_sources(DependencyDatabase& deps,
+                    RebuildPlan& plan,
+                    const SourceCollection& sources,
+                    std::vector<SourceRecord> records) -> void {
+  for (auto i = size_t{0}; i < sources.size(); ++i) {
+    auto& source        = deref(sources[i]);
+    auto& print         = plan.fingerprints.at(&source);
+
+    auto& record        = records[i];
+    record.content_hash = print.content_hash;
+    record.size         = print.size;
+    record.write_time   = print.write_time;
+
+    const auto* previous = deps.find(source);
+    if (!previous || previous->name_space != record.name_space) {
+      plan.changed_namespaces.insert(record.name_space);
+      if (previous) {
+        plan.changed_namespaces.insert(previous->name_space);
+      }
+    } else if (previous->surface_hash() != record.surface_hash()) {
+      plan.changed_namespaces.insert(record.name_space);
+    }
+
+    deps.update(source, std::move(record));
+  }
+}
+
+auto take_dependents(const DependencyDatabase& deps, RebuildPlan& plan) -> SourceCollection {
+  auto dependents = SourceCollection{};
+  if (plan.changed_namespaces.empty()) {
+    return dependents;
+  }
+
+  auto sees_change = [&](const SourceContext::Pointer& psource) {
+    auto& record = deref(deps.find(deref(psource)));
+    return std::any_of(plan.changed_namespaces.begin(), plan.changed_namespaces.end(),
+                       [&](auto& ns) { return record.sees(ns); });
+  };
+
+  auto split = std::stable_partition(plan.unchanged.begin(), plan.unchanged.end(),
+                                     [&](auto& psource) { return !sees_change(psource); });
+
+  dependents.assign(split, plan.unchanged.end());
+  plan.unchanged.erase(split, plan.unchanged.end());
+  plan.changed.insert(plan.changed.end(), dependents.begin(), dependents.end());
+  return dependents;
+}
+
+auto take_eliminating(const DependencyDatabase& deps, RebuildPlan& plan) -> SourceCollection {
+  auto taken     = SourceCollection{};
+  auto record_of = [&](const SourceContext::Pointer& psource) -> auto& {
+    return deref(deps.find(deref(psource)));
+  };
+
+  auto seen_by_changed = [&](const SourceRecord& record) {
+    return std::any_of(plan.changed.begin(), plan.changed.end(), [&](auto& pchanged) {
+      return record_of(pchanged).sees(record.name_space);
+    });
+  };
+
+  // Files taken in one round are changed files for the next.
+  while (true) {
+    auto split = std::stable_partition(plan.unchanged.begin(), plan.unchanged.end(), [&](auto& p) {
+      auto& record = record_of(p);
+      return record.eliminated.empty() || !seen_by_changed(record);
+    });
+    if (split == plan.unchanged.end()) {
+      return taken;
+    }
+
+    taken.insert(taken.end(), split, plan.unchanged.end());
+    plan.changed.insert(plan.changed.end(), split, plan.unchanged.end());
+    plan.unchanged.erase(split, plan.unchanged.end());
+  }
+}
+
+auto record_reachability(DependencyDatabase& deps, const DeadCodeReport& report) -> void {
+  for (auto& entry : report.sources) {
+    if (auto* record = deps.find(deref(entry.source))) {
+      record->uses        = entry.uses;
+      record->header_uses = entry.header_uses;
+      record->eliminated  = entry.eliminated;
+    }
+  }
+}
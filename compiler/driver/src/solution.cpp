@@ -0,0 +1,203 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "solution.hpp"
+
+#include <condition_variable>
+#include <deque>
+
+#include "parallel.hpp"
+#include "profiler.hpp"
+
+auto find_project(const std::unordered_map<std::string_view, size_t>& projects,
+                  const ProjectConfig& config,
+                  const ProjectReference& reference) -> size_t {
+  auto it = projects.find(reference.name());
+  if (it == projects.end()) {
+    std::cerr << "Error : Project \"" << config.name() << "\" references \"" << reference.name()
+              << "\" which is not part of the solution." << std::endl;
+    exit(-1);
+  }
+  return it->second;
+}
+
+// Kahn's algorithm, whatever is left once no project is free of references lies on a cycle.
+auto check_acyclic(const std::vector<const ProjectConfig*>& configs,
+                   const std::vector<std::vector<size_t>>& references,
+                   const std::vector<std::vector<size_t>>& dependents) -> void {
+  auto pending = std::vector<size_t>(configs.size());
+  auto ready   = std::vector<size_t>{};
+  for (auto i = size_t{0}; i < configs.size(); ++i) {
+    pending[i] = references[i].size();
+    if (pending[i] == 0) {
+      ready.push_back(i);
+    }
+  }
+
+  auto visited = size_t{0};
+  while (!ready.empty()) {
+    const auto index = ready.back();
+    ready.pop_back();
+    ++visited;
+    for (auto dependent : dependents[index]) {
+      if (--pending[dependent] == 0) {
+        ready.push_back(dependent);
+      }
+    }
+  }
+
+  if (visited == configs.size()) {
+    return;
+  }
+
+  std::cerr << "Error : Reference cycle between projects";
+  auto separator = std::string_view{" "};
+  for (auto i = size_t{0}; i < configs.size(); ++i) {
+    if (pending[i] != 0) {
+      std::cerr << separator << '"' << configs[i]->name() << '"';
+      separator = ", ";
+    }
+  }
+  std::cerr << '.' << std::endl;
+  exit(-1);
+}
+
+SolutionBuilder::SolutionBuilder(const CompilerOptions& options,
+                                 SolutionConfig::ConstPointer solution)
+    : options_{options},
+      solution_{std::move(solution)} {
+  auto& projects = deref(solution_).projects();
+
+  auto configs   = std::vector<const ProjectConfig*>{};
+  auto by_name   = std::unordered_map<std::string_view, size_t>{};
+  for (auto& pconfig : projects) {
+    auto& config = deref(pconfig);
+    if (!by_name.emplace(config.name(), configs.size()).second) {
+      std::cerr << "Error : Project \"" << config.name() << "\" is part of the solution twice."
+                << std::endl;
+      exit(-1);
+    }
+    configs.push_back(&config);
+  }
+
+  auto references = std::vector<std::vector<size_t>>(configs.size());
+  auto dependents = std::vector<std::vector<size_t>>(configs.size());
+  for (auto i = size_t{0}; i < configs.size(); ++i) {
+    auto& config = deref(configs[i]);
+    for (auto& preference : config.references()) {
+      const auto index = find_project(by_name, config, deref(preference));
+      if (configs[index]->binary_type() == BinaryType::Exe) {
+        std::cerr << "Error : Project \"" << config.name() << "\" can not reference executable \""
+                  << configs[index]->name() << "\"." << std::endl;
+        exit(-1);
+      }
+      references[i].push_back(index);
+      dependents[index].push_back(i);
+    }
+  }
+
+  check_acyclic(configs, references, dependents);
+
+  for (auto i = size_t{0}; i < configs.size(); ++i) {
+    nodes_.push_back({configs[i], std::move(references[i]), std::move(dependents[i])});
+  }
+}
+
+/**
+ * SolutionBuilder::State
+ * \brief Progress of a solution build shared by its workers
+ */
+struct SolutionBuilder::State final {
+  std::mutex mutex;
+  std::condition_variable changed;
+
+  // Projects whose references have written their public symbol tables, in the order they became
+  // ready.
+  std::deque<size_t> ready;
+
+  // References of each project whose symbol tables are not written yet.
+  std::vector<size_t> pending;
+  std::vector<bool> built;
+  size_t started = 0;
+};
+
+auto SolutionBuilder::build_project(size_t index, State& state) const -> void {
+  auto& node = nodes_[index];
+  PROFILE_SCOPE("Project", deref(node.config).name());
+
+  auto references = std::vector<const ProjectConfig*>{};
+  for (auto reference : node.references) {
+    references.push_back(nodes_[reference].config);
+  }
+
+  auto compiler     = Compiler{options_, deref(node.config), std::move(references)};
+  auto project_tree = compiler.run_frontend();
+  compiler.run_backend(project_tree);
+
+  {
+    const auto lock = std::lock_guard{state.mutex};
+    for (auto dependent : node.dependents) {
+      if (--state.pending[dependent] == 0) {
+        state.ready.push_back(dependent);
+      }
+    }
+  }
+  state.changed.notify_all();
+
+  if (options_.collect_stats) {
+    compiler.write_stats();
+  }
+
+  // Linking needs the binaries of the references, not only their symbols.
+  {
+    auto lock = std::unique_lock{state.mutex};
+    state.changed.wait(lock, [&] {
+      return std::all_of(node.references.begin(), node.references.end(),
+                         [&](auto reference) { return state.built[reference]; });
+    });
+  }
+
+  compiler.run_native();
+
+  {
+    const auto lock    = std::lock_guard{state.mutex};
+    state.built[index] = true;
+  }
+  state.changed.notify_all();
+}
+
+auto SolutionBuilder::run() -> int {
+  PROFILE_SCOPE("Solution", solution().name());
+  auto state    = State{};
+  state.pending = std::vector<size_t>(nodes_.size());
+  state.built   = std::vector<bool>(nodes_.size());
+  for (auto i = size_t{0}; i < nodes_.size(); ++i) {
+    state.pending[i] = nodes_[i].references.size();
+    if (state.pending[i] == 0) {
+      state.ready.push_back(i);
+    }
+  }
+
+  // Every worker takes the next ready project until each project has been started.
+  const auto workers = worker_count(options_.jobs, nodes_.size());
+  parallel_for(workers, static_cast<uint32_t>(workers), [&](size_t, size_t) {
+    while (true) {
+      auto index = size_t{0};
+      {
+        auto lock = std::unique_lock{state.mutex};
+        state.changed.wait(lock, [&] {
+          return !state.ready.empty() || state.started == nodes_.size();
+        });
+        if (state.ready.empty()) {
+          return;
+        }
+        index = state.ready.front();
+        state.ready.pop_front();
+        ++state.started;
+      }
+      build_project(index, state);
+    }
+  });
+
+  return 0;
+}
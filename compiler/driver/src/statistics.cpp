@@ -0,0 +1,109 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "statistics.hpp"
+
+#include "json/writer.hpp"
+
+constexpr auto statistics_version = uint64_t{1};
+constexpr auto bytes_per_megabyte = 1024.0 * 1024.0;
+
+auto per_second(double amount, double seconds) -> double {
+  return seconds > 0 ? amount / seconds : 0;
+}
+
+auto write_source(json::Writer& writer, const SourceContext& source) {
+  auto& stats = source.stats();
+
+  writer.begin_object();
+  writer.field("path", source.rel_path().generic_string());
+  writer.field("bytes", stats.bytes);
+  writer.field("tokens", stats.tokens);
+  writer.field("syntax_nodes", stats.syntax_nodes);
+  writer.field("lex_seconds", stats.lex_seconds);
+  writer.field("parse_seconds", stats.parse_seconds);
+
+  writer.key("generated").begin_object();
+  writer.field("source_bytes", stats.generated_source_bytes);
+  writer.field("header_bytes", stats.generated_header_bytes);
+  writer.end_object();
+
+  writer.key("eliminated").begin_object();
+  writer.field("definitions", stats.eliminated_definitions);
+  writer.field("syntax_nodes", stats.eliminated_syntax_nodes);
+  writer.end_object();
+
+  writer.end_object();
+}
+
+auto write_statistics(const fs::path& path,
+                      const ProjectConfig& config,
+                      const SourceCollection& sources,
+                      const PhaseTimes& times) -> void {
+  auto totals = SourceStatistics{};
+  for (auto& psource : sources) {
+    auto& stats = deref(psource).stats();
+    totals.bytes += stats.bytes;
+    totals.tokens += stats.tokens;
+    totals.syntax_nodes += stats.syntax_nodes;
+    totals.lex_seconds += stats.lex_seconds;
+    totals.parse_seconds += stats.parse_seconds;
+    totals.generated_source_bytes += stats.generated_source_bytes;
+    totals.generated_header_bytes += stats.generated_header_bytes;
+    totals.eliminated_definitions += stats.eliminated_definitions;
+    totals.eliminated_syntax_nodes += stats.eliminated_syntax_nodes;
+  }
+
+  fs::create_directories(path.parent_path());
+  auto stream = std::ofstream{path};
+  auto writer = json::Writer{stream};
+
+  writer.begin_object();
+  writer.field("version", statistics_version);
+  writer.field("project", config.name());
+
+  writer.key("totals").begin_object();
+  writer.field("files", static_cast<uint64_t>(sources.size()));
+  writer.field("bytes", totals.bytes);
+  writer.field("tokens", totals.tokens);
+  writer.field("syntax_nodes", totals.syntax_nodes);
+  writer.field("lex_seconds", totals.lex_seconds);
+  writer.field("parse_seconds", totals.parse_seconds);
+  writer.field("generated_source_bytes", totals.generated_source_bytes);
+  writer.field("generated_header_bytes", totals.generated_header_bytes);
+  writer.field("eliminated_definitions", totals.eliminated_definitions);
+  writer.field("eliminated_syntax_nodes", totals.eliminated_syntax_nodes);
+  writer.field("parse_wall_seconds", times.parse_seconds);
+  writer.field("check_seconds", times.check_seconds);
+  writer.field("frontend_seconds", times.frontend_seconds);
+  writer.field("backend_seconds", times.backend_seconds);
+  writer.end_object();
+
+  // Lex and parse rates use summed per file cpu time, frontend rate uses wall time.
+  writer.key("throughput").begin_object();
+  writer.field("lex_megabytes_per_second",
+               per_second(totals.bytes / bytes_per_megabyte, totals.lex_seconds));
+  writer.field("lex_tokens_per_second",
+               per_second(static_cast<double>(totals.tokens), totals.lex_seconds));
+  writer.field("parse_tokens_per_second",
+               per_second(static_cast<double>(totals.tokens), totals.parse_seconds));
+  writer.field("parse_nodes_per_second",
+               per_second(static_cast<double>(totals.syntax_nodes), totals.parse_seconds));
+  writer.field("frontend_megabytes_per_second",
+               per_second(totals.bytes / bytes_per_megabyte, times.frontend_seconds));
+  writer.field(
+      "generated_megabytes_per_second",
+      per_second((totals.generated_source_bytes + totals.generated_header_bytes) /
+                     bytes_per_megabyte,
+                 times.backend_seconds));
+  writer.end_object();
+
+  writer.key("sources").begin_array();
+  for (auto& psource : sources) {
+    write_source(writer, deref(psource));
+  }
+  writer.end_array();
+
+  writer.end_object();
+  stream << newline;
+}
@@ -8,5 +8,60 @@
 #endif
 
 #include "project_tree.hpp"
+#include "symbol_file.hpp"
 
-auto check(SyntaxTreeCollection& syntax_trees) -> ProjectTree;
\ No newline at end of file
+/**
+ * Places a parsed tree into its namespace, safe to call from several parse workers at once
+ */
+auto place_tree(const ProjectTree& project, std::unique_ptr<SyntaxTree> tree) -> void;
+
+/**
+ * Runs once every parsed tree is placed, adds retained sources and orders the project
+ *
+ * Declarations are then collected and function bodies checked, both on jobs workers. Public
+ * symbols of referenced projects are visible to every source.
+ */
+auto check(ProjectTree& project_tree,
+           RetainedSourceCollection retained                    = {},
+           std::span<const SymbolFile::ConstPointer> references = {},
+           uint32_t jobs                                        = 0) -> void;
+
+/**
+ * Folds constant expressions of every parsed tree in place once the project is checked
+ *
+ * Immutable variables with a constant value are propagated within their source and kept in the
+ * project tree. If chains with constant conditions lose the branches that never run. Replaced
+ * nodes are destroyed, only identifiers, calls and scope opening nodes are looked up in the
+ * symbol table and folding creates none of those.
+ */
+auto fold_constants(ProjectTree& project_tree, uint32_t jobs = 0) -> void;
+
+/**
+ * DeadCodeReport
+ * \brief Result of dead code elimination, with what each parsed source refers to elsewhere
+ */
+struct DeadCodeReport final {
+  struct Source final {
+    const SourceContext* source;
+    std::vector<std::string> uses;
+    std::vector<std::string> header_uses;
+    std::vector<std::string> eliminated;
+  };
+
+  uint64_t definitions      = 0;
+  uint64_t eliminated       = 0;
+  uint64_t syntax_nodes     = 0;
+  uint64_t eliminated_nodes = 0;
+
+  std::vector<Source> sources;
+};
+
+/**
+ * Marks module level definitions that can not be reached from the roots of the binary
+ *
+ * Executables are rooted at main, libraries at their public symbols. Only private and module
+ * definitions, unspecified access included, are ever dropped. Wider access, variables whose
+ * initializer may have side effects and every use recorded by a retained source stay roots.
+ */
+auto eliminate_dead_code(ProjectTree& project_tree, BinaryType binary_type, uint32_t jobs = 0)
+    -> DeadCodeReport;
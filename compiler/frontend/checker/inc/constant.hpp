@@ -0,0 +1,138 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <variant>
+
+#include "syntax_tree.hpp"
+
+enum class ConstantType : uint8_t {
+  Bool,
+  I8,
+  I16,
+  I32,
+  I64,
+  U8,
+  U16,
+  U32,
+  U64,
+  F32,
+  F64
+};
+
+constexpr auto is_floating(ConstantType type) -> bool {
+  return type == ConstantType::F32 || type == ConstantType::F64;
+}
+
+constexpr auto is_signed(ConstantType type) -> bool {
+  return type == ConstantType::I8 || type == ConstantType::I16 || type == ConstantType::I32 ||
+         type == ConstantType::I64;
+}
+
+constexpr auto is_unsigned(ConstantType type) -> bool {
+  return type == ConstantType::U8 || type == ConstantType::U16 || type == ConstantType::U32 ||
+         type == ConstantType::U64;
+}
+
+constexpr auto bit_width(ConstantType type) -> uint32_t {
+  switch (type) {
+    case ConstantType::Bool: {
+      return 1;
+    }
+    case ConstantType::I8:
+    case ConstantType::U8: {
+      return 8;
+    }
+    case ConstantType::I16:
+    case ConstantType::U16: {
+      return 16;
+    }
+    case ConstantType::I32:
+    case ConstantType::U32:
+    case ConstantType::F32: {
+      return 32;
+    }
+    default: {
+      return 64;
+    }
+  }
+}
+
+// Integral promotion, every type narrower than int is computed as int.
+constexpr auto promote(ConstantType type) -> ConstantType {
+  return bit_width(type) < 32 ? ConstantType::I32 : type;
+}
+
+// Usual arithmetic conversions of two promoted operands.
+constexpr auto common_type(ConstantType lhs, ConstantType rhs) -> ConstantType {
+  lhs = promote(lhs);
+  rhs = promote(rhs);
+  if (lhs == ConstantType::F64 || rhs == ConstantType::F64) {
+    return ConstantType::F64;
+  }
+  if (lhs == ConstantType::F32 || rhs == ConstantType::F32) {
+    return ConstantType::F32;
+  }
+  if (is_signed(lhs) == is_signed(rhs)) {
+    return bit_width(lhs) >= bit_width(rhs) ? lhs : rhs;
+  }
+
+  // The unsigned type wins unless the signed one is wider and can hold all of its values.
+  const auto signed_type   = is_signed(lhs) ? lhs : rhs;
+  const auto unsigned_type = is_signed(lhs) ? rhs : lhs;
+  return bit_width(unsigned_type) >= bit_width(signed_type) ? unsigned_type : signed_type;
+}
+
+/**
+ * Constant type of a fixed width C type, int32_t, uint8_t, float, double...
+ */
+auto constant_type_of(std::string_view c_name) -> std::optional<ConstantType>;
+
+/**
+ * ConstantValue
+ * \brief Value of a constant expression, integers are kept wrapped to the width of their type
+ *
+ * Signed integers are held as int64_t, unsigned integers as uint64_t and f32 values as the double
+ * nearest to them, so equal values of the same type compare equal.
+ */
+struct ConstantValue final {
+  ConstantType type;
+  std::variant<bool, int64_t, uint64_t, double> value;
+
+  auto operator==(const ConstantValue&) const -> bool = default;
+};
+
+using ConstantValueMap = std::unordered_map<const BaseSyntax*, ConstantValue>;
+
+auto to_bool(const ConstantValue& constant) -> bool;
+
+/**
+ * Implicit conversion as done by C++, null when the result is undefined
+ */
+auto convert(const ConstantValue& constant, ConstantType type) -> std::optional<ConstantValue>;
+
+/**
+ * Result of an operator with C++ promotions and fixed width semantics
+ *
+ * Null when the operator has side effects or the result is undefined, signed overflow, division
+ * by zero or shifts out of range, so the expression is left to run as written.
+ */
+auto evaluate(Operator op, const ConstantValue& operand) -> std::optional<ConstantValue>;
+auto evaluate(Operator op, const ConstantValue& lhs, const ConstantValue& rhs)
+    -> std::optional<ConstantValue>;
+
+/**
+ * Value of a number literal, either from source or written by to_literal
+ */
+auto parse_literal(std::string_view literal) -> std::optional<ConstantValue>;
+
+/**
+ * C++ literal of the same type and value, null for types without literals or values that are not
+ * finite
+ */
+auto to_literal(const ConstantValue& constant) -> std::optional<std::string>;
@@ -0,0 +1,119 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "syntax_tree.hpp"
+#include "hash.hpp"
+
+enum class SymbolKind : uint8_t {
+  CInclude,
+  CType,
+  Variable,
+  Struct,
+  Object,
+  Function,
+  Parameter
+};
+
+/**
+ * ExportedSymbol
+ * \brief A module scope declaration visible outside of its source file
+ */
+struct ExportedSymbol final {
+  SymbolKind kind;
+  AccessModifier access;
+  std::string name;
+
+  // C name of a ctype, type of a variable or signature of a function.
+  std::string detail;
+
+  bool is_mutable = false;
+};
+
+/**
+ * SourceRecord
+ * \brief Everything a rebuild needs to know about a source file without parsing it
+ */
+struct SourceRecord final {
+  ContentHash content_hash = 0;
+  uint64_t size            = 0;
+  int64_t write_time       = 0;
+
+  std::string name_space;
+  std::vector<std::string> imports;
+  std::vector<ExportedSymbol> exports;
+
+  // Names of private definitions, they have internal linkage and may repeat in other files.
+  std::vector<std::string> privates;
+
+  // Module keys of declarations in other files that the generated outputs refer to.
+  std::vector<std::string> uses;
+
+  // Uses of the internal header, the types its declarations are spelled with.
+  std::vector<std::string> header_uses;
+
+  // Non private definitions left out of the generated outputs as unreachable.
+  std::vector<std::string> eliminated;
+
+  NODISCARD auto surface_hash() const -> ContentHash;
+
+  /**
+   * Whether declarations of ns are visible to the file, through its own namespace, an enclosing
+   * namespace or an import
+   */
+  NODISCARD auto sees(std::string_view ns) const -> bool;
+};
+
+/**
+ * Key of a module scope declaration that stays the same across builds, "A::B::name"
+ */
+auto module_key(std::string_view name_space, std::string_view name) -> std::string;
+
+auto collect_exports(const SyntaxTree& tree) -> std::vector<ExportedSymbol>;
+
+auto collect_private_names(const SyntaxTree& tree) -> std::vector<std::string>;
+
+auto create_source_record(const SyntaxTree& tree) -> SourceRecord;
+
+/**
+ * DependencyDatabase
+ * \brief Persistent per file records used to limit a rebuild to changed files and their dependents
+ */
+class DependencyDatabase final {
+  fs::path path_;
+  std::map<std::string, SourceRecord> records_;
+
+  // Content hash of the public symbol table of every referenced project, by project name.
+  std::map<std::string, ContentHash> references_;
+
+ public:
+  DependencyDatabase() = default;
+
+  explicit DependencyDatabase(const ProjectConfig& config);
+
+  NODISCARD auto& records() const { return records_; }
+  NODISCARD auto& references() const { return references_; }
+
+  NODISCARD auto find(const SourceContext& source) const -> const SourceRecord*;
+  NODISCARD auto find(const SourceContext& source) -> SourceRecord*;
+
+  auto update(const SourceContext& source, SourceRecord record) -> const SourceRecord&;
+
+  auto erase(const std::string& rel_path) -> void;
+
+  /**
+   * Drops every source record, the next plan rebuilds the whole project
+   */
+  auto clear() -> void { records_.clear(); }
+
+  auto set_references(std::map<std::string, ContentHash> references) -> void {
+    references_ = std::move(references);
+  }
+
+  auto save() const -> void;
+};
@@ -0,0 +1,53 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <atomic>
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+
+#include "common.hpp"
+
+using InternId                  = uint32_t;
+
+constexpr auto invalid_intern_id = ~InternId{0};
+
+/**
+ * StringInterner
+ * \brief Maps each distinct string to a dense id, ids compare in O(1) where names would not
+ *
+ * Interning may run from several threads. find() never allocates and takes only a shared lock,
+ * once sealed the interner is read only and lookups take no lock at all.
+ */
+class StringInterner final {
+  std::deque<std::string> strings_;
+  std::unordered_map<std::string_view, InternId> ids_;
+  mutable std::shared_mutex mutex_;
+  std::atomic_bool sealed_ = false;
+
+ public:
+  StringInterner() = default;
+
+  StringInterner(const StringInterner&)                    = delete;
+  auto operator=(const StringInterner&) -> StringInterner& = delete;
+
+  NODISCARD auto size() const { return strings_.size(); }
+  NODISCARD auto sealed() const { return sealed_.load(std::memory_order_acquire); }
+
+  NODISCARD auto find(std::string_view value) const -> std::optional<InternId>;
+
+  /**
+   * Returns the string of an id, the view stays valid for the lifetime of the interner
+   */
+  NODISCARD auto view(InternId id) const -> std::string_view;
+
+  auto intern(std::string_view value) -> InternId;
+
+  auto seal() -> void { sealed_.store(true, std::memory_order_release); }
+};
@@ -0,0 +1,118 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <unordered_set>
+
+#include "constant.hpp"
+#include "symbol_table.hpp"
+
+/**
+ * Constant type of a declared type seen from scope, null unless it names a c type of a fixed width
+ * C type
+ */
+auto resolve_constant_type(const SymbolTable& table,
+                           ScopeId scope,
+                           const Type& type,
+                           const FilePosition& pos) -> std::optional<ConstantType>;
+
+/**
+ * InterpreterLimits
+ * \brief Bounds of one compile time call, a call that exceeds any of them is left to run
+ *
+ * Steps count every statement and expression evaluated, memory counts the bytes held by the
+ * locals of every live frame.
+ */
+struct InterpreterLimits final {
+  uint64_t steps = 1'000'000;
+  size_t memory  = size_t{1} << 20;
+  uint32_t depth = 256;
+};
+
+/**
+ * Interpreter
+ * \brief Evaluates calls of pure functions with constant arguments at compile time
+ *
+ * Bodies are run straight from the syntax tree. Only arithmetic on parameters, locals and folded
+ * constants is understood, anything else, mutable globals, members, strings or calls of functions
+ * that were not added, fails the call. Purity is so checked on the path the call actually takes.
+ */
+class Interpreter final {
+  using Locals = std::unordered_map<const BaseSyntax*, ConstantValue>;
+
+  struct Frame final {
+    Locals locals;
+    std::optional<ConstantValue> result;
+  };
+
+  enum class Flow {
+    Next,
+    Return,
+    Fail
+  };
+
+  const SymbolTable& table_;
+  const ConstantValueMap& constants_;
+  std::unordered_set<const FunctionDefinition*> functions_;
+  InterpreterLimits limits_;
+
+  uint64_t steps_ = 0;
+  size_t memory_  = 0;
+  uint32_t depth_ = 0;
+
+ public:
+  explicit Interpreter(const SymbolTable& table,
+                       const ConstantValueMap& constants,
+                       InterpreterLimits limits = {})
+      : table_{table},
+        constants_{constants},
+        limits_{limits} {}
+
+  /**
+   * Allows calls of a function, its body must not change while the interpreter is used
+   */
+  auto add_function(const FunctionDefinition& fn) -> void { functions_.insert(&fn); }
+
+  /**
+   * Stops calls of a function, false when it was not added
+   */
+  auto remove_function(const FunctionDefinition& fn) -> bool { return functions_.erase(&fn) != 0; }
+
+  /**
+   * Function called by call, null when it was not added
+   */
+  NODISCARD auto callee(const CallExpression& call) const -> const FunctionDefinition*;
+
+  /**
+   * Result of fn converted to its return type, null when the call can not be evaluated
+   */
+  auto call(const FunctionDefinition& fn, std::span<const ConstantValue> arguments)
+      -> std::optional<ConstantValue>;
+
+ private:
+  auto step() -> bool;
+  auto define(Frame& frame, const BaseSyntax& node, const ConstantValue& value) -> bool;
+  auto bind(const FunctionDefinition& fn,
+            std::span<const ConstantValue> arguments,
+            ScopeId scope,
+            Frame& frame) -> bool;
+
+  auto read(const BaseExpression& identifier, const Frame& frame) const
+      -> std::optional<ConstantValue>;
+  auto write(const BaseExpression& target, const ConstantValue& value, Frame& frame)
+      -> std::optional<ConstantValue>;
+
+  auto eval(const BaseExpression& expr, Frame& frame) -> std::optional<ConstantValue>;
+  auto eval_call(const CallExpression& call, Frame& frame) -> std::optional<ConstantValue>;
+  auto eval_unary(const UnaryExpression& expr, Frame& frame) -> std::optional<ConstantValue>;
+  auto eval_binary(const BinaryExpression& expr, Frame& frame) -> std::optional<ConstantValue>;
+
+  auto exec_variable(const VariableDefinition& var, ScopeId scope, Frame& frame) -> Flow;
+  auto exec_statement(const BaseStatement& stmt, ScopeId scope, Frame& frame) -> Flow;
+  auto exec_block(const StatementBlock& block, ScopeId scope, Frame& frame) -> Flow;
+};
@@ -7,10 +7,32 @@
 #error
 #endif
 
+#include <shared_mutex>
+#include <unordered_set>
 #include <utility>
 
-#include "syntax_tree.hpp"
+#include "constant.hpp"
+#include "dependency_db.hpp"
 
+/**
+ * RetainedSource
+ * \brief An unchanged source whose syntax tree is not materialized, its outputs are kept as is
+ */
+struct RetainedSource final {
+  SourceContext::Pointer source;
+  const SourceRecord* record;
+};
+
+using RetainedSourceCollection = std::vector<RetainedSource>;
+
+/**
+ * NameSpace
+ * \brief Node of the namespace trie, children are indexed by name
+ *
+ * Full and file names are built once from the parent when the node is created. Lookups take a
+ * shared lock on the node and insertions an exclusive one, so parse workers can place trees
+ * concurrently while contention stays limited to siblings.
+ */
 class NameSpace final {
  public:
   using SubSpace = std::unique_ptr<NameSpace>;
@@ -18,52 +40,127 @@ class NameSpace final {
  private:
   NameSpace* parent_ = nullptr;
   std::string name_;
+  std::string full_name_;
+  std::string file_name_;
+
   std::vector<SubSpace> sub_spaces_;
+  std::unordered_map<std::string_view, NameSpace*> sub_space_index_;
+
   std::vector<std::unique_ptr<SyntaxTree>> syntax_trees_;
+  std::vector<RetainedSource> retained_;
+
+  mutable std::shared_mutex mutex_;
 
  public:
-  explicit NameSpace() = default;
+  explicit NameSpace();
 
-  explicit NameSpace(std::string name)
-      : name_{std::move(name)} {}
+  explicit NameSpace(NameSpace& parent, std::string name);
+
+  NameSpace(const NameSpace&)                    = delete;
+  auto operator=(const NameSpace&) -> NameSpace& = delete;
 
   NODISCARD auto& name() const { return name_; }
   NODISCARD auto& sub_spaces() const { return sub_spaces_; }
-  NODISCARD auto& sub_spaces() { return sub_spaces_; }
   NODISCARD auto& trees() const { return syntax_trees_; }
+  NODISCARD auto& retained() const { return retained_; }
 
   NODISCARD auto parent() const { return parent_; }
 
- private:
-  NODISCARD auto full_name_(const std::string_view sep) const {
-    auto full_name = name();
-    for (auto* par = parent(); par != nullptr; par = par->parent()) {
-      if (!par->name().empty()) {
-        full_name.insert(0, sep);
-        full_name.insert(0, par->name());
-      }
-    }
-    return full_name;
-  }
+  NODISCARD auto& full_name() const { return full_name_; }
+  NODISCARD auto& file_name() const { return file_name_; }
 
- public:
-  NODISCARD auto full_name() const { return full_name_("::"); }
-  NODISCARD auto file_name() const { return full_name_(".").append(gen_hdr_file_ext); }
+  /**
+   * Parsed and retained sources of this namespace in path order, independent of which were rebuilt
+   */
+  NODISCARD auto sources() const -> std::vector<const SourceContext*>;
 
-  auto push_sub_space(SubSpace ns) {
-    ns->parent_ = this;
-    sub_spaces_.emplace_back(std::move(ns));
-  }
+  NODISCARD auto find_sub_space(std::string_view name) const -> NameSpace*;
+
+  auto get_or_create_sub_space(std::string_view name) -> NameSpace&;
 
-  auto push_tree(std::unique_ptr<SyntaxTree> tree) { syntax_trees_.emplace_back(std::move(tree)); }
+  auto push_tree(std::unique_ptr<SyntaxTree> tree) -> void;
+  auto push_retained(RetainedSource source) -> void;
+
+  /**
+   * Orders sub spaces by name and sources by path so output does not depend on placement order
+   */
+  auto sort() -> void;
+};
+
+/**
+ * Name of the generated header of a namespace, "A::B" becomes "A.B.hpp"
+ */
+auto namespace_file_name(std::string_view full_name) -> std::string;
+
+class SymbolTable;
+
+/**
+ * SourceUses
+ * \brief Module keys of declarations in other files that the generated outputs of a source use
+ */
+struct SourceUses final {
+  std::vector<std::string> uses;
+
+  // Subset used by the internal header.
+  std::vector<std::string> header_uses;
 };
 
 class ProjectTree final {
   std::unique_ptr<NameSpace> root_;
+  std::unique_ptr<TypeGraph> types_;
+  std::unique_ptr<SymbolTable> symbols_;
+  ConstantValueMap constants_;
+  std::unordered_set<const BaseSyntax*> eliminated_;
+  std::unordered_map<const SourceContext*, SourceUses> uses_;
 
  public:
-  ProjectTree()
-      : root_{std::make_unique<NameSpace>()} {};
+  ProjectTree();
+  ProjectTree(ProjectTree&&) noexcept;
+  ~ProjectTree();
+
+  auto operator=(ProjectTree&&) noexcept -> ProjectTree&;
 
   NODISCARD auto& root() const { return root_; }
+
+  /**
+   * Types of every source, shared by the parse workers and sealed once declarations are collected
+   */
+  NODISCARD auto& types() const { return deref(types_); }
+
+  /**
+   * Symbols of the whole project, null until the tree is checked
+   */
+  NODISCARD auto symbols() const { return symbols_.get(); }
+
+  /**
+   * Values of immutable variables with a constant initializer, empty until constants are folded
+   */
+  NODISCARD auto& constants() const { return constants_; }
+
+  /**
+   * Whether a module level definition was found unreachable and is left out of the outputs
+   */
+  NODISCARD auto is_eliminated(const BaseSyntax& syntax) const {
+    return eliminated_.contains(&syntax);
+  }
+
+  /**
+   * Uses of a parsed or retained source, null until dead code is eliminated
+   */
+  NODISCARD auto uses(const SourceContext& source) const -> const SourceUses* {
+    auto it = uses_.find(&source);
+    return it != uses_.end() ? &it->second : nullptr;
+  }
+
+  auto set_symbols(std::unique_ptr<SymbolTable> symbols) -> void;
+
+  auto set_constants(ConstantValueMap constants) -> void { constants_ = std::move(constants); }
+
+  auto set_eliminated(std::unordered_set<const BaseSyntax*> eliminated) -> void {
+    eliminated_ = std::move(eliminated);
+  }
+
+  auto set_uses(std::unordered_map<const SourceContext*, SourceUses> uses) -> void {
+    uses_ = std::move(uses);
+  }
 };
\ No newline at end of file
@@ -8,61 +8,188 @@
 #endif
 
 #include "project_tree.hpp"
+#include "interner.hpp"
+#include "symbol_file.hpp"
 
-class BaseSymbol {
-  std::string name_;
+using ScopeId                    = uint32_t;
+using SymbolId                   = uint32_t;
 
- public:
-};
+constexpr auto invalid_scope_id  = ~ScopeId{0};
+constexpr auto invalid_symbol_id = ~SymbolId{0};
 
-class IncludeSymbol : public BaseSymbol {
- public:
-  using Pointer = std::unique_ptr<IncludeSymbol>;
+enum class ScopeKind : uint8_t {
+  Namespace,
+  File,
+  Structure,
+  Function,
+  Block
+};
 
- private:
+/**
+ * Scope
+ * \brief Declaration region linked to its enclosing scope
+ *
+ * File scopes also list the namespaces their source imports, these are searched after the scope
+ * itself but are not inherited by the imported namespaces.
+ */
+struct Scope final {
+  ScopeKind kind;
+  ScopeId parent;
+  InternId name;
+  std::vector<ScopeId> imports;
 };
 
-class CTypeSymbol : public BaseSymbol {
- public:
-  using Pointer = std::unique_ptr<CTypeSymbol>;
+/**
+ * Symbol
+ * \brief A declaration, symbols of retained sources have no syntax node
+ */
+struct Symbol final {
+  SymbolKind kind;
+  AccessModifier access;
+  bool is_mutable;
 
- private:
-};
+  // Parameter count of functions.
+  uint16_t arity;
 
-class VariableSymbol : public BaseSymbol {
- public:
-  using Pointer = std::unique_ptr<VariableSymbol>;
+  InternId name;
+  ScopeId scope;
 
- private:
-  std::string type_;
-};
+  // Declared type, return type of functions or aliased C type of c types, null when deduced.
+  const Type* type;
 
-class StructSymbol : public BaseSymbol {
- public:
-  using Pointer = std::unique_ptr<StructSymbol>;
+  const BaseSyntax* syntax;
 
- private:
-  std::string type_;
+  // Parameter types of functions without syntax, parsed from their exported signature.
+  std::vector<const Type*> parameters = {};
 };
 
-class SymbolSpace : public BaseSymbol {
- public:
-  using Pointer = std::unique_ptr<SymbolSpace>;
-
- private:
-  std::vector<IncludeSymbol::Pointer> includes_;
-  std::vector<CTypeSymbol::Pointer> ctypes_;
-  std::vector<VariableSymbol::Pointer> variables_;
-  std::vector<StructSymbol::Pointer> structs_;
+using SymbolLink = std::pair<const BaseSyntax*, SymbolId>;
+
+/**
+ * DeclarationBatch
+ * \brief Declarations of one source, collected without touching the shared table
+ *
+ * Scope ids inside a batch are local to it, the first scope is the file scope and its parent is
+ * the enclosing namespace. Module symbols already refer to namespace scopes of the table.
+ */
+struct DeclarationBatch final {
+  const SourceContext* source = nullptr;
+  ScopeId parent              = invalid_scope_id;
+
+  std::vector<Scope> scopes;
+  std::vector<Symbol> symbols;
+  std::vector<Symbol> module_symbols;
+  std::vector<std::pair<const BaseSyntax*, ScopeId>> bindings;
+
+  // Names the source refers to by identifier, call or type, declarations of references are looked
+  // up for these alone.
+  std::vector<InternId> uses;
+
+  // A retained record holds an export that is not a valid declaration.
+  bool corrupt = false;
 };
 
-class SymbolTable {
+/**
+ * SymbolTable
+ * \brief Flat store of every declared symbol keyed by interned (scope, name) pairs
+ *
+ * Symbols and scopes live in contiguous vectors and are referred to by index. The index is an open
+ * addressing table with linear probing over packed keys, so a lookup in one scope is a hash and a
+ * short probe, resolution walks the parent links from the innermost scope outwards.
+ *
+ * The table is filled in two steps. Namespace scopes are created first, then the declarations of
+ * every source are collected in parallel and merged. Once sealed the table is read only and may
+ * be queried from any number of threads without locking.
+ */
+class SymbolTable final {
  public:
   using Pointer = std::unique_ptr<SymbolTable>;
 
  private:
-  std::string project_name_;
+  StringInterner names_;
+
+  std::vector<Scope> scopes_;
+  std::vector<Symbol> symbols_;
+  std::vector<SymbolId> slots_;
+
+  std::unordered_map<InternId, ScopeId> namespace_scopes_;
+  std::unordered_map<const BaseSyntax*, ScopeId> syntax_scopes_;
+  std::unordered_map<const BaseSyntax*, SymbolId> links_;
 
  public:
-  static auto from_project_tree() -> Pointer;
+  SymbolTable();
+
+  SymbolTable(const SymbolTable&)                    = delete;
+  auto operator=(const SymbolTable&) -> SymbolTable& = delete;
+
+  NODISCARD auto& names() const { return names_; }
+  NODISCARD auto& names() { return names_; }
+  NODISCARD auto& scopes() const { return scopes_; }
+  NODISCARD auto& symbols() const { return symbols_; }
+
+  NODISCARD auto global_scope() const -> ScopeId { return 0; }
+
+  NODISCARD auto& scope(ScopeId id) const { return scopes_[id]; }
+  NODISCARD auto& symbol(SymbolId id) const { return symbols_[id]; }
+
+  /**
+   * Scope opened by a function or block, invalid for nodes that do not open one
+   */
+  NODISCARD auto scope_of(const BaseSyntax& syntax) const -> ScopeId;
+
+  NODISCARD auto namespace_scope(std::string_view full_name) const -> ScopeId;
+
+  /**
+   * Symbol declared directly in scope, parents are not searched
+   */
+  NODISCARD auto find(ScopeId scope, InternId name) const -> SymbolId;
+
+  /**
+   * Innermost visible declaration of name, locals declared after pos are skipped
+   */
+  NODISCARD auto resolve(ScopeId scope, std::string_view name, const FilePosition& pos) const
+      -> SymbolId;
+
+  NODISCARD auto linked(const BaseSyntax& syntax) const -> SymbolId;
+
+  auto add_scope(ScopeKind kind, ScopeId parent, InternId name = invalid_intern_id) -> ScopeId;
+  auto add_namespace_scope(ScopeId parent, std::string_view name, std::string_view full_name)
+      -> ScopeId;
+
+  /**
+   * Adds a symbol, returns the existing one when the scope already declares the name
+   */
+  auto declare(const Symbol& symbol) -> std::pair<SymbolId, bool>;
+
+  /**
+   * Appends the scopes and symbols of a batch, duplicate declarations are reported as errors
+   */
+  auto merge(const DeclarationBatch& batch) -> bool;
+
+  auto merge_links(std::span<const SymbolLink> links) -> void;
+
+  auto seal() -> void { names_.seal(); }
+
+  /**
+   * Collects the declarations of every source on jobs workers and seals the table
+   *
+   * Public symbols of referenced projects are looked up in their mapped tables once the sources
+   * are merged, only for names a source uses or declares at module level. They are declared into
+   * namespace scopes shared with the project, so a clash is reported against the reference.
+   */
+  static auto from_project_tree(const ProjectTree& project,
+                                std::span<const SymbolFile::ConstPointer> references = {},
+                                uint32_t jobs = 0) -> Pointer;
+
+ private:
+  auto grow() -> void;
 };
+
+/**
+ * Checks every function body against the sealed table on jobs workers, errors are reported in
+ * source order
+ *
+ * Unresolved calls that see a C include are left to the C++ compiler with a warning, unless a
+ * function of that name is declared out of reach of the call.
+ */
+auto check_bodies(SymbolTable& table, const ProjectTree& project, uint32_t jobs = 0) -> bool;
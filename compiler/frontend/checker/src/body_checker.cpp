@@ -0,0 +1,332 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "symbol_table.hpp"
+#include "parallel.hpp"
+#include "profiler.hpp"
+
+#include <sstream>
+#include <unordered_set>
+
+/**
+ * CheckItem
+ * \brief A function or initialized module variable, checked independently of all others
+ */
+struct CheckItem final {
+  const BaseSyntax* node;
+  const SourceContext* source;
+  ScopeId scope;
+};
+
+struct Diagnostic final {
+  size_t item;
+  std::string message;
+};
+
+/**
+ * UnresolvedCall
+ * \brief A call left to the C++ compiler, warned about once per name
+ */
+struct UnresolvedCall final {
+  size_t item;
+  std::string name;
+  std::string position;
+};
+
+/**
+ * CheckBuffer
+ * \brief Results of one worker, merged into the table once every worker is done
+ */
+struct CheckBuffer final {
+  std::vector<SymbolLink> links;
+  std::vector<Diagnostic> diagnostics;
+  std::vector<UnresolvedCall> unresolved;
+};
+
+/**
+ * BodyChecker
+ * \brief Resolves names and types and checks mutability and call arity, the table is never written
+ */
+class BodyChecker final {
+  const SymbolTable& table_;
+  const std::vector<bool>& cinclude_scopes_;
+  const std::vector<bool>& function_names_;
+  CheckBuffer& buffer_;
+
+  size_t item_                 = 0;
+  const SourceContext* source_ = nullptr;
+
+ public:
+  explicit BodyChecker(const SymbolTable& table,
+                       const std::vector<bool>& cinclude_scopes,
+                       const std::vector<bool>& function_names,
+                       CheckBuffer& buffer)
+      : table_{table},
+        cinclude_scopes_{cinclude_scopes},
+        function_names_{function_names},
+        buffer_{buffer} {}
+
+  auto check(size_t index, const CheckItem& item) -> void {
+    item_   = index;
+    source_ = item.source;
+    check_node(*item.node, item.scope);
+  }
+
+ private:
+  NODISCARD auto position(const BaseSyntax& node) const -> std::string {
+    auto stream = std::ostringstream{};
+    stream << deref(source_).rel_path().string() << ' ' << node.pos();
+    return stream.str();
+  }
+
+  auto report(const BaseSyntax& node, std::string_view message) -> void {
+    auto stream = std::ostringstream{};
+    stream << "Error : " << message << ' ' << position(node);
+    buffer_.diagnostics.push_back({item_, stream.str()});
+  }
+
+  // C includes may declare functions the checker cannot see, calls are left to the C++ compiler.
+  NODISCARD auto sees_cinclude(ScopeId scope) const -> bool {
+    for (; scope != invalid_scope_id; scope = table_.scope(scope).parent) {
+      if (cinclude_scopes_[scope]) {
+        return true;
+      }
+      for (auto imported : table_.scope(scope).imports) {
+        if (cinclude_scopes_[imported]) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  NODISCARD auto names_function(std::string_view name) const -> bool {
+    const auto id = table_.names().find(name);
+    return id && *id < function_names_.size() && function_names_[*id];
+  }
+
+  auto link_name(const BaseSyntax& node, const std::string& name, ScopeId scope, bool call)
+      -> SymbolId {
+    const auto symbol = table_.resolve(scope, name, node.pos());
+    if (symbol != invalid_symbol_id) {
+      buffer_.links.emplace_back(&node, symbol);
+    } else if (!call || !sees_cinclude(scope)) {
+      report(node, std::string{"Unknown identifier \""}.append(name).append("\""));
+    } else if (names_function(name)) {
+      // A Typhon function of that name exists but is out of reach, no C header stands in for it.
+      report(node, std::string{"Function \""}.append(name).append("\" is not visible"));
+    } else {
+      buffer_.unresolved.push_back({item_, name, position(node)});
+    }
+    return symbol;
+  }
+
+  auto check_call(const CallExpression& call, ScopeId scope) -> void {
+    const auto id = link_name(call, call.identifier(), scope, true);
+    if (id == invalid_symbol_id) {
+      return;
+    }
+
+    auto& symbol = table_.symbol(id);
+    if (symbol.kind == SymbolKind::Function && symbol.arity != call.parameters().size()) {
+      auto message = std::ostringstream{};
+      message << "Function \"" << call.identifier() << "\" expects " << symbol.arity
+              << " arguments, got " << call.parameters().size();
+      report(call, message.str());
+    }
+  }
+
+  // Only plain names are checked, members depend on the type of their owner.
+  auto check_target(const BaseExpression& target, ScopeId scope) -> void {
+    if (target.kind() != SyntaxKind::ExprIdentifier) {
+      check_node(target, scope);
+      return;
+    }
+
+    auto& name    = ref_cast<const IdentifierExpression>(target).identifier();
+    const auto id = link_name(target, name, scope, false);
+    if (id == invalid_symbol_id) {
+      return;
+    }
+
+    auto& symbol = table_.symbol(id);
+    if (symbol.kind != SymbolKind::Variable && symbol.kind != SymbolKind::Parameter) {
+      report(target, std::string{"Cannot assign to \""}.append(name).append("\""));
+    } else if (!symbol.is_mutable) {
+      report(target, std::string{"Cannot assign to immutable \""}.append(name).append("\""));
+    }
+  }
+
+  // Named types must resolve to a c type, struct or object, composite types are checked through.
+  auto check_type(const BaseSyntax& node, const Type* type, ScopeId scope) -> void {
+    if (type == nullptr) {
+      return;
+    }
+
+    if (type->kind() != TypeKind::Named) {
+      check_type(node, type->element(), scope);
+      for (auto* argument : type->arguments()) {
+        check_type(node, argument, scope);
+      }
+      if (type->kind() != TypeKind::Generic) {
+        return;
+      }
+    }
+
+    const auto id = table_.resolve(scope, type->name(), node.pos());
+    if (id == invalid_symbol_id) {
+      report(node, std::string{"Unknown type \""}.append(type->name()).append("\""));
+      return;
+    }
+
+    const auto kind = table_.symbol(id).kind;
+    if (kind != SymbolKind::CType && kind != SymbolKind::Struct && kind != SymbolKind::Object) {
+      report(node, std::string{"\""}.append(type->name()).append("\" is not a type"));
+    }
+  }
+
+  auto check_node(const BaseSyntax& node, ScopeId scope) -> void {
+    if (auto inner = table_.scope_of(node); inner != invalid_scope_id) {
+      scope = inner;
+    }
+
+    switch (node.kind()) {
+      case SyntaxKind::DefVar: {
+        check_type(node, ref_cast<const VariableDefinition>(node).type(), scope);
+        break;
+      }
+      case SyntaxKind::DefParam: {
+        check_type(node, ref_cast<const FunctionParameter>(node).type(), scope);
+        break;
+      }
+      case SyntaxKind::DefFunc: {
+        check_type(node, ref_cast<const FunctionDefinition>(node).return_type(), scope);
+        break;
+      }
+      case SyntaxKind::ExprIdentifier: {
+        link_name(node, ref_cast<const IdentifierExpression>(node).identifier(), scope, false);
+        return;
+      }
+      case SyntaxKind::ExprCall: {
+        check_call(ref_cast<const CallExpression>(node), scope);
+        break;
+      }
+      case SyntaxKind::ExprUnary: {
+        auto& expr = ref_cast<const UnaryExpression>(node);
+        if (is_increment(expr.op()) && expr.expr()) {
+          check_target(*expr.expr(), scope);
+          return;
+        }
+        break;
+      }
+      case SyntaxKind::ExprBinary: {
+        auto& expr = ref_cast<const BinaryExpression>(node);
+
+        // Qualified names are not resolved yet, members depend on the type of the left hand side.
+        if (expr.op() == Operator::Static) {
+          return;
+        }
+        if (expr.op() == Operator::Access) {
+          if (expr.lhs()) {
+            check_node(*expr.lhs(), scope);
+          }
+          return;
+        }
+        if (is_assignment(expr.op()) && expr.lhs()) {
+          check_target(*expr.lhs(), scope);
+          if (expr.rhs()) {
+            check_node(*expr.rhs(), scope);
+          }
+          return;
+        }
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+    for_each_child(node, [&](const BaseSyntax& child) { check_node(child, scope); });
+  }
+};
+
+auto collect_items(const SymbolTable& table,
+                   const SourceContext* source,
+                   const BaseStructureDefinition& structure,
+                   ScopeId scope,
+                   std::vector<CheckItem>& items) -> void {
+  for (auto& pvar : structure.variables()) {
+    if (pvar->is_assigned()) {
+      items.push_back({pvar.get(), source, scope});
+    }
+  }
+  for (auto& pstruct : structure.structs()) {
+    collect_items(table, source, *pstruct, table.scope_of(*pstruct), items);
+  }
+  for (auto& pobject : structure.objects()) {
+    collect_items(table, source, *pobject, table.scope_of(*pobject), items);
+  }
+  for (auto& pfn : structure.functions()) {
+    items.push_back({pfn.get(), source, scope});
+  }
+}
+
+auto collect_items(const SymbolTable& table, const NameSpace& ns, std::vector<CheckItem>& items)
+    -> void {
+  for (auto& tree : ns.trees()) {
+    collect_items(table, tree->source().get(), *tree, table.scope_of(*tree), items);
+  }
+  for (auto& sub_space : ns.sub_spaces()) {
+    collect_items(table, deref(sub_space), items);
+  }
+}
+
+auto check_bodies(SymbolTable& table, const ProjectTree& project, uint32_t jobs) -> bool {
+  PROFILE_SCOPE("Check Bodies");
+  assert(table.names().sealed());
+
+  auto items = std::vector<CheckItem>{};
+  collect_items(table, deref(project.root()), items);
+
+  auto cinclude_scopes = std::vector<bool>(table.scopes().size());
+  auto function_names  = std::vector<bool>(table.names().size());
+  for (auto& symbol : table.symbols()) {
+    if (symbol.kind == SymbolKind::CInclude) {
+      cinclude_scopes[symbol.scope] = true;
+    } else if (symbol.kind == SymbolKind::Function) {
+      function_names[symbol.name] = true;
+    }
+  }
+
+  // Each worker writes only to its own buffer, lookups go to the sealed table without locking.
+  auto buffers = std::vector<CheckBuffer>(worker_count(jobs, items.size()));
+  parallel_for(items.size(), jobs, [&](size_t worker, size_t i) {
+    auto checker = BodyChecker{table, cinclude_scopes, function_names, buffers[worker]};
+    checker.check(i, items[i]);
+  });
+
+  auto diagnostics = std::vector<Diagnostic>{};
+  auto unresolved  = std::vector<UnresolvedCall>{};
+  for (auto& buffer : buffers) {
+    table.merge_links(buffer.links);
+    std::move(buffer.diagnostics.begin(), buffer.diagnostics.end(),
+              std::back_inserter(diagnostics));
+    std::move(buffer.unresolved.begin(), buffer.unresolved.end(), std::back_inserter(unresolved));
+  }
+
+  std::stable_sort(unresolved.begin(), unresolved.end(),
+                   [](auto& lhs, auto& rhs) { return lhs.item < rhs.item; });
+  auto warned = std::unordered_set<std::string>{};
+  for (auto& call : unresolved) {
+    if (warned.insert(call.name).second) {
+      std::cerr << "Warning : Call to undeclared \"" << call.name
+                << "\" is left to the C++ compiler " << call.position << std::endl;
+    }
+  }
+
+  std::stable_sort(diagnostics.begin(), diagnostics.end(),
+                   [](auto& lhs, auto& rhs) { return lhs.item < rhs.item; });
+  for (auto& diagnostic : diagnostics) {
+    std::cerr << diagnostic.message << std::endl;
+  }
+  return diagnostics.empty();
+}
@@ -2,9 +2,12 @@
 // All Rights Reserved.
 
 #include "checker.hpp"
+#include "symbol_table.hpp"
 #include "timer.hpp"
+#include "profiler.hpp"
 
-auto place_tree(const ProjectTree& project, std::unique_ptr<SyntaxTree> tree) {
+auto place_tree(const ProjectTree& project, std::unique_ptr<SyntaxTree> tree) -> void {
+  PROFILE_SCOPE("Place", deref(tree->source()).rel_path());
   auto current_namespace = project.root().get();
 
   // If syntax trees doesn't specify a namespace place at root namespace
@@ -18,41 +21,48 @@ auto place_tree(const ProjectTree& project, std::unique_ptr<SyntaxTree> tree) {
     return;
   }
 
+  // Find namespace in project tree
   for (auto& ns : tree_namespace->namespaces()) {
-    auto& sub_spaces = current_namespace->sub_spaces();
-
-    // Find namespace in project tree
-    auto desired_ns = std::find_if(sub_spaces.begin(), sub_spaces.end(), [=](auto& sub_ns) -> bool {
-      return sub_ns->name() == ns;
-    });
-
-    if (desired_ns != sub_spaces.end()) {
-      current_namespace = desired_ns->get();
-    } else {
-      auto new_space = std::make_unique<NameSpace>(ns);
-      auto* temp     = new_space.get();
-      current_namespace->push_sub_space(std::move(new_space));
-      current_namespace = temp;
-    }
+    current_namespace = &current_namespace->get_or_create_sub_space(ns);
   }
 
   current_namespace->push_tree(std::move(tree));
 }
 
-auto place_syntax_trees_into_project(const ProjectTree& project,
-                                     SyntaxTreeCollection& syntax_trees) {
-  for (auto& tree : syntax_trees) {
-    place_tree(project, std::move(tree));
+constexpr auto namespace_seperator = std::string_view{"::"};
+
+auto place_retained(const ProjectTree& project, RetainedSource retained) {
+  auto* current_namespace = project.root().get();
+
+  auto name               = std::string_view{deref(retained.record).name_space};
+  while (!name.empty()) {
+    const auto split  = name.find(namespace_seperator);
+    current_namespace = &current_namespace->get_or_create_sub_space(name.substr(0, split));
+    name              = split == std::string_view::npos
+                            ? std::string_view{}
+                            : name.substr(split + namespace_seperator.size());
   }
+
+  current_namespace->push_retained(std::move(retained));
 }
 
-auto check(SyntaxTreeCollection& syntax_trees) -> ProjectTree {
-  auto project_tree = ProjectTree{};
+auto check(ProjectTree& project_tree,
+           RetainedSourceCollection retained,
+           std::span<const SymbolFile::ConstPointer> references,
+           uint32_t jobs) -> void {
+  TRACE_TIMER("Checker");
+  PROFILE_SCOPE("Check");
 
-  {
-    TRACE_TIMER("Checker");
-    place_syntax_trees_into_project(project_tree, syntax_trees);
+  for (auto& source : retained) {
+    place_retained(project_tree, std::move(source));
   }
 
-  return project_tree;
-}
\ No newline at end of file
+  deref(project_tree.root()).sort();
+
+  // Declarations of every source are known before any body is checked.
+  auto symbols = SymbolTable::from_project_tree(project_tree, references, jobs);
+  if (!check_bodies(*symbols, project_tree, jobs)) {
+    exit(-1);
+  }
+  project_tree.set_symbols(std::move(symbols));
+}
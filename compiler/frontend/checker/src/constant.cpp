@@ -0,0 +1,538 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "constant.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+const auto c_constant_type_map = std::unordered_map<std::string_view, ConstantType>{
+    {"bool",     ConstantType::Bool},
+
+    {"int8_t",   ConstantType::I8  },
+    {"int16_t",  ConstantType::I16 },
+    {"int32_t",  ConstantType::I32 },
+    {"int64_t",  ConstantType::I64 },
+
+    {"uint8_t",  ConstantType::U8  },
+    {"uint16_t", ConstantType::U16 },
+    {"uint32_t", ConstantType::U32 },
+    {"uint64_t", ConstantType::U64 },
+
+    {"float",    ConstantType::F32 },
+    {"double",   ConstantType::F64 },
+};
+
+auto constant_type_of(std::string_view c_name) -> std::optional<ConstantType> {
+  if (auto type = c_constant_type_map.find(c_name); type != c_constant_type_map.end()) {
+    return type->second;
+  }
+  return std::nullopt;
+}
+
+auto to_bits(const ConstantValue& constant) -> uint64_t {
+  if (auto* value = std::get_if<int64_t>(&constant.value)) {
+    return static_cast<uint64_t>(*value);
+  }
+  if (auto* value = std::get_if<uint64_t>(&constant.value)) {
+    return *value;
+  }
+  return std::get<bool>(constant.value) ? 1 : 0;
+}
+
+// Two's complement bits wrapped to the width of an integer type.
+auto from_bits(ConstantType type, uint64_t bits) -> ConstantValue {
+  const auto width = bit_width(type);
+  if (width < 64) {
+    bits &= (uint64_t{1} << width) - 1;
+  }
+  if (is_unsigned(type)) {
+    return {type, bits};
+  }
+  if (width < 64 && ((bits >> (width - 1)) & 1) != 0) {
+    bits |= ~uint64_t{0} << width;
+  }
+  return {type, static_cast<int64_t>(bits)};
+}
+
+auto to_double(const ConstantValue& constant) -> double {
+  if (auto* value = std::get_if<double>(&constant.value)) {
+    return *value;
+  }
+  if (auto* value = std::get_if<int64_t>(&constant.value)) {
+    return static_cast<double>(*value);
+  }
+  if (auto* value = std::get_if<uint64_t>(&constant.value)) {
+    return static_cast<double>(*value);
+  }
+  return std::get<bool>(constant.value) ? 1.0 : 0.0;
+}
+
+auto to_bool(const ConstantValue& constant) -> bool {
+  if (auto* value = std::get_if<double>(&constant.value)) {
+    return *value != 0.0;
+  }
+  return to_bits(constant) != 0;
+}
+
+auto convert(const ConstantValue& constant, ConstantType type) -> std::optional<ConstantValue> {
+  if (constant.type == type) {
+    return constant;
+  }
+  if (type == ConstantType::Bool) {
+    return ConstantValue{type, to_bool(constant)};
+  }
+
+  if (is_floating(type)) {
+    auto value = to_double(constant);
+    if (type == ConstantType::F32) {
+      const auto narrowed = static_cast<double>(static_cast<float>(value));
+      if (std::isfinite(value) && !std::isfinite(narrowed)) {
+        return std::nullopt;
+      }
+      value = narrowed;
+    }
+    return ConstantValue{type, value};
+  }
+
+  if (!is_floating(constant.type)) {
+    return from_bits(type, to_bits(constant));
+  }
+
+  // Floating values are truncated, values out of range of the integer are undefined.
+  const auto value = std::trunc(std::get<double>(constant.value));
+  const auto width = static_cast<int>(bit_width(type));
+  const auto low   = is_signed(type) ? -std::ldexp(1.0, width - 1) : 0.0;
+  const auto high  = std::ldexp(1.0, is_signed(type) ? width - 1 : width);
+  if (!(value >= low && value < high)) {
+    return std::nullopt;
+  }
+  if (is_signed(type)) {
+    return from_bits(type, static_cast<uint64_t>(static_cast<int64_t>(value)));
+  }
+  return from_bits(type, static_cast<uint64_t>(value));
+}
+
+// Signed results must be representable, overflow is undefined in C++.
+auto make_signed(ConstantType type, int64_t value) -> std::optional<ConstantValue> {
+  if (type == ConstantType::I32 && (value < std::numeric_limits<int32_t>::min() ||
+                                    value > std::numeric_limits<int32_t>::max())) {
+    return std::nullopt;
+  }
+  return ConstantValue{type, value};
+}
+
+auto evaluate_signed(Operator op, ConstantType type, int64_t lhs, int64_t rhs)
+    -> std::optional<ConstantValue> {
+  constexpr auto min = std::numeric_limits<int64_t>::min();
+  constexpr auto max = std::numeric_limits<int64_t>::max();
+
+  switch (op) {
+    case Operator::Add: {
+      if ((rhs > 0 && lhs > max - rhs) || (rhs < 0 && lhs < min - rhs)) {
+        return std::nullopt;
+      }
+      return make_signed(type, lhs + rhs);
+    }
+    case Operator::Subtract: {
+      if ((rhs < 0 && lhs > max + rhs) || (rhs > 0 && lhs < min + rhs)) {
+        return std::nullopt;
+      }
+      return make_signed(type, lhs - rhs);
+    }
+    case Operator::Multiply: {
+      if (lhs == 0 || rhs == 0) {
+        return make_signed(type, 0);
+      }
+      if ((lhs == -1 && rhs == min) || (rhs == -1 && lhs == min)) {
+        return std::nullopt;
+      }
+      const auto product =
+          static_cast<int64_t>(static_cast<uint64_t>(lhs) * static_cast<uint64_t>(rhs));
+      if (product / rhs != lhs) {
+        return std::nullopt;
+      }
+      return make_signed(type, product);
+    }
+    case Operator::Divide: {
+      if (rhs == 0 || (lhs == min && rhs == -1)) {
+        return std::nullopt;
+      }
+      return make_signed(type, lhs / rhs);
+    }
+    default: {
+      return std::nullopt;
+    }
+  }
+}
+
+auto evaluate_unsigned(Operator op, ConstantType type, uint64_t lhs, uint64_t rhs)
+    -> std::optional<ConstantValue> {
+  switch (op) {
+    case Operator::Add: {
+      return from_bits(type, lhs + rhs);
+    }
+    case Operator::Subtract: {
+      return from_bits(type, lhs - rhs);
+    }
+    case Operator::Multiply: {
+      return from_bits(type, lhs * rhs);
+    }
+    case Operator::Divide: {
+      if (rhs == 0) {
+        return std::nullopt;
+      }
+      return from_bits(type, lhs / rhs);
+    }
+    default: {
+      return std::nullopt;
+    }
+  }
+}
+
+template <typename T>
+auto evaluate_floating(Operator op, ConstantType type, T lhs, T rhs)
+    -> std::optional<ConstantValue> {
+  auto result = T{};
+  switch (op) {
+    case Operator::Add: {
+      result = lhs + rhs;
+      break;
+    }
+    case Operator::Subtract: {
+      result = lhs - rhs;
+      break;
+    }
+    case Operator::Multiply: {
+      result = lhs * rhs;
+      break;
+    }
+    case Operator::Divide: {
+      if (rhs == T{0}) {
+        return std::nullopt;
+      }
+      result = lhs / rhs;
+      break;
+    }
+    default: {
+      return std::nullopt;
+    }
+  }
+
+  if (!std::isfinite(result)) {
+    return std::nullopt;
+  }
+  return ConstantValue{type, static_cast<double>(result)};
+}
+
+template <typename T>
+auto compare(Operator op, T lhs, T rhs) -> std::optional<ConstantValue> {
+  auto result = false;
+  switch (op) {
+    case Operator::Equals: {
+      result = lhs == rhs;
+      break;
+    }
+    case Operator::NotEquals: {
+      result = lhs != rhs;
+      break;
+    }
+    case Operator::LessThan: {
+      result = lhs < rhs;
+      break;
+    }
+    case Operator::GreaterThan: {
+      result = lhs > rhs;
+      break;
+    }
+    case Operator::LessThanEquals: {
+      result = lhs <= rhs;
+      break;
+    }
+    case Operator::GreaterThanEquals: {
+      result = lhs >= rhs;
+      break;
+    }
+    default: {
+      return std::nullopt;
+    }
+  }
+  return ConstantValue{ConstantType::Bool, result};
+}
+
+auto evaluate_bitwise(Operator op, ConstantType type, uint64_t lhs, uint64_t rhs)
+    -> std::optional<ConstantValue> {
+  switch (op) {
+    case Operator::BitOr: {
+      return from_bits(type, lhs | rhs);
+    }
+    case Operator::BitXor: {
+      return from_bits(type, lhs ^ rhs);
+    }
+    case Operator::BitAnd: {
+      return from_bits(type, lhs & rhs);
+    }
+    default: {
+      return std::nullopt;
+    }
+  }
+}
+
+// The result has the promoted type of the left operand, counts outside its width are undefined.
+auto evaluate_shift(Operator op, const ConstantValue& lhs, const ConstantValue& rhs)
+    -> std::optional<ConstantValue> {
+  const auto type = promote(lhs.type);
+  if (is_floating(type) || is_floating(rhs.type)) {
+    return std::nullopt;
+  }
+
+  const auto count = convert(rhs, promote(rhs.type));
+  if (is_signed(count->type) && std::get<int64_t>(count->value) < 0) {
+    return std::nullopt;
+  }
+  const auto shift = to_bits(*count);
+  if (shift >= bit_width(type)) {
+    return std::nullopt;
+  }
+
+  const auto value = convert(lhs, type);
+  if (op == Operator::ShiftLeft) {
+    return from_bits(type, to_bits(*value) << shift);
+  }
+  if (is_signed(type)) {
+    return ConstantValue{type, std::get<int64_t>(value->value) >> shift};
+  }
+  return ConstantValue{type, std::get<uint64_t>(value->value) >> shift};
+}
+
+auto evaluate(Operator op, const ConstantValue& operand) -> std::optional<ConstantValue> {
+  if (op == Operator::BoolNot) {
+    return ConstantValue{ConstantType::Bool, !to_bool(operand)};
+  }
+
+  const auto type  = promote(operand.type);
+  const auto value = convert(operand, type);
+  switch (op) {
+    case Operator::Positive: {
+      return value;
+    }
+    case Operator::Negative: {
+      if (is_floating(type)) {
+        return ConstantValue{type, -std::get<double>(value->value)};
+      }
+      if (is_unsigned(type)) {
+        return from_bits(type, 0 - to_bits(*value));
+      }
+      return evaluate_signed(Operator::Subtract, type, 0, std::get<int64_t>(value->value));
+    }
+    case Operator::BitNot: {
+      if (is_floating(type)) {
+        return std::nullopt;
+      }
+      return from_bits(type, ~to_bits(*value));
+    }
+    default: {
+      return std::nullopt;
+    }
+  }
+}
+
+auto evaluate(Operator op, const ConstantValue& lhs, const ConstantValue& rhs)
+    -> std::optional<ConstantValue> {
+  switch (op) {
+    case Operator::And: {
+      return ConstantValue{ConstantType::Bool, to_bool(lhs) && to_bool(rhs)};
+    }
+    case Operator::Or: {
+      return ConstantValue{ConstantType::Bool, to_bool(lhs) || to_bool(rhs)};
+    }
+    case Operator::ShiftLeft:
+    case Operator::ShiftRight: {
+      return evaluate_shift(op, lhs, rhs);
+    }
+    default: {
+      break;
+    }
+  }
+
+  const auto precedence = get_precedence(op);
+  if (get_operator_type(op) != OperatorType::Binary || precedence == Precedence::Assignment ||
+      precedence == Precedence::Access) {
+    return std::nullopt;
+  }
+
+  const auto type  = common_type(lhs.type, rhs.type);
+  const auto left  = convert(lhs, type);
+  const auto right = convert(rhs, type);
+  if (!left || !right) {
+    return std::nullopt;
+  }
+
+  if (precedence == Precedence::Equality || precedence == Precedence::Relation) {
+    if (is_floating(type)) {
+      return compare(op, std::get<double>(left->value), std::get<double>(right->value));
+    }
+    if (is_signed(type)) {
+      return compare(op, std::get<int64_t>(left->value), std::get<int64_t>(right->value));
+    }
+    return compare(op, std::get<uint64_t>(left->value), std::get<uint64_t>(right->value));
+  }
+
+  if (precedence == Precedence::BitOr || precedence == Precedence::BitXor ||
+      precedence == Precedence::BitAnd) {
+    if (is_floating(type)) {
+      return std::nullopt;
+    }
+    return evaluate_bitwise(op, type, to_bits(*left), to_bits(*right));
+  }
+
+  switch (type) {
+    case ConstantType::F32: {
+      return evaluate_floating(op, type, static_cast<float>(std::get<double>(left->value)),
+                               static_cast<float>(std::get<double>(right->value)));
+    }
+    case ConstantType::F64: {
+      return evaluate_floating(op, type, std::get<double>(left->value),
+                               std::get<double>(right->value));
+    }
+    case ConstantType::I32:
+    case ConstantType::I64: {
+      return evaluate_signed(op, type, std::get<int64_t>(left->value),
+                             std::get<int64_t>(right->value));
+    }
+    default: {
+      return evaluate_unsigned(op, type, to_bits(*left), to_bits(*right));
+    }
+  }
+}
+
+constexpr auto is_suffix_char(char c) -> bool { return c == 'u' || c == 'l' || c == 'f'; }
+
+// Literals are decimal, suffixed as written by to_literal and negative ones are parenthesized.
+auto parse_literal(std::string_view literal) -> std::optional<ConstantValue> {
+  auto negative = false;
+  if (literal.starts_with("(-") && literal.ends_with(")")) {
+    negative = true;
+    literal  = literal.substr(2, literal.size() - 3);
+  }
+
+  auto suffix_start = literal.size();
+  while (suffix_start > 0 && is_suffix_char(literal[suffix_start - 1])) {
+    --suffix_start;
+  }
+  const auto suffix = literal.substr(suffix_start);
+  const auto digits = literal.substr(0, suffix_start);
+  const auto* first = digits.data();
+  const auto* last  = digits.data() + digits.size();
+
+  auto constant = std::optional<ConstantValue>{};
+  if (digits.find_first_of(".e") != std::string_view::npos) {
+    if (suffix == "f") {
+      auto value        = 0.0f;
+      const auto result = std::from_chars(first, last, value);
+      if (result.ec == std::errc{} && result.ptr == last) {
+        constant = ConstantValue{ConstantType::F32, static_cast<double>(value)};
+      }
+    } else if (suffix.empty()) {
+      auto value        = 0.0;
+      const auto result = std::from_chars(first, last, value);
+      if (result.ec == std::errc{} && result.ptr == last) {
+        constant = ConstantValue{ConstantType::F64, value};
+      }
+    }
+  } else {
+    auto value        = uint64_t{0};
+    const auto result = std::from_chars(first, last, value);
+    if (digits.empty() || result.ec != std::errc{} || result.ptr != last) {
+      return std::nullopt;
+    }
+
+    constexpr auto int32_max  = static_cast<uint64_t>(std::numeric_limits<int32_t>::max());
+    constexpr auto int64_max  = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    constexpr auto uint32_max = uint64_t{std::numeric_limits<uint32_t>::max()};
+    if (suffix.empty() && value <= int64_max) {
+      const auto type = value <= int32_max ? ConstantType::I32 : ConstantType::I64;
+      constant        = ConstantValue{type, static_cast<int64_t>(value)};
+    } else if (suffix == "ll" && value <= int64_max) {
+      constant = ConstantValue{ConstantType::I64, static_cast<int64_t>(value)};
+    } else if (suffix == "u") {
+      constant = ConstantValue{value <= uint32_max ? ConstantType::U32 : ConstantType::U64, value};
+    } else if (suffix == "ull") {
+      constant = ConstantValue{ConstantType::U64, value};
+    }
+  }
+
+  if (!constant || !negative) {
+    return constant;
+  }
+  return evaluate(Operator::Negative, *constant);
+}
+
+template <typename T>
+auto format_floating(T value) -> std::string {
+  auto buffer       = std::array<char, 64>{};
+  const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+  auto text         = std::string{buffer.data(), result.ptr};
+  if (text.find_first_of(".e") == std::string::npos) {
+    text.append(".0");
+  }
+  return text;
+}
+
+auto to_literal(const ConstantValue& constant) -> std::optional<std::string> {
+  auto text     = std::string{};
+  auto negative = false;
+
+  switch (constant.type) {
+    case ConstantType::Bool: {
+      return std::get<bool>(constant.value) ? "true" : "false";
+    }
+    case ConstantType::I32:
+    case ConstantType::I64: {
+      // The magnitude of the minimum is not representable, it has no literal of its own type.
+      const auto value = std::get<int64_t>(constant.value);
+      const auto min   = constant.type == ConstantType::I64
+                             ? std::numeric_limits<int64_t>::min()
+                             : int64_t{std::numeric_limits<int32_t>::min()};
+      if (value == min) {
+        return std::nullopt;
+      }
+      negative = value < 0;
+      text     = std::to_string(negative ? -value : value);
+      text.append(constant.type == ConstantType::I64 ? "ll" : "");
+      break;
+    }
+    case ConstantType::U32: {
+      text = std::to_string(std::get<uint64_t>(constant.value)).append("u");
+      break;
+    }
+    case ConstantType::U64: {
+      text = std::to_string(std::get<uint64_t>(constant.value)).append("ull");
+      break;
+    }
+    case ConstantType::F32:
+    case ConstantType::F64: {
+      const auto value = std::get<double>(constant.value);
+      if (!std::isfinite(value)) {
+        return std::nullopt;
+      }
+      negative = std::signbit(value);
+      if (constant.type == ConstantType::F32) {
+        text = format_floating(static_cast<float>(std::fabs(value))).append("f");
+      } else {
+        text = format_floating(std::fabs(value));
+      }
+      break;
+    }
+    default: {
+      return std::nullopt;
+    }
+  }
+
+  if (negative) {
+    return std::string{"(-"}.append(text).append(")");
+  }
+  return text;
+}
@@ -0,0 +1,393 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "checker.hpp"
+#include "interpreter.hpp"
+#include "symbol_table.hpp"
+#include "parallel.hpp"
+#include "profiler.hpp"
+#include "timer.hpp"
+
+using StatementCollection = std::vector<BaseStatement::Pointer>;
+
+/**
+ * ConstantFolder
+ * \brief Folds the constant expressions of one tree in place and simplifies constant branches
+ *
+ * Values of immutable variables are only propagated within the tree. A source that used the value
+ * of another source would not be rebuilt when only that value changes.
+ */
+class ConstantFolder final {
+  const SymbolTable& table_;
+  ConstantValueMap& values_;
+  Interpreter interpreter_;
+
+ public:
+  explicit ConstantFolder(const SymbolTable& table, ConstantValueMap& values)
+      : table_{table},
+        values_{values},
+        interpreter_{table, values} {}
+
+  // Calls are only evaluated for functions of the same tree, for the same reason as values.
+  auto fold_tree(SyntaxTree& tree) -> void {
+    for (auto& pfn : tree.functions()) {
+      interpreter_.add_function(deref(pfn));
+    }
+    fold_structure(tree, table_.scope_of(tree), true);
+  }
+
+ private:
+  NODISCARD auto scope_in(const BaseSyntax& node, ScopeId scope) const -> ScopeId {
+    const auto inner = table_.scope_of(node);
+    return inner == invalid_scope_id ? scope : inner;
+  }
+
+  NODISCARD auto propagate(const BaseExpression& identifier) const
+      -> std::optional<ConstantValue> {
+    const auto id = table_.linked(identifier);
+    if (id == invalid_symbol_id) {
+      return std::nullopt;
+    }
+
+    auto it = values_.find(table_.symbol(id).syntax);
+    if (it == values_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  static auto make_literal(const ConstantValue& value, const FilePosition& pos)
+      -> BaseExpression::Pointer {
+    if (value.type == ConstantType::Bool) {
+      return std::make_unique<BooleanExpression>(pos, std::get<bool>(value.value));
+    }
+    if (auto literal = to_literal(value)) {
+      return std::make_unique<NumberExpression>(pos, *literal);
+    }
+    return nullptr;
+  }
+
+  // Replaces a constant expression through set, literals and values without one are kept as is.
+  template <typename Setter>
+  auto fold_child(const BaseExpression::Pointer& pexpr, const Setter& set)
+      -> std::optional<ConstantValue> {
+    if (!pexpr) {
+      return std::nullopt;
+    }
+
+    auto& expr       = *pexpr;
+    const auto value = fold(expr);
+    if (!value || expr.kind() == SyntaxKind::ExprNumber || expr.kind() == SyntaxKind::ExprBool) {
+      return value;
+    }
+
+    if (auto literal = make_literal(*value, expr.pos())) {
+      set(std::move(literal));
+    }
+    return value;
+  }
+
+  auto fold(BaseExpression& expr) -> std::optional<ConstantValue> {
+    switch (expr.kind()) {
+      case SyntaxKind::ExprBool: {
+        return ConstantValue{ConstantType::Bool, ref_cast<BooleanExpression>(expr).value()};
+      }
+      case SyntaxKind::ExprNumber: {
+        return parse_literal(ref_cast<NumberExpression>(expr).value());
+      }
+      case SyntaxKind::ExprIdentifier: {
+        return propagate(expr);
+      }
+      case SyntaxKind::ExprCall: {
+        auto& call     = ref_cast<CallExpression>(expr);
+        auto arguments = std::vector<ConstantValue>{};
+        for (auto i = size_t{0}; i < call.parameters().size(); ++i) {
+          auto set_argument   = [&](auto literal) { call.set_parameter(i, std::move(literal)); };
+          const auto argument = fold_child(call.parameters()[i], set_argument);
+          if (argument) {
+            arguments.push_back(*argument);
+          }
+        }
+
+        const auto* fn = interpreter_.callee(call);
+        if (fn == nullptr || arguments.size() != call.parameters().size()) {
+          return std::nullopt;
+        }
+        return interpreter_.call(*fn, arguments);
+      }
+      case SyntaxKind::ExprUnary: {
+        return fold_unary(ref_cast<UnaryExpression>(expr));
+      }
+      case SyntaxKind::ExprBinary: {
+        return fold_binary(ref_cast<BinaryExpression>(expr));
+      }
+      default: {
+        return std::nullopt;
+      }
+    }
+  }
+
+  auto fold_unary(UnaryExpression& expr) -> std::optional<ConstantValue> {
+    // The operand of an increment is its target.
+    if (is_increment(expr.op())) {
+      return std::nullopt;
+    }
+
+    const auto operand =
+        fold_child(expr.expr(), [&](auto literal) { expr.set_expr(std::move(literal)); });
+    return operand ? evaluate(expr.op(), *operand) : std::nullopt;
+  }
+
+  auto fold_binary(BinaryExpression& expr) -> std::optional<ConstantValue> {
+    const auto op = expr.op();
+    if (op == Operator::Static || op == Operator::Access) {
+      return std::nullopt;
+    }
+
+    auto set_lhs = [&](auto literal) { expr.set_lhs(std::move(literal)); };
+    auto set_rhs = [&](auto literal) { expr.set_rhs(std::move(literal)); };
+    if (is_assignment(op)) {
+      fold_child(expr.rhs(), set_rhs);
+      return std::nullopt;
+    }
+
+    const auto lhs = fold_child(expr.lhs(), set_lhs);
+    const auto rhs = fold_child(expr.rhs(), set_rhs);
+
+    // A constant left side decides && and || alone, the right side would never run.
+    if (lhs && !rhs) {
+      if (op == Operator::And && !to_bool(*lhs)) {
+        return ConstantValue{ConstantType::Bool, false};
+      }
+      if (op == Operator::Or && to_bool(*lhs)) {
+        return ConstantValue{ConstantType::Bool, true};
+      }
+    }
+
+    if (!lhs || !rhs) {
+      return std::nullopt;
+    }
+    return evaluate(op, *lhs, *rhs);
+  }
+
+  auto fold_variable(VariableDefinition& var, ScopeId scope, bool propagated) -> void {
+    const auto value =
+        fold_child(var.assignment(), [&](auto literal) { var.set_assignment(std::move(literal)); });
+    if (!value || var.is_mutable() || !propagated) {
+      return;
+    }
+
+    // Initialization converts to the declared type, deduced variables keep the type of the value.
+    auto type = value->type;
+    if (var.is_typed()) {
+      const auto declared = resolve_constant_type(table_, scope, deref(var.type()), var.pos());
+      if (!declared) {
+        return;
+      }
+      type = *declared;
+    }
+
+    if (auto converted = convert(*value, type)) {
+      values_.emplace(&var, *converted);
+    }
+  }
+
+  // Statements are moved out of a block while it is folded, so the function can not be called
+  // until its body is whole again. A recursive call in the body is left to run.
+  auto fold_function(FunctionDefinition& fn, ScopeId scope) -> void {
+    if (!fn.body()) {
+      return;
+    }
+    const auto callable = interpreter_.remove_function(fn);
+    fold_block(*fn.body(), scope_in(fn, scope));
+    if (callable) {
+      interpreter_.add_function(fn);
+    }
+  }
+
+  // Members are folded but not propagated, their value belongs to each instance.
+  auto fold_structure(BaseStructureDefinition& structure, ScopeId scope, bool at_module) -> void {
+    for (auto& pvar : structure.variables()) {
+      fold_variable(deref(pvar), scope, at_module);
+    }
+    for (auto& pstruct : structure.structs()) {
+      fold_structure(*pstruct, scope_in(*pstruct, scope), false);
+    }
+    for (auto& pobject : structure.objects()) {
+      fold_structure(*pobject, scope_in(*pobject, scope), false);
+    }
+    for (auto& pfn : structure.functions()) {
+      fold_function(deref(pfn), scope);
+    }
+  }
+
+  auto fold_statement(BaseStatement& stmt, ScopeId scope) -> void {
+    switch (stmt.kind()) {
+      case SyntaxKind::StmtDef: {
+        auto& def = deref(ref_cast<DefinitionStatement>(stmt).def());
+        if (def.kind() == SyntaxKind::DefVar) {
+          fold_variable(ref_cast<VariableDefinition>(def), scope, true);
+        } else if (def.kind() == SyntaxKind::DefFunc) {
+          fold_function(ref_cast<FunctionDefinition>(def), scope);
+        }
+        break;
+      }
+      case SyntaxKind::StmtExpr: {
+        auto& expr_stmt = ref_cast<ExpressionStatement>(stmt);
+        fold_child(expr_stmt.expr(), [&](auto literal) { expr_stmt.set_expr(std::move(literal)); });
+        break;
+      }
+      case SyntaxKind::StmtRet: {
+        auto& ret = ref_cast<ReturnStatement>(stmt);
+        fold_child(ret.expr(), [&](auto literal) { ret.set_expr(std::move(literal)); });
+        break;
+      }
+      case SyntaxKind::StmtLoop: {
+        fold_block(deref(ref_cast<LoopStatement>(stmt).body()), scope);
+        break;
+      }
+      case SyntaxKind::StmtWhile: {
+        auto& loop = ref_cast<WhileStatement>(stmt);
+        fold_child(loop.expr(), [&](auto literal) { loop.set_expr(std::move(literal)); });
+        fold_block(deref(loop.body()), scope);
+        break;
+      }
+      case SyntaxKind::StmtFor: {
+        auto& loop       = ref_cast<ForStatement>(stmt);
+        const auto inner = scope_in(loop, scope);
+        if (loop.prefix()) {
+          fold_statement(*loop.prefix(), inner);
+        }
+        fold_child(loop.cond(), [&](auto literal) { loop.set_cond(std::move(literal)); });
+        fold_child(loop.postfix(), [&](auto literal) { loop.set_postfix(std::move(literal)); });
+        fold_block(deref(loop.body()), inner);
+        break;
+      }
+      default: {
+        // If chains are folded by their block.
+        break;
+      }
+    }
+  }
+
+  // A branch that always runs first is unwrapped, unless its declarations could clash outside.
+  static auto append_unconditional(BaseBodyStatement& branch, StatementCollection& folded) -> void {
+    auto& statements = deref(branch.body()).statements();
+    const auto declares =
+        std::any_of(statements.begin(), statements.end(),
+                    [](auto& statement) { return statement->kind() == SyntaxKind::StmtDef; });
+    if (!declares) {
+      std::move(statements.begin(), statements.end(), std::back_inserter(folded));
+      return;
+    }
+
+    auto unconditional = std::make_unique<IfStatement>(branch.pos());
+    unconditional->set_expr(std::make_unique<BooleanExpression>(branch.pos(), true));
+    unconditional->set_body(std::move(branch.body()));
+    folded.push_back(std::move(unconditional));
+  }
+
+  // Branches that never run are dropped, the first branch that always runs ends the chain.
+  auto fold_branches(std::span<BaseStatement::Pointer> chain,
+                     ScopeId scope,
+                     StatementCollection& folded) -> void {
+    const auto first = folded.size();
+    for (auto& pbranch : chain) {
+      auto& branch = ref_cast<BaseBodyStatement>(*pbranch);
+      auto always  = branch.kind() == SyntaxKind::StmtElse;
+      if (!always) {
+        auto& conditional = ref_cast<IfStatement>(branch);
+        const auto condition = fold_child(
+            conditional.expr(), [&](auto literal) { conditional.set_expr(std::move(literal)); });
+        if (condition && !to_bool(*condition)) {
+          continue;
+        }
+        always = condition.has_value();
+      }
+      fold_block(deref(branch.body()), scope);
+
+      const auto leading = folded.size() == first;
+      if (always && leading) {
+        append_unconditional(branch, folded);
+        return;
+      }
+      if (always && branch.kind() != SyntaxKind::StmtElse) {
+        auto otherwise = std::make_unique<ElseStatement>(branch.pos());
+        otherwise->set_body(std::move(branch.body()));
+        folded.push_back(std::move(otherwise));
+        return;
+      }
+      if (leading && branch.kind() == SyntaxKind::StmtElif) {
+        auto& elif    = ref_cast<IfStatement>(branch);
+        auto promoted = std::make_unique<IfStatement>(elif.pos());
+        promoted->set_expr(std::move(elif.expr()));
+        promoted->set_body(std::move(elif.body()));
+        folded.push_back(std::move(promoted));
+        continue;
+      }
+      folded.push_back(std::move(pbranch));
+      if (always) {
+        return;
+      }
+    }
+  }
+
+  auto fold_block(StatementBlock& block, ScopeId scope) -> void {
+    scope            = scope_in(block, scope);
+    auto& statements = block.statements();
+
+    auto folded = StatementCollection{};
+    folded.reserve(statements.size());
+    for (auto i = size_t{0}; i < statements.size();) {
+      if (statements[i]->kind() != SyntaxKind::StmtIf) {
+        fold_statement(*statements[i], scope);
+        folded.push_back(std::move(statements[i++]));
+        continue;
+      }
+
+      auto end = i + 1;
+      while (end < statements.size() && statements[end]->kind() == SyntaxKind::StmtElif) {
+        ++end;
+      }
+      if (end < statements.size() && statements[end]->kind() == SyntaxKind::StmtElse) {
+        ++end;
+      }
+      fold_branches(std::span{statements}.subspan(i, end - i), scope, folded);
+      i = end;
+    }
+    statements = std::move(folded);
+  }
+};
+
+auto collect_trees(const NameSpace& ns, std::vector<SyntaxTree*>& trees) -> void {
+  for (auto& tree : ns.trees()) {
+    trees.push_back(tree.get());
+  }
+  for (auto& sub_space : ns.sub_spaces()) {
+    collect_trees(deref(sub_space), trees);
+  }
+}
+
+auto fold_constants(ProjectTree& project_tree, uint32_t jobs) -> void {
+  TRACE_TIMER("Fold Constants");
+  PROFILE_SCOPE("Fold Constants");
+  auto& table = deref(project_tree.symbols());
+
+  auto trees = std::vector<SyntaxTree*>{};
+  collect_trees(deref(project_tree.root()), trees);
+
+  // Trees are independent, each keeps the values of its own immutable variables.
+  auto values = std::vector<ConstantValueMap>(trees.size());
+  parallel_for(trees.size(), jobs, [&](size_t, size_t i) {
+    auto& tree = deref(trees[i]);
+    PROFILE_SCOPE("Fold", deref(tree.source()).rel_path());
+    auto folder = ConstantFolder{table, values[i]};
+    folder.fold_tree(tree);
+  });
+
+  auto constants = ConstantValueMap{};
+  for (auto& tree_values : values) {
+    constants.merge(tree_values);
+  }
+  project_tree.set_constants(std::move(constants));
+}
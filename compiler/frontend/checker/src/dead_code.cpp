@@ -0,0 +1,326 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "checker.hpp"
+#include "symbol_table.hpp"
+#include "parallel.hpp"
+#include "profiler.hpp"
+#include "timer.hpp"
+
+/**
+ * Definition
+ * \brief Module level definition of a parsed tree, a node of the reachability graph
+ */
+struct Definition final {
+  const BaseDefinition* syntax;
+  size_t tree;
+  bool root;
+  std::vector<SymbolId> references;
+
+  // Referred to by the declaration alone, a subset of references.
+  std::vector<SymbolId> signature;
+};
+
+/**
+ * ParsedTree
+ * \brief Parsed tree with the namespace it was placed in
+ */
+struct ParsedTree final {
+  const NameSpace* name_space;
+  const SyntaxTree* tree;
+};
+
+// Unspecified access is module access, anything wider is visible outside of the project.
+auto is_droppable(AccessModifier access) -> bool {
+  return access == AccessModifier::Unspecified || access == AccessModifier::Private ||
+         access == AccessModifier::Module;
+}
+
+// Initializers other than literals may have side effects that have to run either way.
+auto has_side_effects(const VariableDefinition& var) -> bool {
+  if (!var.is_assigned()) {
+    return false;
+  }
+
+  const auto kind = var.assignment()->kind();
+  return kind != SyntaxKind::ExprBool && kind != SyntaxKind::ExprNumber &&
+         kind != SyntaxKind::ExprString;
+}
+
+/**
+ * ReferenceCollector
+ * \brief Collects every symbol a definition refers to, through identifiers, calls and types
+ *
+ * Type names are resolved from the file scope, only module level definitions are candidates so
+ * types declared inside a structure do not matter. A signature is the type of a variable or the
+ * parameter and return types of a function, what a forward declaration is spelled with.
+ */
+class ReferenceCollector final {
+  const SymbolTable& table_;
+  ScopeId file_scope_;
+  std::vector<SymbolId>& references_;
+
+ public:
+  explicit ReferenceCollector(const SymbolTable& table,
+                              ScopeId file_scope,
+                              std::vector<SymbolId>& references)
+      : table_{table},
+        file_scope_{file_scope},
+        references_{references} {}
+
+  auto collect(const BaseSyntax& node) -> void {
+    switch (node.kind()) {
+      case SyntaxKind::ExprIdentifier:
+      case SyntaxKind::ExprCall: {
+        add(table_.linked(node));
+        break;
+      }
+      case SyntaxKind::DefVar: {
+        collect_type(ref_cast<const VariableDefinition>(node).type(), node.pos());
+        break;
+      }
+      case SyntaxKind::DefParam: {
+        collect_type(ref_cast<const FunctionParameter>(node).type(), node.pos());
+        break;
+      }
+      case SyntaxKind::DefFunc: {
+        collect_type(ref_cast<const FunctionDefinition>(node).return_type(), node.pos());
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+    for_each_child(node, [this](const BaseSyntax& child) { collect(child); });
+  }
+
+  auto collect_signature(const BaseDefinition& def) -> void {
+    if (def.kind() == SyntaxKind::DefVar) {
+      collect_type(ref_cast<const VariableDefinition>(def).type(), def.pos());
+    } else if (def.kind() == SyntaxKind::DefFunc) {
+      auto& fn = ref_cast<const FunctionDefinition>(def);
+      for (auto& param : fn.parameters()) {
+        collect_type(deref(param).type(), param->pos());
+      }
+      collect_type(fn.return_type(), fn.pos());
+    }
+  }
+
+ private:
+  auto add(SymbolId id) -> void {
+    if (id != invalid_symbol_id) {
+      references_.push_back(id);
+    }
+  }
+
+  auto collect_type(const Type* type, const FilePosition& pos) -> void {
+    if (type == nullptr) {
+      return;
+    }
+
+    if (!type->name().empty()) {
+      add(table_.resolve(file_scope_, type->name(), pos));
+    }
+    collect_type(type->element(), pos);
+    for (auto* argument : type->arguments()) {
+      collect_type(argument, pos);
+    }
+  }
+};
+
+auto collect_definitions(const SymbolTable& table,
+                         BinaryType binary_type,
+                         const SyntaxTree& tree,
+                         size_t index) -> std::vector<Definition> {
+  auto definitions = std::vector<Definition>{};
+  const auto scope = table.scope_of(tree);
+
+  auto add = [&](const BaseDefinition& syntax, bool root) {
+    auto& definition = definitions.emplace_back(Definition{&syntax, index, root, {}, {}});
+    ReferenceCollector{table, scope, definition.references}.collect(syntax);
+    ReferenceCollector{table, scope, definition.signature}.collect_signature(syntax);
+  };
+
+  for (auto& pvar : tree.variables()) {
+    auto& var = deref(pvar);
+    add(var, !is_droppable(var.access()) || has_side_effects(var));
+  }
+  for (auto& pstruct : tree.structs()) {
+    add(deref(pstruct), !is_droppable(pstruct->access()));
+  }
+  for (auto& pobject : tree.objects()) {
+    add(deref(pobject), !is_droppable(pobject->access()));
+  }
+  for (auto& pfn : tree.functions()) {
+    auto& fn        = deref(pfn);
+    const auto main = binary_type == BinaryType::Exe && fn.name() == "main";
+    add(fn, main || !is_droppable(fn.access()));
+  }
+  return definitions;
+}
+
+auto collect_sources(const NameSpace& ns,
+                     std::vector<ParsedTree>& trees,
+                     std::vector<const RetainedSource*>& retained) -> void {
+  for (auto& tree : ns.trees()) {
+    trees.push_back({&ns, tree.get()});
+  }
+  for (auto& source : ns.retained()) {
+    retained.push_back(&source);
+  }
+  for (auto& sub_space : ns.sub_spaces()) {
+    collect_sources(deref(sub_space), trees, retained);
+  }
+}
+
+auto map_namespace_scopes(const SymbolTable& table,
+                          const NameSpace& ns,
+                          std::unordered_map<ScopeId, const NameSpace*>& scopes) -> void {
+  if (const auto scope = table.namespace_scope(ns.full_name()); scope != invalid_scope_id) {
+    scopes.emplace(scope, &ns);
+  }
+  for (auto& sub_space : ns.sub_spaces()) {
+    map_namespace_scopes(table, deref(sub_space), scopes);
+  }
+}
+
+auto eliminate_dead_code(ProjectTree& project_tree, BinaryType binary_type, uint32_t jobs)
+    -> DeadCodeReport {
+  TRACE_TIMER("Eliminate Dead Code");
+  PROFILE_SCOPE("Eliminate Dead Code");
+  auto& table = deref(project_tree.symbols());
+  auto& root  = deref(project_tree.root());
+
+  auto trees    = std::vector<ParsedTree>{};
+  auto retained = std::vector<const RetainedSource*>{};
+  collect_sources(root, trees, retained);
+
+  auto definitions = std::vector<std::vector<Definition>>(trees.size());
+  parallel_for(trees.size(), jobs, [&](size_t, size_t i) {
+    definitions[i] = collect_definitions(table, binary_type, deref(trees[i].tree), i);
+  });
+
+  // C types are not part of the graph, uses still have to know which file declares them.
+  auto by_syntax   = std::unordered_map<const BaseSyntax*, const Definition*>{};
+  auto by_key      = std::unordered_map<std::string, const Definition*>{};
+  auto declared_in = std::unordered_map<const BaseSyntax*, size_t>{};
+  for (auto i = size_t{0}; i < trees.size(); ++i) {
+    for (auto& definition : definitions[i]) {
+      auto& syntax = deref(definition.syntax);
+      by_syntax.emplace(&syntax, &definition);
+      declared_in.emplace(&syntax, i);
+      if (syntax.access() != AccessModifier::Private) {
+        by_key.emplace(module_key(trees[i].name_space->full_name(), syntax.name()), &definition);
+      }
+    }
+    for (auto& ctype : deref(trees[i].tree).ctypes()) {
+      declared_in.emplace(ctype.get(), i);
+    }
+  }
+
+  auto reached = std::unordered_set<const Definition*>{};
+  auto pending = std::vector<const Definition*>{};
+  auto reach   = [&](const Definition* definition) {
+    if (reached.insert(definition).second) {
+      pending.push_back(definition);
+    }
+  };
+
+  for (auto& tree_definitions : definitions) {
+    for (auto& definition : tree_definitions) {
+      if (definition.root) {
+        reach(&definition);
+      }
+    }
+  }
+
+  // Outputs of retained sources are kept as is, so whatever they use has to stay.
+  for (auto* source : retained) {
+    for (auto& use : deref(source->record).uses) {
+      if (auto it = by_key.find(use); it != by_key.end()) {
+        reach(it->second);
+      }
+    }
+  }
+
+  while (!pending.empty()) {
+    const auto* definition = pending.back();
+    pending.pop_back();
+    for (const auto id : definition->references) {
+      if (auto it = by_syntax.find(table.symbol(id).syntax); it != by_syntax.end()) {
+        reach(it->second);
+      }
+    }
+  }
+
+  auto scopes = std::unordered_map<ScopeId, const NameSpace*>{};
+  map_namespace_scopes(table, root, scopes);
+
+  // Uses are recorded by key, declarations of the same file need no record.
+  auto record_uses = [&](std::span<const SymbolId> ids,
+                         size_t tree,
+                         std::vector<std::string>& uses) {
+    for (const auto id : ids) {
+      auto& symbol = table.symbol(id);
+      auto file    = declared_in.find(symbol.syntax);
+      auto scope   = scopes.find(symbol.scope);
+      if (scope == scopes.end() || (file != declared_in.end() && file->second == tree)) {
+        continue;
+      }
+      uses.push_back(module_key(scope->second->full_name(), table.names().view(symbol.name)));
+    }
+  };
+
+  auto sort_unique = [](std::vector<std::string>& keys) {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  };
+
+  auto report     = DeadCodeReport{};
+  auto eliminated = std::unordered_set<const BaseSyntax*>{};
+  for (auto i = size_t{0}; i < trees.size(); ++i) {
+    auto& source = deref(deref(trees[i].tree).source());
+    auto& entry  = report.sources.emplace_back(DeadCodeReport::Source{&source, {}, {}, {}});
+
+    for (auto& definition : definitions[i]) {
+      auto& syntax     = deref(definition.syntax);
+      const auto nodes = count_syntax_nodes(syntax);
+      report.definitions += 1;
+      report.syntax_nodes += nodes;
+
+      if (!reached.contains(&definition)) {
+        eliminated.insert(&syntax);
+        report.eliminated += 1;
+        report.eliminated_nodes += nodes;
+        source.stats().eliminated_definitions += 1;
+        source.stats().eliminated_syntax_nodes += nodes;
+        if (syntax.access() != AccessModifier::Private) {
+          entry.eliminated.push_back(syntax.name());
+        }
+        continue;
+      }
+
+      record_uses(definition.references, i, entry.uses);
+      if (syntax.access() != AccessModifier::Private) {
+        record_uses(definition.signature, i, entry.header_uses);
+      }
+    }
+
+    sort_unique(entry.uses);
+    sort_unique(entry.header_uses);
+  }
+
+  // The generator includes what each source uses, retained sources keep what they used before.
+  auto uses = std::unordered_map<const SourceContext*, SourceUses>{};
+  for (auto& entry : report.sources) {
+    uses.emplace(entry.source, SourceUses{entry.uses, entry.header_uses});
+  }
+  for (auto* source : retained) {
+    auto& record = deref(source->record);
+    uses.emplace(source->source.get(), SourceUses{record.uses, record.header_uses});
+  }
+
+  project_tree.set_eliminated(std::move(eliminated));
+  project_tree.set_uses(std::move(uses));
+  return report;
+}
@@ -0,0 +1,478 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "symbol_table.hpp"
+#include "parallel.hpp"
+#include "profiler.hpp"
+
+/**
+ * Declaration of a symbol known only by its export record, from the dependency database or the
+ * symbol table of a referenced project, empty when a function detail is not a signature
+ */
+auto exported_symbol(StringInterner& names,
+                     TypeGraph& types,
+                     SymbolKind kind,
+                     AccessModifier access,
+                     bool is_mutable,
+                     std::string_view name,
+                     std::string_view detail,
+                     ScopeId scope) -> std::optional<Symbol> {
+  // Function details hold the signature, "(T,U)->R". C types hold their C name, which is kept as
+  // is rather than parsed as a Typhon type.
+  const Type* type = nullptr;
+  auto parameters  = std::vector<const Type*>{};
+  if (kind == SymbolKind::Function) {
+    const auto arrow = detail.rfind("->");
+    if (detail.empty() || detail.front() != '(' || arrow == std::string_view::npos || arrow < 2 ||
+        detail[arrow - 1] != ')') {
+      return std::nullopt;
+    }
+
+    const auto list = detail.substr(1, arrow - 2);
+
+    // Arguments of generic types hold commas of their own.
+    auto depth = 0;
+    auto start = size_t{0};
+    for (auto i = size_t{0}; i < list.size(); ++i) {
+      if (list[i] == '<') {
+        ++depth;
+      } else if (list[i] == '>') {
+        --depth;
+      } else if (list[i] == ',' && depth == 0) {
+        parameters.push_back(types.parse(list.substr(start, i - start)));
+        start = i + 1;
+      }
+    }
+    if (!list.empty()) {
+      parameters.push_back(types.parse(list.substr(start)));
+    }
+    type = types.parse(detail.substr(arrow + 2));
+  } else if (kind == SymbolKind::Variable) {
+    type = types.parse(detail);
+  } else if (kind == SymbolKind::CType && !detail.empty()) {
+    type = types.named(detail);
+  }
+
+  const auto arity = parameters.size();
+  return Symbol{kind,
+                access,
+                is_mutable,
+                static_cast<uint16_t>(arity),
+                names.intern(name),
+                scope,
+                type,
+                nullptr,
+                std::move(parameters)};
+}
+
+/**
+ * DeclarationCollector
+ * \brief Fills the batch of a single source, the shared table is only read and its names interned
+ */
+class DeclarationCollector final {
+  const SymbolTable& table_;
+  StringInterner& names_;
+  TypeGraph& types_;
+  DeclarationBatch& batch_;
+
+  static constexpr auto file_scope = ScopeId{0};
+
+ public:
+  explicit DeclarationCollector(SymbolTable& table, TypeGraph& types, DeclarationBatch& batch)
+      : table_{table},
+        names_{table.names()},
+        types_{types},
+        batch_{batch} {}
+
+  auto collect_retained(const RetainedSource& retained) -> void {
+    for (auto& exported : deref(retained.record).exports) {
+      collect_export(exported);
+    }
+  }
+
+  auto collect_tree(const SyntaxTree& tree) -> void {
+    batch_.scopes.push_back({ScopeKind::File, invalid_scope_id, invalid_intern_id, {}});
+    batch_.bindings.emplace_back(&tree, file_scope);
+
+    for (auto& pimport : tree.imports()) {
+      const auto imported = table_.namespace_scope(deref(pimport).full_name());
+      if (imported != invalid_scope_id) {
+        batch_.scopes[file_scope].imports.push_back(imported);
+      }
+    }
+
+    for (auto& pinclude : tree.cincludes()) {
+      auto& include = deref(pinclude);
+      declare(SymbolKind::CInclude, include, include.name(), nullptr, true, file_scope);
+    }
+
+    for (auto& pctype : tree.ctypes()) {
+      auto& ctype = deref(pctype);
+      const auto* c_type = ctype.c_name().empty() ? nullptr : types_.named(ctype.c_name());
+      declare(SymbolKind::CType, ctype, ctype.name(), c_type, true, file_scope);
+    }
+
+    collect_structure(tree, true, file_scope);
+  }
+
+ private:
+  auto add_scope(ScopeKind kind, ScopeId parent, const BaseSyntax& syntax, InternId name)
+      -> ScopeId {
+    const auto scope = static_cast<ScopeId>(batch_.scopes.size());
+    batch_.scopes.push_back({kind, parent, name, {}});
+    batch_.bindings.emplace_back(&syntax, scope);
+    return scope;
+  }
+
+  // Declarations at module level go to the namespace unless private, everything else is local.
+  auto declare(SymbolKind kind,
+               const BaseAccessSyntax& syntax,
+               std::string_view name,
+               const Type* type,
+               bool at_module,
+               ScopeId scope,
+               bool is_mutable = false,
+               size_t arity    = 0) -> void {
+    auto symbol = Symbol{kind,
+                         syntax.access(),
+                         is_mutable,
+                         static_cast<uint16_t>(arity),
+                         names_.intern(name),
+                         scope,
+                         type,
+                         &syntax};
+    if (kind != SymbolKind::CType) {
+      use_type(type);
+    }
+
+    if (at_module && syntax.access() != AccessModifier::Private) {
+      symbol.scope = batch_.parent;
+      batch_.module_symbols.push_back(symbol);
+    } else {
+      batch_.symbols.push_back(symbol);
+    }
+  }
+
+  auto collect_export(const ExportedSymbol& exported) -> void {
+    auto declared = exported_symbol(names_,
+                                    types_,
+                                    exported.kind,
+                                    exported.access,
+                                    exported.is_mutable,
+                                    exported.name,
+                                    exported.detail,
+                                    batch_.parent);
+    if (!declared) {
+      batch_.corrupt = true;
+      return;
+    }
+
+    auto& symbol = batch_.module_symbols.emplace_back(std::move(*declared));
+    if (exported.kind != SymbolKind::CType) {
+      use_type(symbol.type);
+    }
+    for (auto* parameter : symbol.parameters) {
+      use_type(parameter);
+    }
+  }
+
+  // C types alias a C spelling, only Typhon types name declarations.
+  auto use_type(const Type* type) -> void {
+    if (type == nullptr) {
+      return;
+    }
+    if (!type->name().empty()) {
+      batch_.uses.push_back(names_.intern(type->name()));
+    }
+    use_type(type->element());
+    for (auto* argument : type->arguments()) {
+      use_type(argument);
+    }
+  }
+
+  auto use_name(const BaseSyntax& node) -> void {
+    if (node.kind() == SyntaxKind::ExprIdentifier) {
+      batch_.uses.push_back(
+          names_.intern(ref_cast<const IdentifierExpression>(node).identifier()));
+    } else if (node.kind() == SyntaxKind::ExprCall) {
+      batch_.uses.push_back(names_.intern(ref_cast<const CallExpression>(node).identifier()));
+    }
+  }
+
+  auto collect_uses(const BaseSyntax& node) -> void {
+    use_name(node);
+    for_each_child(node, [&](const BaseSyntax& child) { collect_uses(child); });
+  }
+
+  auto collect_structure(const BaseStructureDefinition& structure, bool at_module, ScopeId scope)
+      -> void {
+    for (auto& pvar : structure.variables()) {
+      auto& var = deref(pvar);
+      declare(SymbolKind::Variable,
+              var,
+              var.name(),
+              var.type(),
+              at_module,
+              scope,
+              var.is_mutable());
+      collect_uses(var);
+    }
+
+    for (auto& pstruct : structure.structs()) {
+      collect_nested(SymbolKind::Struct, deref(pstruct), at_module, scope);
+    }
+
+    for (auto& pobject : structure.objects()) {
+      collect_nested(SymbolKind::Object, deref(pobject), at_module, scope);
+    }
+
+    for (auto& pfn : structure.functions()) {
+      collect_function(deref(pfn), at_module, scope);
+    }
+  }
+
+  auto collect_nested(SymbolKind kind,
+                      const BaseStructureDefinition& structure,
+                      bool at_module,
+                      ScopeId scope) -> void {
+    declare(kind, structure, structure.name(), nullptr, at_module, scope);
+
+    // Members are scoped to the structure, whatever their access.
+    const auto name  = names_.intern(structure.name());
+    const auto inner = add_scope(ScopeKind::Structure, scope, structure, name);
+    collect_structure(structure, false, inner);
+  }
+
+  auto collect_function(const FunctionDefinition& fn, bool at_module, ScopeId parent) -> void {
+    declare(SymbolKind::Function,
+            fn,
+            fn.name(),
+            fn.return_type(),
+            at_module,
+            parent,
+            false,
+            fn.parameters().size());
+
+    const auto name  = names_.intern(fn.name());
+    const auto scope = add_scope(ScopeKind::Function, parent, fn, name);
+
+    // Parameters are passed by value and may be reassigned.
+    for (auto& pparam : fn.parameters()) {
+      auto& param = deref(pparam);
+      declare(SymbolKind::Parameter, param, param.name(), param.type(), false, scope, true);
+    }
+
+    if (fn.body()) {
+      collect_locals(*fn.body(), scope);
+    }
+  }
+
+  auto collect_locals(const BaseSyntax& node, ScopeId scope) -> void {
+    use_name(node);
+    switch (node.kind()) {
+      case SyntaxKind::Block:
+      case SyntaxKind::StmtFor: {
+        scope = add_scope(ScopeKind::Block, scope, node, invalid_intern_id);
+        break;
+      }
+      case SyntaxKind::DefVar: {
+        auto& var = ref_cast<const VariableDefinition>(node);
+        declare(SymbolKind::Variable,
+                var,
+                var.name(),
+                var.type(),
+                false,
+                scope,
+                var.is_mutable());
+        break;
+      }
+      case SyntaxKind::DefFunc: {
+        collect_function(ref_cast<const FunctionDefinition>(node), false, scope);
+        return;
+      }
+      default: {
+        break;
+      }
+    }
+    for_each_child(node, [&](const BaseSyntax& child) { collect_locals(child, scope); });
+  }
+};
+
+/**
+ * DeclarationUnit
+ * \brief A parsed or retained source together with the namespace it declares into
+ */
+struct DeclarationUnit final {
+  ScopeId scope;
+  const SyntaxTree* tree;
+  const RetainedSource* retained;
+};
+
+auto create_namespace_scopes(SymbolTable& table, const NameSpace& ns, ScopeId scope) -> void {
+  for (auto& sub_space : ns.sub_spaces()) {
+    auto& sub        = deref(sub_space);
+    const auto inner = table.add_namespace_scope(scope, sub.name(), sub.full_name());
+    create_namespace_scopes(table, sub, inner);
+  }
+}
+
+// Units are listed in namespace and path order so merging is deterministic.
+auto collect_units(const SymbolTable& table,
+                   const NameSpace& ns,
+                   std::vector<DeclarationUnit>& units) -> void {
+  const auto scope = table.namespace_scope(ns.full_name());
+  for (auto& retained : ns.retained()) {
+    units.push_back({scope, nullptr, &retained});
+  }
+  for (auto& tree : ns.trees()) {
+    units.push_back({scope, tree.get(), nullptr});
+  }
+  for (auto& sub_space : ns.sub_spaces()) {
+    collect_units(table, deref(sub_space), units);
+  }
+}
+
+constexpr auto namespace_seperator = std::string_view{"::"};
+
+// Namespaces of a reference may be shared with the project or with another reference.
+auto reference_namespace_scope(SymbolTable& table, std::string_view full_name) -> ScopeId {
+  if (full_name.empty()) {
+    return table.global_scope();
+  }
+  if (auto scope = table.namespace_scope(full_name); scope != invalid_scope_id) {
+    return scope;
+  }
+
+  const auto split = full_name.rfind(namespace_seperator);
+  if (split == std::string_view::npos) {
+    return table.add_namespace_scope(table.global_scope(), full_name, full_name);
+  }
+
+  const auto parent = reference_namespace_scope(table, full_name.substr(0, split));
+  const auto name   = full_name.substr(split + namespace_seperator.size());
+  return table.add_namespace_scope(parent, name, full_name);
+}
+
+// Imports are resolved while sources are collected, so reference namespaces exist before that.
+auto create_reference_scopes(SymbolTable& table,
+                             std::span<const SymbolFile::ConstPointer> references) -> void {
+  for (auto& preference : references) {
+    auto& reference = deref(preference);
+    for (auto& ns : reference.namespaces()) {
+      reference_namespace_scope(table, reference.string(ns.full_name));
+    }
+  }
+}
+
+// Symbols are found by binary search in the mapped table, the rest of a reference is never read.
+auto declare_references(SymbolTable& table,
+                        TypeGraph& types,
+                        std::span<const SymbolFile::ConstPointer> references,
+                        std::span<const InternId> names) -> bool {
+  auto declared = true;
+  for (auto& preference : references) {
+    auto& reference = deref(preference);
+    for (auto& ns : reference.namespaces()) {
+      const auto scope = table.namespace_scope(reference.string(ns.full_name));
+      for (const auto name : names) {
+        const auto* entry = reference.find_symbol(ns, table.names().view(name));
+        if (entry == nullptr) {
+          continue;
+        }
+
+        const auto symbol = exported_symbol(table.names(),
+                                            types,
+                                            static_cast<SymbolKind>(entry->kind),
+                                            static_cast<AccessModifier>(entry->access),
+                                            entry->is_mutable != 0,
+                                            reference.string(entry->name),
+                                            reference.string(entry->detail),
+                                            scope);
+        if (!symbol) {
+          std::cerr << "Error : Corrupt public symbol table of reference \"" << reference.project()
+                    << "\", \"" << reference.string(entry->name) << "\" has no valid signature"
+                    << std::endl;
+          declared = false;
+        } else if (!table.declare(*symbol).second) {
+          std::cerr << "Error : \"" << reference.string(entry->name) << "\" of reference \""
+                    << reference.project() << "\" is already declared" << std::endl;
+          declared = false;
+        }
+      }
+    }
+  }
+  return declared;
+}
+
+// Every name is listed once, in the order sources are merged so symbol ids stay deterministic.
+auto used_names(const SymbolTable& table, std::span<const DeclarationBatch> batches)
+    -> std::vector<InternId> {
+  auto seen  = std::vector<bool>(table.names().size());
+  auto names = std::vector<InternId>{};
+  auto use   = [&](InternId name) {
+    if (!seen[name]) {
+      seen[name] = true;
+      names.push_back(name);
+    }
+  };
+
+  for (auto& batch : batches) {
+    for (const auto name : batch.uses) {
+      use(name);
+    }
+    for (auto& symbol : batch.module_symbols) {
+      use(symbol.name);
+    }
+  }
+  return names;
+}
+
+auto SymbolTable::from_project_tree(const ProjectTree& project,
+                                    std::span<const SymbolFile::ConstPointer> references,
+                                    uint32_t jobs) -> Pointer {
+  PROFILE_SCOPE("Declare");
+  auto table = std::make_unique<SymbolTable>();
+
+  // Scopes of every namespace exist before any import is resolved.
+  auto& root = deref(project.root());
+  create_namespace_scopes(*table, root, table->global_scope());
+  create_reference_scopes(*table, references);
+  auto& types = project.types();
+
+  auto units = std::vector<DeclarationUnit>{};
+  collect_units(*table, root, units);
+
+  auto batches = std::vector<DeclarationBatch>(units.size());
+  parallel_for(units.size(), jobs, [&](size_t, size_t i) {
+    auto& unit   = units[i];
+    auto& batch  = batches[i];
+    batch.parent = unit.scope;
+
+    auto collector = DeclarationCollector{*table, types, batch};
+    if (unit.tree != nullptr) {
+      batch.source = unit.tree->source().get();
+      PROFILE_SCOPE("Collect", deref(batch.source).rel_path());
+      collector.collect_tree(*unit.tree);
+    } else {
+      batch.source = unit.retained->source.get();
+      collector.collect_retained(*unit.retained);
+    }
+  });
+
+  auto merged = true;
+  for (auto& batch : batches) {
+    if (batch.corrupt) {
+      std::cerr << "Error : Corrupt dependency record of "
+                << deref(batch.source).rel_path().string() << std::endl;
+      merged = false;
+    }
+    merged = table->merge(batch) && merged;
+  }
+  if (!merged || !declare_references(*table, types, references, used_names(*table, batches))) {
+    exit(-1);
+  }
+
+  table->seal();
+  types.seal();
+  return table;
+}
@@ -0,0 +1,319 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "dependency_db.hpp"
+
+#include <charconv>
+
+/* Exports */
+
+auto is_exported(const BaseAccessSyntax& syntax) -> bool {
+  return syntax.access() != AccessModifier::Private;
+}
+
+auto function_detail(const FunctionDefinition& fn) -> std::string {
+  auto detail = std::string{"("};
+  for (auto& pparam : fn.parameters()) {
+    auto& param = deref(pparam);
+    if (detail.size() > 1) {
+      detail.append(",");
+    }
+    detail.append(type_spelling(param.type()));
+  }
+  return detail.append(")->").append(type_spelling(fn.return_type()));
+}
+
+auto structure_detail(const BaseStructureDefinition& structure) -> std::string {
+  auto detail = std::string{};
+  for (auto& pvar : structure.variables()) {
+    auto& var = deref(pvar);
+    detail.append(var.is_mutable() ? "mut " : "").append(var.name()).append(":");
+    detail.append(type_spelling(var.type())).append(";");
+  }
+  for (auto& pfn : structure.functions()) {
+    auto& fn = deref(pfn);
+    detail.append(fn.name()).append(function_detail(fn)).append(";");
+  }
+  return detail;
+}
+
+// Order matches the public symbol table layout, c includes and types first.
+auto collect_exports(const SyntaxTree& tree) -> std::vector<ExportedSymbol> {
+  auto exports = std::vector<ExportedSymbol>{};
+
+  for (auto& pinclude : tree.cincludes()) {
+    auto& include = deref(pinclude);
+    if (is_exported(include)) {
+      exports.push_back({SymbolKind::CInclude, include.access(), include.name(), {}});
+    }
+  }
+
+  for (auto& pctype : tree.ctypes()) {
+    auto& ctype = deref(pctype);
+    if (is_exported(ctype)) {
+      exports.push_back({SymbolKind::CType, ctype.access(), ctype.name(), ctype.c_name()});
+    }
+  }
+
+  for (auto& pvar : tree.variables()) {
+    auto& var = deref(pvar);
+    if (is_exported(var)) {
+      exports.push_back({SymbolKind::Variable,
+                         var.access(),
+                         var.name(),
+                         std::string{type_spelling(var.type())},
+                         var.is_mutable()});
+    }
+  }
+
+  for (auto& pstruct : tree.structs()) {
+    auto& strct = deref(pstruct);
+    if (is_exported(strct)) {
+      exports.push_back({SymbolKind::Struct, strct.access(), strct.name(), structure_detail(strct)});
+    }
+  }
+
+  for (auto& pobject : tree.objects()) {
+    auto& object = deref(pobject);
+    if (is_exported(object)) {
+      exports.push_back(
+          {SymbolKind::Object, object.access(), object.name(), structure_detail(object)});
+    }
+  }
+
+  for (auto& pfn : tree.functions()) {
+    auto& fn = deref(pfn);
+    if (is_exported(fn)) {
+      exports.push_back({SymbolKind::Function, fn.access(), fn.name(), function_detail(fn)});
+    }
+  }
+
+  return exports;
+}
+
+auto collect_private_names(const SyntaxTree& tree) -> std::vector<std::string> {
+  auto names = std::vector<std::string>{};
+  auto add   = [&](const BaseDefinition& def) {
+    if (!is_exported(def)) {
+      names.emplace_back(def.name());
+    }
+  };
+
+  for (auto& pvar : tree.variables()) {
+    add(deref(pvar));
+  }
+  for (auto& pstruct : tree.structs()) {
+    add(deref(pstruct));
+  }
+  for (auto& pobject : tree.objects()) {
+    add(deref(pobject));
+  }
+  for (auto& pfn : tree.functions()) {
+    add(deref(pfn));
+  }
+  return names;
+}
+
+auto create_source_record(const SyntaxTree& tree) -> SourceRecord {
+  auto record = SourceRecord{};
+
+  if (!tree.namespaces().empty() && tree.namespaces()[0]) {
+    record.name_space = tree.namespaces()[0]->full_name();
+  }
+
+  for (auto& pimport : tree.imports()) {
+    record.imports.push_back(deref(pimport).full_name());
+  }
+
+  record.exports  = collect_exports(tree);
+  record.privates = collect_private_names(tree);
+  return record;
+}
+
+/* SourceRecord */
+
+constexpr auto field_separator = '\t';
+
+auto SourceRecord::surface_hash() const -> ContentHash {
+  auto hash = hash_content(name_space);
+  for (auto& symbol : exports) {
+    const auto header = std::array<char, 4>{static_cast<char>(symbol.kind),
+                                            static_cast<char>(symbol.access),
+                                            static_cast<char>(symbol.is_mutable), field_separator};
+    hash = hash_content({header.data(), header.size()}, hash);
+    hash = hash_content(symbol.name, hash);
+    hash = hash_content({&field_separator, 1}, hash);
+    hash = hash_content(symbol.detail, hash);
+  }
+  return hash;
+}
+
+constexpr auto namespace_seperator = std::string_view{"::"};
+
+auto SourceRecord::sees(std::string_view ns) const -> bool {
+  // Namespace headers include their parent header, so everything sees its enclosing namespaces.
+  if (ns.empty() || name_space == ns) {
+    return true;
+  }
+  if (name_space.starts_with(ns) && name_space.substr(ns.size()).starts_with(namespace_seperator)) {
+    return true;
+  }
+  return std::find(imports.begin(), imports.end(), ns) != imports.end();
+}
+
+auto module_key(std::string_view name_space, std::string_view name) -> std::string {
+  if (name_space.empty()) {
+    return std::string{name};
+  }
+  return std::string{name_space}.append(namespace_seperator).append(name);
+}
+
+/* DependencyDatabase */
+
+constexpr auto database_file_name = std::string_view{"dependencies.manifest"};
+constexpr auto database_header    = std::string_view{"typhon-dependencies 4"};
+
+constexpr auto reference_tag      = std::string_view{"reference"};
+constexpr auto source_tag         = std::string_view{"source"};
+constexpr auto namespace_tag      = std::string_view{"namespace"};
+constexpr auto import_tag         = std::string_view{"import"};
+constexpr auto export_tag         = std::string_view{"export"};
+constexpr auto private_tag        = std::string_view{"private"};
+constexpr auto use_tag            = std::string_view{"use"};
+constexpr auto header_use_tag     = std::string_view{"header_use"};
+constexpr auto eliminated_tag     = std::string_view{"eliminated"};
+
+auto split_fields(std::string_view line) -> std::vector<std::string_view> {
+  auto fields = std::vector<std::string_view>{};
+  while (true) {
+    const auto split = line.find(field_separator);
+    fields.push_back(line.substr(0, split));
+    if (split == std::string_view::npos) {
+      return fields;
+    }
+    line.remove_prefix(split + 1);
+  }
+}
+
+auto parse_integer(std::string_view field) -> int64_t {
+  auto value = int64_t{0};
+  std::from_chars(field.data(), field.data() + field.size(), value);
+  return value;
+}
+
+DependencyDatabase::DependencyDatabase(const ProjectConfig& config)
+    : path_{config.dir_build() / database_file_name} {
+  auto stream = std::ifstream{path_};
+  auto line   = std::string{};
+
+  // A database written by another format version is ignored, which forces a full rebuild.
+  if (!std::getline(stream, line) || line != database_header) {
+    return;
+  }
+
+  SourceRecord* record = nullptr;
+  while (std::getline(stream, line)) {
+    const auto fields = split_fields(line);
+    const auto tag    = fields[0];
+
+    if (tag == reference_tag && fields.size() == 3) {
+      if (auto hash = from_hex(fields[2])) {
+        references_[std::string{fields[1]}] = *hash;
+      }
+    } else if (tag == source_tag && fields.size() == 5) {
+      auto hash = from_hex(fields[2]);
+      if (!hash) {
+        record = nullptr;
+        continue;
+      }
+      record               = &records_[std::string{fields[1]}];
+      record->content_hash = *hash;
+      record->size         = static_cast<uint64_t>(parse_integer(fields[3]));
+      record->write_time   = parse_integer(fields[4]);
+    } else if (!record) {
+      continue;
+    } else if (tag == namespace_tag && fields.size() == 2) {
+      record->name_space = fields[1];
+    } else if (tag == import_tag && fields.size() == 2) {
+      record->imports.emplace_back(fields[1]);
+    } else if (tag == export_tag && fields.size() == 6) {
+      record->exports.push_back({static_cast<SymbolKind>(parse_integer(fields[1])),
+                                 static_cast<AccessModifier>(parse_integer(fields[2])),
+                                 std::string{fields[3]}, std::string{fields[4]},
+                                 parse_integer(fields[5]) != 0});
+    } else if (tag == private_tag && fields.size() == 2) {
+      record->privates.emplace_back(fields[1]);
+    } else if (tag == use_tag && fields.size() == 2) {
+      record->uses.emplace_back(fields[1]);
+    } else if (tag == header_use_tag && fields.size() == 2) {
+      record->header_uses.emplace_back(fields[1]);
+    } else if (tag == eliminated_tag && fields.size() == 2) {
+      record->eliminated.emplace_back(fields[1]);
+    }
+  }
+}
+
+auto DependencyDatabase::find(const SourceContext& source) const -> const SourceRecord* {
+  auto it = records_.find(source.rel_path().generic_string());
+  return it != records_.end() ? &it->second : nullptr;
+}
+
+auto DependencyDatabase::find(const SourceContext& source) -> SourceRecord* {
+  auto it = records_.find(source.rel_path().generic_string());
+  return it != records_.end() ? &it->second : nullptr;
+}
+
+auto DependencyDatabase::update(const SourceContext& source, SourceRecord record)
+    -> const SourceRecord& {
+  return records_[source.rel_path().generic_string()] = std::move(record);
+}
+
+auto DependencyDatabase::erase(const std::string& rel_path) -> void { records_.erase(rel_path); }
+
+auto DependencyDatabase::save() const -> void {
+  fs::create_directories(path_.parent_path());
+  auto stream = std::ofstream{path_};
+  stream << database_header << newline;
+
+  for (auto& [name, hash] : references_) {
+    stream << reference_tag << field_separator << name << field_separator << to_hex(hash)
+           << newline;
+  }
+
+  for (auto& [path, record] : records_) {
+    stream << source_tag << field_separator << path << field_separator
+           << to_hex(record.content_hash) << field_separator << record.size << field_separator
+           << record.write_time << newline;
+
+    if (!record.name_space.empty()) {
+      stream << namespace_tag << field_separator << record.name_space << newline;
+    }
+
+    for (auto& import : record.imports) {
+      stream << import_tag << field_separator << import << newline;
+    }
+
+    for (auto& symbol : record.exports) {
+      stream << export_tag << field_separator << static_cast<uint32_t>(symbol.kind)
+             << field_separator << static_cast<uint32_t>(symbol.access) << field_separator
+             << symbol.name << field_separator << symbol.detail << field_separator
+             << static_cast<uint32_t>(symbol.is_mutable) << newline;
+    }
+
+    for (auto& name : record.privates) {
+      stream << private_tag << field_separator << name << newline;
+    }
+
+    for (auto& use : record.uses) {
+      stream << use_tag << field_separator << use << newline;
+    }
+
+    for (auto& use : record.header_uses) {
+      stream << header_use_tag << field_separator << use << newline;
+    }
+
+    for (auto& name : record.eliminated) {
+      stream << eliminated_tag << field_separator << name << newline;
+    }
+  }
+}
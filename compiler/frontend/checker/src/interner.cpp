@@ -0,0 +1,44 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "interner.hpp"
+
+auto StringInterner::find(std::string_view value) const -> std::optional<InternId> {
+  auto lock = std::shared_lock{mutex_, std::defer_lock};
+  if (!sealed()) {
+    lock.lock();
+  }
+
+  auto it = ids_.find(value);
+  if (it == ids_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+auto StringInterner::view(InternId id) const -> std::string_view {
+  auto lock = std::shared_lock{mutex_, std::defer_lock};
+  if (!sealed()) {
+    lock.lock();
+  }
+
+  assert(id < strings_.size());
+  return strings_[id];
+}
+
+auto StringInterner::intern(std::string_view value) -> InternId {
+  assert(!sealed());
+  if (auto id = find(value)) {
+    return *id;
+  }
+
+  const auto lock = std::unique_lock{mutex_};
+  if (auto it = ids_.find(value); it != ids_.end()) {
+    return it->second;
+  }
+
+  // Deque growth never moves existing strings, so the keys stay valid.
+  const auto id = static_cast<InternId>(strings_.size());
+  ids_.emplace(strings_.emplace_back(value), id);
+  return id;
+}
@@ -0,0 +1,432 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "interpreter.hpp"
+
+// Bytes a local holds, its value and the key of its definition.
+constexpr auto local_size = sizeof(ConstantValue) + sizeof(const BaseSyntax*);
+
+const auto compound_op_map = std::unordered_map<Operator, Operator>{
+    {Operator::SelfAdd,    Operator::Add     },
+    {Operator::SelfSub,    Operator::Subtract},
+    {Operator::SelfMul,    Operator::Multiply},
+    {Operator::SelfDiv,    Operator::Divide  },
+    {Operator::SelfBitOr,  Operator::BitOr   },
+    {Operator::SelfBitXor, Operator::BitXor  },
+    {Operator::SelfBitAnd, Operator::BitAnd  },
+};
+
+auto resolve_constant_type(const SymbolTable& table,
+                           ScopeId scope,
+                           const Type& type,
+                           const FilePosition& pos) -> std::optional<ConstantType> {
+  if (type.kind() != TypeKind::Named) {
+    return std::nullopt;
+  }
+
+  const auto id = table.resolve(scope, type.name(), pos);
+  if (id == invalid_symbol_id) {
+    return std::nullopt;
+  }
+
+  auto& symbol = table.symbol(id);
+  if (symbol.kind != SymbolKind::CType || symbol.type == nullptr) {
+    return std::nullopt;
+  }
+  return constant_type_of(symbol.type->spelling());
+}
+
+auto Interpreter::callee(const CallExpression& call) const -> const FunctionDefinition* {
+  const auto id = table_.linked(call);
+  if (id == invalid_symbol_id) {
+    return nullptr;
+  }
+
+  auto& symbol = table_.symbol(id);
+  if (symbol.kind != SymbolKind::Function || symbol.syntax == nullptr) {
+    return nullptr;
+  }
+
+  const auto* fn = ptr_cast<const FunctionDefinition>(symbol.syntax);
+  return functions_.contains(fn) ? fn : nullptr;
+}
+
+auto Interpreter::call(const FunctionDefinition& fn, std::span<const ConstantValue> arguments)
+    -> std::optional<ConstantValue> {
+  // Limits apply to the outermost call and everything it calls.
+  if (depth_ == 0) {
+    steps_  = 0;
+    memory_ = 0;
+  }
+  if (!fn.body() || depth_ >= limits_.depth) {
+    return std::nullopt;
+  }
+
+  const auto scope = table_.scope_of(fn);
+  auto frame       = Frame{};
+  auto flow        = Flow::Fail;
+  if (bind(fn, arguments, scope, frame)) {
+    ++depth_;
+    flow = exec_block(*fn.body(), scope, frame);
+    --depth_;
+  }
+  memory_ -= frame.locals.size() * local_size;
+
+  if (flow != Flow::Return || !frame.result) {
+    return std::nullopt;
+  }
+  if (fn.is_return_auto()) {
+    return frame.result;
+  }
+
+  const auto type = resolve_constant_type(table_, scope, *fn.return_type(), fn.pos());
+  return type ? convert(*frame.result, *type) : std::nullopt;
+}
+
+auto Interpreter::step() -> bool { return ++steps_ <= limits_.steps; }
+
+auto Interpreter::define(Frame& frame, const BaseSyntax& node, const ConstantValue& value)
+    -> bool {
+  // Locals of a block run again are redefined in place.
+  auto [it, inserted] = frame.locals.insert_or_assign(&node, value);
+  if (!inserted) {
+    return true;
+  }
+
+  memory_ += local_size;
+  return memory_ <= limits_.memory;
+}
+
+auto Interpreter::bind(const FunctionDefinition& fn,
+                       std::span<const ConstantValue> arguments,
+                       ScopeId scope,
+                       Frame& frame) -> bool {
+  auto& parameters = fn.parameters();
+  if (arguments.size() != parameters.size()) {
+    return false;
+  }
+
+  for (auto i = size_t{0}; i < parameters.size(); ++i) {
+    auto& parameter = deref(parameters[i]);
+    auto value      = std::optional{arguments[i]};
+    if (!parameter.is_type_auto()) {
+      const auto type = resolve_constant_type(table_, scope, *parameter.type(), parameter.pos());
+      value           = type ? convert(arguments[i], *type) : std::nullopt;
+    }
+    if (!value || !define(frame, parameter, *value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto Interpreter::read(const BaseExpression& identifier, const Frame& frame) const
+    -> std::optional<ConstantValue> {
+  if (identifier.kind() != SyntaxKind::ExprIdentifier) {
+    return std::nullopt;
+  }
+
+  const auto id = table_.linked(identifier);
+  if (id == invalid_symbol_id) {
+    return std::nullopt;
+  }
+
+  const auto* definition = table_.symbol(id).syntax;
+  if (auto it = frame.locals.find(definition); it != frame.locals.end()) {
+    return it->second;
+  }
+  if (auto it = constants_.find(definition); it != constants_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+// Only locals of the running frame can be assigned, stores convert to the type of the local.
+auto Interpreter::write(const BaseExpression& target, const ConstantValue& value, Frame& frame)
+    -> std::optional<ConstantValue> {
+  if (target.kind() != SyntaxKind::ExprIdentifier) {
+    return std::nullopt;
+  }
+
+  const auto id = table_.linked(target);
+  if (id == invalid_symbol_id) {
+    return std::nullopt;
+  }
+
+  auto it = frame.locals.find(table_.symbol(id).syntax);
+  if (it == frame.locals.end()) {
+    return std::nullopt;
+  }
+
+  auto stored = convert(value, it->second.type);
+  if (stored) {
+    it->second = *stored;
+  }
+  return stored;
+}
+
+auto Interpreter::eval(const BaseExpression& expr, Frame& frame) -> std::optional<ConstantValue> {
+  if (!step()) {
+    return std::nullopt;
+  }
+
+  switch (expr.kind()) {
+    case SyntaxKind::ExprBool: {
+      return ConstantValue{ConstantType::Bool, ref_cast<const BooleanExpression>(expr).value()};
+    }
+    case SyntaxKind::ExprNumber: {
+      return parse_literal(ref_cast<const NumberExpression>(expr).value());
+    }
+    case SyntaxKind::ExprIdentifier: {
+      return read(expr, frame);
+    }
+    case SyntaxKind::ExprCall: {
+      return eval_call(ref_cast<const CallExpression>(expr), frame);
+    }
+    case SyntaxKind::ExprUnary: {
+      return eval_unary(ref_cast<const UnaryExpression>(expr), frame);
+    }
+    case SyntaxKind::ExprBinary: {
+      return eval_binary(ref_cast<const BinaryExpression>(expr), frame);
+    }
+    default: {
+      return std::nullopt;
+    }
+  }
+}
+
+auto Interpreter::eval_call(const CallExpression& call, Frame& frame)
+    -> std::optional<ConstantValue> {
+  const auto* fn = callee(call);
+  if (fn == nullptr) {
+    return std::nullopt;
+  }
+
+  auto arguments = std::vector<ConstantValue>{};
+  arguments.reserve(call.parameters().size());
+  for (auto& parameter : call.parameters()) {
+    auto argument = eval(deref(parameter), frame);
+    if (!argument) {
+      return std::nullopt;
+    }
+    arguments.push_back(*argument);
+  }
+  return this->call(*fn, arguments);
+}
+
+auto Interpreter::eval_unary(const UnaryExpression& expr, Frame& frame)
+    -> std::optional<ConstantValue> {
+  const auto op = expr.op();
+  if (!is_increment(op)) {
+    const auto operand = eval(deref(expr.expr()), frame);
+    return operand ? evaluate(op, *operand) : std::nullopt;
+  }
+
+  const auto& target = deref(expr.expr());
+  const auto current = read(target, frame);
+  if (!current) {
+    return std::nullopt;
+  }
+
+  const auto step_op = op == Operator::PreInc || op == Operator::PostInc ? Operator::Add
+                                                                         : Operator::Subtract;
+  const auto next    = evaluate(step_op, *current, ConstantValue{ConstantType::I32, int64_t{1}});
+  const auto stored  = next ? write(target, *next, frame) : std::nullopt;
+  if (!stored) {
+    return std::nullopt;
+  }
+  return op == Operator::PreInc || op == Operator::PreDec ? stored : current;
+}
+
+auto Interpreter::eval_binary(const BinaryExpression& expr, Frame& frame)
+    -> std::optional<ConstantValue> {
+  const auto op = expr.op();
+  if (op == Operator::Static || op == Operator::Access) {
+    return std::nullopt;
+  }
+
+  if (is_assignment(op)) {
+    const auto& target = deref(expr.lhs());
+    auto value         = eval(deref(expr.rhs()), frame);
+    if (value && op != Operator::Assign) {
+      auto compound      = compound_op_map.find(op);
+      const auto current = read(target, frame);
+      if (compound == compound_op_map.end() || !current) {
+        return std::nullopt;
+      }
+      value = evaluate(compound->second, *current, *value);
+    }
+    return value ? write(target, *value, frame) : std::nullopt;
+  }
+
+  const auto lhs = eval(deref(expr.lhs()), frame);
+  if (!lhs) {
+    return std::nullopt;
+  }
+
+  // The right side of && and || only runs when the left side does not decide the result.
+  if (op == Operator::And && !to_bool(*lhs)) {
+    return ConstantValue{ConstantType::Bool, false};
+  }
+  if (op == Operator::Or && to_bool(*lhs)) {
+    return ConstantValue{ConstantType::Bool, true};
+  }
+
+  const auto rhs = eval(deref(expr.rhs()), frame);
+  return rhs ? evaluate(op, *lhs, *rhs) : std::nullopt;
+}
+
+auto Interpreter::exec_variable(const VariableDefinition& var, ScopeId scope, Frame& frame)
+    -> Flow {
+  if (!var.is_assigned()) {
+    return Flow::Fail;
+  }
+
+  auto value = eval(*var.assignment(), frame);
+  if (value && var.is_typed()) {
+    const auto type = resolve_constant_type(table_, scope, *var.type(), var.pos());
+    value           = type ? convert(*value, *type) : std::nullopt;
+  }
+  return value && define(frame, var, *value) ? Flow::Next : Flow::Fail;
+}
+
+auto Interpreter::exec_statement(const BaseStatement& stmt, ScopeId scope, Frame& frame) -> Flow {
+  switch (stmt.kind()) {
+    case SyntaxKind::StmtDef: {
+      auto& def = deref(ref_cast<const DefinitionStatement>(stmt).def());
+      if (def.kind() != SyntaxKind::DefVar) {
+        return Flow::Fail;
+      }
+      return exec_variable(ref_cast<const VariableDefinition>(def), scope, frame);
+    }
+    case SyntaxKind::StmtExpr: {
+      auto& expr = ref_cast<const ExpressionStatement>(stmt).expr();
+      return !expr || eval(*expr, frame) ? Flow::Next : Flow::Fail;
+    }
+    case SyntaxKind::StmtRet: {
+      auto& expr = ref_cast<const ReturnStatement>(stmt).expr();
+      if (!expr) {
+        return Flow::Fail;
+      }
+      frame.result = eval(*expr, frame);
+      return frame.result ? Flow::Return : Flow::Fail;
+    }
+    case SyntaxKind::StmtLoop: {
+      auto& body = deref(ref_cast<const LoopStatement>(stmt).body());
+      while (true) {
+        if (auto flow = exec_block(body, scope, frame); flow != Flow::Next) {
+          return flow;
+        }
+      }
+    }
+    case SyntaxKind::StmtWhile: {
+      auto& loop = ref_cast<const WhileStatement>(stmt);
+      while (true) {
+        const auto condition = eval(deref(loop.expr()), frame);
+        if (!condition) {
+          return Flow::Fail;
+        }
+        if (!to_bool(*condition)) {
+          return Flow::Next;
+        }
+        if (auto flow = exec_block(deref(loop.body()), scope, frame); flow != Flow::Next) {
+          return flow;
+        }
+      }
+    }
+    case SyntaxKind::StmtFor: {
+      auto& loop = ref_cast<const ForStatement>(stmt);
+      auto inner = table_.scope_of(loop);
+      if (inner == invalid_scope_id) {
+        inner = scope;
+      }
+
+      if (loop.prefix()) {
+        if (auto flow = exec_statement(*loop.prefix(), inner, frame); flow != Flow::Next) {
+          return flow;
+        }
+      }
+
+      while (true) {
+        if (loop.cond()) {
+          const auto condition = eval(*loop.cond(), frame);
+          if (!condition) {
+            return Flow::Fail;
+          }
+          if (!to_bool(*condition)) {
+            return Flow::Next;
+          }
+        }
+        if (auto flow = exec_block(deref(loop.body()), inner, frame); flow != Flow::Next) {
+          return flow;
+        }
+        if (loop.postfix() && !eval(*loop.postfix(), frame)) {
+          return Flow::Fail;
+        }
+      }
+    }
+    default: {
+      return Flow::Fail;
+    }
+  }
+}
+
+auto Interpreter::exec_block(const StatementBlock& block, ScopeId scope, Frame& frame) -> Flow {
+  // Every run of a block is a step, so loops with an empty body still end.
+  if (!step()) {
+    return Flow::Fail;
+  }
+  if (const auto inner = table_.scope_of(block); inner != invalid_scope_id) {
+    scope = inner;
+  }
+
+  // If, elif and else are siblings, taken tells the rest of a chain whether a branch already ran.
+  auto taken = false;
+  for (auto& pstmt : block.statements()) {
+    if (!step()) {
+      return Flow::Fail;
+    }
+
+    auto& stmt = *pstmt;
+    switch (stmt.kind()) {
+      case SyntaxKind::StmtIf:
+      case SyntaxKind::StmtElif: {
+        if (stmt.kind() == SyntaxKind::StmtElif && taken) {
+          continue;
+        }
+
+        auto& conditional    = ref_cast<const IfStatement>(stmt);
+        const auto condition = eval(deref(conditional.expr()), frame);
+        if (!condition) {
+          return Flow::Fail;
+        }
+
+        taken = to_bool(*condition);
+        if (taken) {
+          if (auto flow = exec_block(deref(conditional.body()), scope, frame);
+              flow != Flow::Next) {
+            return flow;
+          }
+        }
+        break;
+      }
+      case SyntaxKind::StmtElse: {
+        if (!taken) {
+          auto& otherwise = ref_cast<const ElseStatement>(stmt);
+          if (auto flow = exec_block(deref(otherwise.body()), scope, frame); flow != Flow::Next) {
+            return flow;
+          }
+        }
+        taken = true;
+        break;
+      }
+      default: {
+        if (auto flow = exec_statement(stmt, scope, frame); flow != Flow::Next) {
+          return flow;
+        }
+        break;
+      }
+    }
+  }
+  return Flow::Next;
+}
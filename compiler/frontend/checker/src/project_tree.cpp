@@ -2,3 +2,122 @@
 // All Rights Reserved.
 
 #include "project_tree.hpp"
+#include "symbol_table.hpp"
+
+constexpr auto namespace_seperator = std::string_view{"::"};
+constexpr auto file_name_seperator = std::string_view{"."};
+
+NameSpace::NameSpace()
+    : file_name_{gen_hdr_file_ext} {}
+
+NameSpace::NameSpace(NameSpace& parent, std::string name)
+    : parent_{&parent},
+      name_{std::move(name)} {
+  if (parent.full_name().empty()) {
+    full_name_ = name_;
+    file_name_ = name_;
+  } else {
+    full_name_ = std::string{parent.full_name()}.append(namespace_seperator).append(name_);
+
+    // The parent file name carries the header extension, only its stem is reused.
+    file_name_ = parent.file_name().substr(0, parent.file_name().size() - gen_hdr_file_ext.size());
+    file_name_.append(file_name_seperator).append(name_);
+  }
+  file_name_.append(gen_hdr_file_ext);
+}
+
+auto namespace_file_name(std::string_view full_name) -> std::string {
+  auto file_name = std::string{};
+  while (true) {
+    const auto split = full_name.find(namespace_seperator);
+    file_name.append(full_name.substr(0, split));
+    if (split == std::string_view::npos) {
+      break;
+    }
+    file_name.append(file_name_seperator);
+    full_name.remove_prefix(split + namespace_seperator.size());
+  }
+  return file_name.append(gen_hdr_file_ext);
+}
+
+auto NameSpace::find_sub_space(std::string_view name) const -> NameSpace* {
+  const auto lock = std::shared_lock{mutex_};
+  auto it         = sub_space_index_.find(name);
+  return it != sub_space_index_.end() ? it->second : nullptr;
+}
+
+auto NameSpace::get_or_create_sub_space(std::string_view name) -> NameSpace& {
+  if (auto* sub = find_sub_space(name)) {
+    return *sub;
+  }
+
+  const auto lock = std::unique_lock{mutex_};
+
+  // Another worker may have created it between releasing the shared and taking the unique lock.
+  if (auto it = sub_space_index_.find(name); it != sub_space_index_.end()) {
+    return *it->second;
+  }
+
+  auto& sub = *sub_spaces_.emplace_back(std::make_unique<NameSpace>(*this, std::string{name}));
+  sub_space_index_.emplace(sub.name(), &sub);
+  return sub;
+}
+
+auto NameSpace::push_tree(std::unique_ptr<SyntaxTree> tree) -> void {
+  const auto lock = std::unique_lock{mutex_};
+  syntax_trees_.emplace_back(std::move(tree));
+}
+
+auto NameSpace::push_retained(RetainedSource source) -> void {
+  const auto lock = std::unique_lock{mutex_};
+  retained_.emplace_back(std::move(source));
+}
+
+auto NameSpace::sources() const -> std::vector<const SourceContext*> {
+  auto sources = std::vector<const SourceContext*>{};
+  sources.reserve(syntax_trees_.size() + retained_.size());
+
+  for (auto& ptree : syntax_trees_) {
+    sources.push_back(deref(ptree).source().get());
+  }
+  for (auto& retained : retained_) {
+    sources.push_back(retained.source.get());
+  }
+
+  std::sort(sources.begin(), sources.end(), [](auto* lhs, auto* rhs) {
+    return lhs->rel_path() < rhs->rel_path();
+  });
+  return sources;
+}
+
+auto NameSpace::sort() -> void {
+  std::sort(sub_spaces_.begin(), sub_spaces_.end(), [](auto& lhs, auto& rhs) {
+    return lhs->name() < rhs->name();
+  });
+
+  std::sort(syntax_trees_.begin(), syntax_trees_.end(), [](auto& lhs, auto& rhs) {
+    return lhs->source()->rel_path() < rhs->source()->rel_path();
+  });
+
+  std::sort(retained_.begin(), retained_.end(), [](auto& lhs, auto& rhs) {
+    return lhs.source->rel_path() < rhs.source->rel_path();
+  });
+
+  for (auto& sub : sub_spaces_) {
+    sub->sort();
+  }
+}
+
+/* ProjectTree */
+
+ProjectTree::ProjectTree()
+    : root_{std::make_unique<NameSpace>()},
+      types_{std::make_unique<TypeGraph>()} {}
+
+ProjectTree::ProjectTree(ProjectTree&&) noexcept                    = default;
+ProjectTree::~ProjectTree()                                         = default;
+auto ProjectTree::operator=(ProjectTree&&) noexcept -> ProjectTree& = default;
+
+auto ProjectTree::set_symbols(std::unique_ptr<SymbolTable> symbols) -> void {
+  symbols_ = std::move(symbols);
+}
@@ -3,4 +3,183 @@
 
 #include "symbol_table.hpp"
 
-auto SymbolTable::from_project_tree() -> SymbolTable::Pointer { throw_not_implemented(); }
+/* Index */
+
+constexpr auto initial_slot_count = size_t{64};
+
+constexpr auto pack_key(ScopeId scope, InternId name) -> uint64_t {
+  return (static_cast<uint64_t>(scope) << 32) | name;
+}
+
+// Finalizer of splitmix64, spreads packed keys whose halves are small dense ids.
+constexpr auto mix_key(uint64_t key) -> uint64_t {
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111eb;
+  key ^= key >> 31;
+  return key;
+}
+
+SymbolTable::SymbolTable()
+    : slots_(initial_slot_count, invalid_symbol_id) {
+  const auto global = names_.intern({});
+  scopes_.push_back({ScopeKind::Namespace, invalid_scope_id, global, {}});
+  namespace_scopes_.emplace(global, global_scope());
+}
+
+auto SymbolTable::scope_of(const BaseSyntax& syntax) const -> ScopeId {
+  auto it = syntax_scopes_.find(&syntax);
+  return it == syntax_scopes_.end() ? invalid_scope_id : it->second;
+}
+
+auto SymbolTable::namespace_scope(std::string_view full_name) const -> ScopeId {
+  const auto name = names_.find(full_name);
+  if (!name) {
+    return invalid_scope_id;
+  }
+  auto it = namespace_scopes_.find(*name);
+  return it == namespace_scopes_.end() ? invalid_scope_id : it->second;
+}
+
+auto SymbolTable::find(ScopeId scope, InternId name) const -> SymbolId {
+  const auto mask = slots_.size() - 1;
+  for (auto slot = mix_key(pack_key(scope, name)) & mask;; slot = (slot + 1) & mask) {
+    const auto id = slots_[slot];
+    if (id == invalid_symbol_id) {
+      return invalid_symbol_id;
+    }
+    if (auto& symbol = symbols_[id]; symbol.scope == scope && symbol.name == name) {
+      return id;
+    }
+  }
+}
+
+auto is_before(const FilePosition& lhs, const FilePosition& rhs) -> bool {
+  return lhs.line() < rhs.line() || (lhs.line() == rhs.line() && lhs.col() < rhs.col());
+}
+
+auto SymbolTable::resolve(ScopeId scope, std::string_view name, const FilePosition& pos) const
+    -> SymbolId {
+  // A name that was never interned is not declared anywhere.
+  const auto id = names_.find(name);
+  if (!id) {
+    return invalid_symbol_id;
+  }
+
+  for (; scope != invalid_scope_id; scope = scopes_[scope].parent) {
+    auto& current = scopes_[scope];
+
+    if (auto symbol = find(scope, *id); symbol != invalid_symbol_id) {
+      // Locals are only visible after their declaration.
+      auto& found      = symbols_[symbol];
+      const auto local = current.kind == ScopeKind::Function || current.kind == ScopeKind::Block;
+      if (!local || found.syntax == nullptr || is_before(found.syntax->pos(), pos)) {
+        return symbol;
+      }
+    }
+
+    for (auto imported : current.imports) {
+      if (auto symbol = find(imported, *id); symbol != invalid_symbol_id) {
+        return symbol;
+      }
+    }
+  }
+  return invalid_symbol_id;
+}
+
+auto SymbolTable::linked(const BaseSyntax& syntax) const -> SymbolId {
+  auto it = links_.find(&syntax);
+  return it == links_.end() ? invalid_symbol_id : it->second;
+}
+
+auto SymbolTable::add_scope(ScopeKind kind, ScopeId parent, InternId name) -> ScopeId {
+  const auto id = static_cast<ScopeId>(scopes_.size());
+  scopes_.push_back({kind, parent, name, {}});
+  return id;
+}
+
+auto SymbolTable::add_namespace_scope(ScopeId parent,
+                                      std::string_view name,
+                                      std::string_view full_name) -> ScopeId {
+  const auto id = add_scope(ScopeKind::Namespace, parent, names_.intern(name));
+  namespace_scopes_.emplace(names_.intern(full_name), id);
+  return id;
+}
+
+auto SymbolTable::declare(const Symbol& symbol) -> std::pair<SymbolId, bool> {
+  if (auto existing = find(symbol.scope, symbol.name); existing != invalid_symbol_id) {
+    return {existing, false};
+  }
+
+  // Keep the load factor at or below one half so probe sequences stay short.
+  if ((symbols_.size() + 1) * 2 > slots_.size()) {
+    grow();
+  }
+
+  const auto id   = static_cast<SymbolId>(symbols_.size());
+  const auto mask = slots_.size() - 1;
+  auto slot       = mix_key(pack_key(symbol.scope, symbol.name)) & mask;
+  while (slots_[slot] != invalid_symbol_id) {
+    slot = (slot + 1) & mask;
+  }
+  slots_[slot] = id;
+  symbols_.push_back(symbol);
+  return {id, true};
+}
+
+auto SymbolTable::grow() -> void {
+  slots_.assign(slots_.size() * 2, invalid_symbol_id);
+
+  const auto mask = slots_.size() - 1;
+  for (auto id = SymbolId{0}; id < symbols_.size(); ++id) {
+    auto& symbol = symbols_[id];
+    auto slot    = mix_key(pack_key(symbol.scope, symbol.name)) & mask;
+    while (slots_[slot] != invalid_symbol_id) {
+      slot = (slot + 1) & mask;
+    }
+    slots_[slot] = id;
+  }
+}
+
+auto SymbolTable::merge(const DeclarationBatch& batch) -> bool {
+  const auto base = static_cast<ScopeId>(scopes_.size());
+
+  // Only the file scope has no local parent, it hangs off the namespace of the batch.
+  for (auto& scope : batch.scopes) {
+    const auto parent = scope.parent == invalid_scope_id ? batch.parent : base + scope.parent;
+    scopes_.push_back({scope.kind, parent, scope.name, scope.imports});
+  }
+
+  for (auto& [syntax, scope] : batch.bindings) {
+    syntax_scopes_.emplace(syntax, base + scope);
+  }
+
+  auto merged      = true;
+  auto declare_all = [&](std::span<const Symbol> symbols, bool local) {
+    for (auto symbol : symbols) {
+      if (local) {
+        symbol.scope = base + symbol.scope;
+      }
+      if (declare(symbol).second) {
+        continue;
+      }
+
+      std::cerr << "Error : \"" << names_.view(symbol.name) << "\" is already declared "
+                << deref(batch.source).rel_path().string();
+      if (symbol.syntax != nullptr) {
+        std::cerr << ' ' << symbol.syntax->pos();
+      }
+      std::cerr << std::endl;
+      merged = false;
+    }
+  };
+
+  declare_all(batch.module_symbols, false);
+  declare_all(batch.symbols, true);
+  return merged;
+}
+
+auto SymbolTable::merge_links(std::span<const SymbolLink> links) -> void {
+  links_.insert(links.begin(), links.end());
+}
@@ -6,6 +6,7 @@
 #include "lexer_sm.hpp"
 
 #include "timer.hpp"
+#include "profiler.hpp"
 
 auto lex(SourceContext::Pointer source) -> const TokenCollection {
   auto lexer   = Lexer{};
@@ -13,6 +14,7 @@ auto lex(SourceContext::Pointer source) -> const TokenCollection {
 
   {
     TRACE_TIMER("Lexer");
+    PROFILE_SCOPE("Lex", source->rel_path());
     lexer.run(context);
   }
 
@@ -9,4 +9,7 @@
 
 #include "syntax_tree.hpp"
 
-auto parse(const TokenCollection& tokens) -> std::unique_ptr<SyntaxTree>;
\ No newline at end of file
+/**
+ * Parses the tokens of a single source, types are added to the graph shared by every source
+ */
+auto parse(const TokenCollection& tokens, TypeGraph& types) -> std::unique_ptr<SyntaxTree>;
\ No newline at end of file
@@ -7,12 +7,14 @@
 #error
 #endif  //__cplusplus
 
+#include <functional>
 #include <string>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "token.hpp"
+#include "type_graph.hpp"
 #include "xml/serialization.hpp"
 
 /*
@@ -208,6 +210,16 @@ constexpr auto get_precedence(Operator op) -> Precedence {
       operator_prec_offset);
 }
 
+constexpr auto is_assignment(Operator op) -> bool {
+  return get_operator_type(op) == OperatorType::Binary &&
+         get_precedence(op) == Precedence::Assignment;
+}
+
+constexpr auto is_increment(Operator op) -> bool {
+  return op == Operator::PreInc || op == Operator::PreDec || op == Operator::PostInc ||
+         op == Operator::PostDec;
+}
+
 auto get_unary_pre_op(LexicalKind kind) -> Operator;
 
 auto get_binary_op(LexicalKind kind) -> Operator;
@@ -438,6 +450,10 @@ class CallExpression final : public BaseExpression {
     parameters_.emplace_back(std::move(parameter));
   }
 
+  auto set_parameter(size_t index, BaseExpression::Pointer parameter) -> void {
+    parameters_[index] = std::move(parameter);
+  }
+
  protected:
   auto xml_append_elements(xml::document& doc, xml::node& node) const -> void override;
   auto xml_node_name(xml::document& doc) const -> std::string_view override;
@@ -558,6 +574,7 @@ class StatementBlock final : public BaseSyntax {
       : BaseSyntax(SyntaxKind::Block, pos) {}
 
   NODISCARD auto& statements() const { return statements_; }
+  NODISCARD auto& statements() { return statements_; }
 
   auto push_statement(Statement statement) -> void {
     statements_.emplace_back(std::move(statement));
@@ -635,6 +652,7 @@ class BaseBodyStatement : public BaseStatement {
 
  public:
   NODISCARD auto& body() const { return block_; }
+  NODISCARD auto& body() { return block_; }
 
   auto set_body(StatementBlock::Pointer block) { block_ = std::move(block); }
 
@@ -662,6 +680,7 @@ class IfStatement : public BaseBodyStatement {
       : BaseBodyStatement{SyntaxKind::StmtIf, pos} {}
 
   NODISCARD auto& expr() const { return expr_; }
+  NODISCARD auto& expr() { return expr_; }
 
   auto set_expr(BaseExpression::Pointer expr) -> void { expr_ = std::move(expr); }
 
@@ -887,7 +906,7 @@ class VariableDefinition final : public BaseDefinition {
  private:
   using Assignment = std::unique_ptr<BaseExpression>;
 
-  std::string type_name_;
+  const Type* type_ = nullptr;
   Assignment assignment_;
   bool mutable_ = false;
 
@@ -896,14 +915,17 @@ class VariableDefinition final : public BaseDefinition {
       : BaseDefinition{SyntaxKind::DefVar, pos} {}
 
  public:
-  NODISCARD auto& type_name() const { return type_name_; }
+  /**
+   * Declared type, null when it is deduced from the assignment
+   */
+  NODISCARD auto type() const { return type_; }
   NODISCARD auto& assignment() const { return assignment_; }
 
-  NODISCARD auto is_typed() const { return !type_name_.empty(); }
+  NODISCARD auto is_typed() const { return type_ != nullptr; }
   NODISCARD auto is_assigned() const { return assignment_ != nullptr; }
   NODISCARD auto is_mutable() const { return mutable_; }
 
-  auto set_type_name(const std::string& type_name) noexcept -> void { type_name_ = type_name; }
+  auto set_type(const Type* type) noexcept -> void { type_ = type; }
 
   auto set_assignment(Assignment assignment) noexcept -> void {
     assignment_ = std::move(assignment);
@@ -924,17 +946,17 @@ class FunctionParameter final : public BaseDefinition {
   using Pointer = std::unique_ptr<FunctionParameter>;
 
  private:
-  std::string type_name_;
+  const Type* type_ = nullptr;
 
  public:
   explicit FunctionParameter(const FilePosition& pos, const std::string& name)
       : BaseDefinition{SyntaxKind::DefParam, pos, name} {}
 
-  NODISCARD auto& type_name() const { return type_name_; }
+  NODISCARD auto type() const { return type_; }
 
-  NODISCARD auto is_type_auto() const { return type_name_.empty(); }
+  NODISCARD auto is_type_auto() const { return type_ == nullptr; }
 
-  auto set_type_name(const std::string& type_name) noexcept -> void { type_name_ = type_name; }
+  auto set_type(const Type* type) noexcept -> void { type_ = type; }
 };
 
 /**
@@ -951,7 +973,7 @@ class FunctionDefinition final : public BaseDefinition {
 
  private:
   ParameterCollection parameters_;
-  std::string return_;
+  const Type* return_ = nullptr;
   Body body_;
 
  public:
@@ -959,12 +981,12 @@ class FunctionDefinition final : public BaseDefinition {
       : BaseDefinition{SyntaxKind::DefFunc, pos} {}
 
   NODISCARD auto& parameters() const { return parameters_; }
-  NODISCARD auto& return_type() const { return return_; }
+  NODISCARD auto return_type() const { return return_; }
   NODISCARD auto& body() const { return body_; }
 
-  NODISCARD auto is_return_auto() const { return return_.empty(); }
+  NODISCARD auto is_return_auto() const { return return_ == nullptr; }
 
-  void set_return_type(const std::string& ret_type) { return_ = ret_type; }
+  void set_return_type(const Type* ret_type) { return_ = ret_type; }
 
   void push_parameter(Parameter param) { parameters_.emplace_back(std::move(param)); }
 
@@ -1151,6 +1173,19 @@ auto operator<<(std::ostream& stream, const SyntaxTree& tree) -> std::ostream&;
 
 using SyntaxTreeCollection = std::vector<std::unique_ptr<SyntaxTree>>;
 
+/*
+ * Traversal
+ */
+
+using SyntaxVisitor = std::function<void(const BaseSyntax&)>;
+
+/**
+ * Invokes the visitor on each direct child of the node, absent children are skipped
+ */
+auto for_each_child(const BaseSyntax& node, const SyntaxVisitor& visitor) -> void;
+
+auto count_syntax_nodes(const BaseSyntax& node) -> size_t;
+
 /*
  * Concepts
  */
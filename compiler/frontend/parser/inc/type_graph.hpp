@@ -0,0 +1,122 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include <atomic>
+#include <deque>
+#include <shared_mutex>
+
+#include "common.hpp"
+
+enum class TypeKind {
+  Named,
+  Pointer,
+  Array,
+  Optional,
+  Generic
+};
+
+auto to_string(TypeKind kind) -> std::string_view;
+
+/**
+ * Type
+ * \brief Node of the type graph, each distinct type exists once so types compare by address
+ *
+ * Composite types refer to their element or arguments, never to a copy of them. The spelling is
+ * canonical, T, T*, T[N], T[], T? or G<A,B>, and is used as the key of the node.
+ */
+class Type final {
+  friend class TypeGraph;
+
+  TypeKind kind_;
+  std::string spelling_;
+  std::string name_;
+  const Type* element_ = nullptr;
+  size_t extent_       = 0;
+  std::vector<const Type*> arguments_;
+
+  Type(TypeKind kind,
+       std::string spelling,
+       std::string name,
+       const Type* element,
+       size_t extent,
+       std::vector<const Type*> arguments);
+
+ public:
+  NODISCARD auto kind() const { return kind_; }
+  NODISCARD auto spelling() const -> std::string_view { return spelling_; }
+
+  /**
+   * Name of a named or generic type, empty otherwise
+   */
+  NODISCARD auto name() const -> std::string_view { return name_; }
+
+  /**
+   * Pointee, array element or optional value, null for named and generic types
+   */
+  NODISCARD auto element() const { return element_; }
+
+  /**
+   * Element count of an array, 0 when the array is unsized
+   */
+  NODISCARD auto extent() const { return extent_; }
+
+  NODISCARD auto& arguments() const { return arguments_; }
+};
+
+/**
+ * Spelling of a declared type, empty when the type is deduced
+ */
+inline auto type_spelling(const Type* type) -> std::string_view {
+  return type == nullptr ? std::string_view{} : type->spelling();
+}
+
+/**
+ * TypeGraph
+ * \brief Hash consing store of every type of a project
+ *
+ * Parse workers add types concurrently, lookups of existing types only take a shared lock. Once
+ * sealed the graph is read only and lookups take no lock at all.
+ */
+class TypeGraph final {
+  std::deque<Type> types_;
+  std::unordered_map<std::string_view, const Type*> index_;
+  mutable std::shared_mutex mutex_;
+  std::atomic_bool sealed_ = false;
+
+ public:
+  TypeGraph() = default;
+
+  TypeGraph(const TypeGraph&)                    = delete;
+  auto operator=(const TypeGraph&) -> TypeGraph& = delete;
+
+  NODISCARD auto size() const { return types_.size(); }
+  NODISCARD auto sealed() const { return sealed_.load(std::memory_order_acquire); }
+
+  /**
+   * Returns the type of a canonical spelling, null when it was never added
+   */
+  NODISCARD auto find(std::string_view spelling) const -> const Type*;
+
+  auto named(std::string_view name) -> const Type*;
+  auto pointer(const Type& element) -> const Type*;
+  auto array(const Type& element, size_t extent = 0) -> const Type*;
+  auto optional(const Type& element) -> const Type*;
+  auto generic(std::string_view name, const std::vector<const Type*>& arguments) -> const Type*;
+
+  /**
+   * Adds the type of a spelling and every type it is built from, null when the spelling is empty
+   * or malformed
+   */
+  auto parse(std::string_view spelling) -> const Type*;
+
+  auto seal() -> void { sealed_.store(true, std::memory_order_release); }
+
+ private:
+  auto insert(Type type) -> const Type*;
+};
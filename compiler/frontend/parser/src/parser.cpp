@@ -7,13 +7,15 @@
 #include "parser_sm.hpp"
 
 #include "timer.hpp"
+#include "profiler.hpp"
 
-auto parse(const TokenCollection& tokens) -> std::unique_ptr<SyntaxTree> {
+auto parse(const TokenCollection& tokens, TypeGraph& types) -> std::unique_ptr<SyntaxTree> {
   auto parser  = Parser{};
-  auto context = ParserContext{tokens};
+  auto context = ParserContext{tokens, types};
 
   {
     TRACE_TIMER("Parser");
+    PROFILE_SCOPE("Parse", deref(tokens.source()).rel_path());
     parser.run(context);
   }
 
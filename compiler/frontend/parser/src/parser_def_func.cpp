@@ -64,7 +64,7 @@ auto func_def_return_name_handler_(ParserContext& ctx) -> ParserState {
   auto& current = ctx.current();
   assert(is_identifier(current));
 
-  ctx.get_syntax_node<FunctionDefinition>().set_return_type(current.value());
+  ctx.get_syntax_node<FunctionDefinition>().set_return_type(ctx.types().named(current.value()));
 
   return ctx.move_next_state(is_curly_open,
                              func_def_body_start_state,
@@ -132,7 +132,7 @@ auto func_def_param_type_name_handler_(ParserContext& ctx) -> ParserState {
   auto& current = ctx.current();
   assert(is_identifier(current));
 
-  ctx.get_syntax_node<FunctionParameter>().set_type_name(current.value());
+  ctx.get_syntax_node<FunctionParameter>().set_type(ctx.types().named(current.value()));
 
   return func_def_param_end_state;
 }
@@ -202,6 +202,7 @@ auto func_def_start_handler_(ParserContext& ctx) -> ParserState {
   auto& current = ctx.current();
   assert(is_keyword_func(current));
   ctx.syntax_stack.emplace(std::make_unique<FunctionDefinition>(ctx.current().pos()));
+  ctx.pop_access_modifiers<FunctionDefinition>();
   return ctx.move_next_state(is_identifier,
                              func_def_identifier_state,
                              func_def_error_state,
@@ -82,7 +82,7 @@ auto var_def_assign_start_handler_(ParserContext& ctx) -> ParserState {
 auto var_def_type_handler_(ParserContext& ctx) -> ParserState {
   assert(is_identifier(ctx.current()));
 
-  ctx.get_syntax_node<VariableDefinition>().set_type_name(ctx.current().value());
+  ctx.get_syntax_node<VariableDefinition>().set_type(ctx.types().named(ctx.current().value()));
 
   return ctx.move_next_state(
       is_equals, var_def_assign_start_state, var_def_end_state, var_def_unexpected_end_error_state);
@@ -121,6 +121,7 @@ auto var_def_start_handler_(ParserContext& ctx) -> ParserState {
   auto& current = ctx.current();
   assert(is_keyword_var(current));
   ctx.syntax_stack.emplace(std::make_unique<VariableDefinition>(ctx.current().pos()));
+  ctx.pop_access_modifiers<VariableDefinition>();
 
   static constexpr auto conditions = std::array<ParserMatchCondition, 2>{
       ParserMatchCondition{is_identifier,  var_def_name_state},
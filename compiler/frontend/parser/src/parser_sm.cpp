@@ -306,8 +306,9 @@ auto start_handler_(ParserContext& ctx) -> ParserState {
 
 #pragma region Parser Context
 
-ParserContext::ParserContext(const TokenCollection& tokens)
+ParserContext::ParserContext(const TokenCollection& tokens, TypeGraph& types)
     : tokens_{tokens},
+      types_{types},
       started_{false},
       current_{},
       source{std::make_unique<SyntaxTree>(tokens.source())} {}
@@ -30,6 +30,7 @@ class ParserContext final : public EnumeratingContext<ParserContext, LexicalToke
 
  private:
   const TokenCollection tokens_;
+  TypeGraph& types_;
   bool started_;
   std::vector<LexicalToken>::const_iterator current_;
 
@@ -44,9 +45,11 @@ class ParserContext final : public EnumeratingContext<ParserContext, LexicalToke
   PrecedenceStack precedence_stack;
   TokenStack token_stack;
 
-  explicit ParserContext(const TokenCollection& tokens);
+  explicit ParserContext(const TokenCollection& tokens, TypeGraph& types);
   virtual ~ParserContext() = default;
 
+  NODISCARD auto& types() const { return types_; }
+
   auto current() -> const LexicalToken& override;
   auto move_next() -> bool override;
 
@@ -84,6 +87,22 @@ class ParserContext final : public EnumeratingContext<ParserContext, LexicalToke
     return deref(ptr_cast<T>(syntax_stack.top().get()));
   }
 
+  /**
+   * Applies the access modifiers pushed ahead of the definition on top of the syntax stack
+   */
+  template <IsSyntaxNode T>
+  auto pop_access_modifiers() -> void {
+    auto& def = get_syntax_node<T>();
+    while (!token_stack.empty()) {
+      auto access = get_access_modifier(token_stack.top().kind());
+      if (!access.has_value()) {
+        return;
+      }
+      def.set_access(access.value());
+      token_stack.pop();
+    }
+  }
+
   template <IsSyntaxNode T>
   auto pop_syntax_node() -> std::unique_ptr<T> {
     auto tnode = ptr_cast<T>(std::move(syntax_stack.top()));
@@ -0,0 +1,120 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "syntax_tree.hpp"
+
+template <typename T>
+auto visit(const std::unique_ptr<T>& child, const SyntaxVisitor& visitor) {
+  if (child) {
+    visitor(*child);
+  }
+}
+
+template <typename T>
+auto visit(const std::vector<std::unique_ptr<T>>& children, const SyntaxVisitor& visitor) {
+  for (auto& child : children) {
+    visit(child, visitor);
+  }
+}
+
+auto visit_structure(const BaseStructureDefinition& def, const SyntaxVisitor& visitor) {
+  visit(def.variables(), visitor);
+  visit(def.structs(), visitor);
+  visit(def.objects(), visitor);
+  visit(def.functions(), visitor);
+}
+
+auto for_each_child(const BaseSyntax& node, const SyntaxVisitor& visitor) -> void {
+  switch (node.kind()) {
+    case SyntaxKind::Source: {
+      auto& tree = ref_cast<const SyntaxTree>(node);
+      visit(tree.imports(), visitor);
+      visit(tree.namespaces(), visitor);
+      visit(tree.cincludes(), visitor);
+      visit(tree.ctypes(), visitor);
+      visit_structure(tree, visitor);
+      break;
+    }
+    case SyntaxKind::Block: {
+      visit(ref_cast<const StatementBlock>(node).statements(), visitor);
+      break;
+    }
+    case SyntaxKind::ExprCall: {
+      visit(ref_cast<const CallExpression>(node).parameters(), visitor);
+      break;
+    }
+    case SyntaxKind::ExprUnary: {
+      visit(ref_cast<const UnaryExpression>(node).expr(), visitor);
+      break;
+    }
+    case SyntaxKind::ExprBinary: {
+      auto& expr = ref_cast<const BinaryExpression>(node);
+      visit(expr.lhs(), visitor);
+      visit(expr.rhs(), visitor);
+      break;
+    }
+    case SyntaxKind::StmtDef: {
+      visit(ref_cast<const DefinitionStatement>(node).def(), visitor);
+      break;
+    }
+    case SyntaxKind::StmtExpr: {
+      visit(ref_cast<const ExpressionStatement>(node).expr(), visitor);
+      break;
+    }
+    case SyntaxKind::StmtRet: {
+      visit(ref_cast<const ReturnStatement>(node).expr(), visitor);
+      break;
+    }
+    case SyntaxKind::StmtIf:
+    case SyntaxKind::StmtElif: {
+      auto& stmt = ref_cast<const IfStatement>(node);
+      visit(stmt.expr(), visitor);
+      visit(stmt.body(), visitor);
+      break;
+    }
+    case SyntaxKind::StmtElse:
+    case SyntaxKind::StmtLoop: {
+      visit(ref_cast<const BaseBodyStatement>(node).body(), visitor);
+      break;
+    }
+    case SyntaxKind::StmtWhile: {
+      auto& stmt = ref_cast<const WhileStatement>(node);
+      visit(stmt.expr(), visitor);
+      visit(stmt.body(), visitor);
+      break;
+    }
+    case SyntaxKind::StmtFor: {
+      auto& stmt = ref_cast<const ForStatement>(node);
+      visit(stmt.prefix(), visitor);
+      visit(stmt.cond(), visitor);
+      visit(stmt.postfix(), visitor);
+      visit(stmt.body(), visitor);
+      break;
+    }
+    case SyntaxKind::DefVar: {
+      visit(ref_cast<const VariableDefinition>(node).assignment(), visitor);
+      break;
+    }
+    case SyntaxKind::DefFunc: {
+      auto& def = ref_cast<const FunctionDefinition>(node);
+      visit(def.parameters(), visitor);
+      visit(def.body(), visitor);
+      break;
+    }
+    case SyntaxKind::DefStruct:
+    case SyntaxKind::DefObject: {
+      visit_structure(ref_cast<const BaseStructureDefinition>(node), visitor);
+      break;
+    }
+    default: {
+      // Leaf nodes
+      break;
+    }
+  }
+}
+
+auto count_syntax_nodes(const BaseSyntax& node) -> size_t {
+  auto count = size_t{1};
+  for_each_child(node, [&](const BaseSyntax& child) { count += count_syntax_nodes(child); });
+  return count;
+}
@@ -582,7 +582,7 @@ void VariableDefinition::xml_append_elements(xml::document& doc, xml::node& node
   BaseDefinition::xml_append_elements(doc, node);
 
   if (is_typed()) {
-    node.append_attribute(&xml::allocate_attribute(doc, type_attr_name, type_name()));
+    node.append_attribute(&xml::allocate_attribute(doc, type_attr_name, deref(type()).spelling()));
   }
 
   if (is_assigned()) {
@@ -602,7 +602,8 @@ void FunctionDefinition::xml_append_elements(xml::document& doc, xml::node& node
   BaseDefinition::xml_append_elements(doc, node);
 
   if (!is_return_auto()) {
-    node.append_attribute(&xml::allocate_attribute(doc, return_attr_name, return_type()));
+    const auto spelling = deref(return_type()).spelling();
+    node.append_attribute(&xml::allocate_attribute(doc, return_attr_name, spelling));
   }
 
   if (!parameters().empty()) {
@@ -0,0 +1,191 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "type_graph.hpp"
+
+#include <cctype>
+#include <charconv>
+
+const auto type_kind_string_map = std::unordered_map<TypeKind, std::string_view>{
+    {TypeKind::Named,    "Named"   },
+    {TypeKind::Pointer,  "Pointer" },
+    {TypeKind::Array,    "Array"   },
+    {TypeKind::Optional, "Optional"},
+    {TypeKind::Generic,  "Generic" },
+};
+
+auto to_string(TypeKind kind) -> std::string_view {
+  const auto str = type_kind_string_map.find(kind);
+  if (str == type_kind_string_map.end()) {
+    throw std::exception("not implemented!");
+  }
+  return str->second;
+}
+
+Type::Type(TypeKind kind,
+           std::string spelling,
+           std::string name,
+           const Type* element,
+           size_t extent,
+           std::vector<const Type*> arguments)
+    : kind_{kind},
+      spelling_{std::move(spelling)},
+      name_{std::move(name)},
+      element_{element},
+      extent_{extent},
+      arguments_{std::move(arguments)} {}
+
+auto TypeGraph::find(std::string_view spelling) const -> const Type* {
+  auto lock = std::shared_lock{mutex_, std::defer_lock};
+  if (!sealed()) {
+    lock.lock();
+  }
+
+  auto it = index_.find(spelling);
+  return it == index_.end() ? nullptr : it->second;
+}
+
+auto TypeGraph::insert(Type type) -> const Type* {
+  assert(!sealed());
+  const auto lock = std::unique_lock{mutex_};
+  if (auto it = index_.find(type.spelling()); it != index_.end()) {
+    return it->second;
+  }
+
+  // Deque growth never moves existing types, so the keys and element pointers stay valid.
+  auto& inserted = types_.emplace_back(std::move(type));
+  index_.emplace(inserted.spelling(), &inserted);
+  return &inserted;
+}
+
+auto TypeGraph::named(std::string_view name) -> const Type* {
+  if (auto* type = find(name)) {
+    return type;
+  }
+  return insert({TypeKind::Named, std::string{name}, std::string{name}, nullptr, 0, {}});
+}
+
+auto TypeGraph::pointer(const Type& element) -> const Type* {
+  auto spelling = std::string{element.spelling()}.append("*");
+  if (auto* type = find(spelling)) {
+    return type;
+  }
+  return insert({TypeKind::Pointer, std::move(spelling), {}, &element, 0, {}});
+}
+
+auto TypeGraph::array(const Type& element, size_t extent) -> const Type* {
+  auto spelling = std::string{element.spelling()}.append("[");
+  if (extent != 0) {
+    spelling.append(std::to_string(extent));
+  }
+  spelling.append("]");
+
+  if (auto* type = find(spelling)) {
+    return type;
+  }
+  return insert({TypeKind::Array, std::move(spelling), {}, &element, extent, {}});
+}
+
+auto TypeGraph::optional(const Type& element) -> const Type* {
+  auto spelling = std::string{element.spelling()}.append("?");
+  if (auto* type = find(spelling)) {
+    return type;
+  }
+  return insert({TypeKind::Optional, std::move(spelling), {}, &element, 0, {}});
+}
+
+auto TypeGraph::generic(std::string_view name, const std::vector<const Type*>& arguments)
+    -> const Type* {
+  auto spelling = std::string{name}.append("<");
+  for (auto i = size_t{0}; i < arguments.size(); ++i) {
+    if (i != 0) {
+      spelling.append(",");
+    }
+    spelling.append(deref(arguments[i]).spelling());
+  }
+  spelling.append(">");
+
+  if (auto* type = find(spelling)) {
+    return type;
+  }
+  return insert({TypeKind::Generic, std::move(spelling), std::string{name}, nullptr, 0, arguments});
+}
+
+auto is_type_name_char(char c) -> bool {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == ':';
+}
+
+// type := name ['<' type {',' type} '>'] {'*' | '?' | '[' [extent] ']'}
+auto parse_type(TypeGraph& graph, std::string_view& rest) -> const Type* {
+  auto length = size_t{0};
+  while (length < rest.size() && is_type_name_char(rest[length])) {
+    ++length;
+  }
+  if (length == 0) {
+    return nullptr;
+  }
+
+  const auto name = rest.substr(0, length);
+  rest.remove_prefix(length);
+
+  const Type* type = nullptr;
+  if (!rest.empty() && rest.front() == '<') {
+    auto arguments = std::vector<const Type*>{};
+    do {
+      rest.remove_prefix(1);
+      auto* argument = parse_type(graph, rest);
+      if (argument == nullptr) {
+        return nullptr;
+      }
+      arguments.push_back(argument);
+    } while (!rest.empty() && rest.front() == ',');
+
+    if (rest.empty() || rest.front() != '>') {
+      return nullptr;
+    }
+    rest.remove_prefix(1);
+    type = graph.generic(name, arguments);
+  } else {
+    type = graph.named(name);
+  }
+
+  while (!rest.empty()) {
+    if (rest.front() == '*') {
+      rest.remove_prefix(1);
+      type = graph.pointer(*type);
+    } else if (rest.front() == '?') {
+      rest.remove_prefix(1);
+      type = graph.optional(*type);
+    } else if (rest.front() == '[') {
+      const auto close = rest.find(']');
+      if (close == std::string_view::npos) {
+        return nullptr;
+      }
+
+      auto extent       = size_t{0};
+      const auto digits = rest.substr(1, close - 1);
+      if (!digits.empty()) {
+        const auto* last        = digits.data() + digits.size();
+        const auto [end, error] = std::from_chars(digits.data(), last, extent);
+        if (error != std::errc{} || end != last) {
+          return nullptr;
+        }
+      }
+      rest.remove_prefix(close + 1);
+      type = graph.array(*type, extent);
+    } else {
+      break;
+    }
+  }
+  return type;
+}
+
+auto TypeGraph::parse(std::string_view spelling) -> const Type* {
+  if (auto* type = find(spelling)) {
+    return type;
+  }
+
+  auto rest  = spelling;
+  auto* type = parse_type(*this, rest);
+  return rest.empty() ? type : nullptr;
+}
@@ -0,0 +1,4 @@
+
+extern auto __ty_main() -> int;
+
+auto main() -> int { return __ty_main(); }
@@ -0,0 +1,37 @@
+# Copies the project of PROJECT_DIR to WORK_DIR, builds it with TYC and runs its binary, which has
+# to exit with 0. BACKEND, when set, replaces the backend of the project file. REMOVE, when set, is
+# a file of the project deleted after the run, the rebuild then has to fail with EXPECT_ERROR.
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(COPY ${PROJECT_DIR}/ DESTINATION ${WORK_DIR} PATTERN obj EXCLUDE PATTERN bin EXCLUDE)
+
+file(GLOB PROJECT_FILE ${WORK_DIR}/*.typroj)
+file(READ ${PROJECT_FILE} PROJECT_XML)
+string(REGEX MATCH "<ProjectName>([^<]+)</ProjectName>" _ "${PROJECT_XML}")
+set(PROJECT_NAME ${CMAKE_MATCH_1})
+
+if(BACKEND)
+    string(REGEX REPLACE "[ \t]*<Backend>[^<]*</Backend>\n?" "" PROJECT_XML "${PROJECT_XML}")
+    string(REPLACE "</BinaryType>" "</BinaryType>\n    <Backend>${BACKEND}</Backend>"
+           PROJECT_XML "${PROJECT_XML}")
+    file(WRITE ${PROJECT_FILE} "${PROJECT_XML}")
+endif()
+
+execute_process(COMMAND ${TYC} WORKING_DIRECTORY ${WORK_DIR} RESULT_VARIABLE BUILD_RESULT)
+if(NOT BUILD_RESULT EQUAL 0)
+    message(FATAL_ERROR "tyc failed to build ${PROJECT_NAME} : ${BUILD_RESULT}")
+endif()
+
+execute_process(COMMAND ${WORK_DIR}/bin/${PROJECT_NAME} RESULT_VARIABLE RUN_RESULT)
+if(NOT RUN_RESULT EQUAL 0)
+    message(FATAL_ERROR "${PROJECT_NAME} exited with ${RUN_RESULT}")
+endif()
+
+if(REMOVE)
+    file(REMOVE ${WORK_DIR}/${REMOVE})
+    execute_process(COMMAND ${TYC} WORKING_DIRECTORY ${WORK_DIR}
+                    RESULT_VARIABLE REBUILD_RESULT ERROR_VARIABLE REBUILD_ERROR)
+    if(REBUILD_RESULT EQUAL 0 OR NOT REBUILD_ERROR MATCHES "${EXPECT_ERROR}")
+        message(FATAL_ERROR "tyc rebuilt ${PROJECT_NAME} without ${REMOVE} : ${REBUILD_ERROR}")
+    endif()
+endif()
@@ -0,0 +1,107 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#include "command_line.hpp"
+
+#include <charconv>
+
+using option_handler = void (*)(CommandLine& cmd, std::string_view value);
+
+auto time_trace_handler(CommandLine& cmd, const std::string_view value) -> void {
+  if (value.empty()) {
+    std::cerr << "Error : \"--time-trace\" requires an output path." << std::endl;
+    exit(-1);
+  }
+  cmd.set_time_trace_path(value);
+}
+
+const auto stats_format_map = std::unordered_map<std::string_view, StatsFormat>{
+    {"json", StatsFormat::Json},
+};
+
+auto stats_handler(CommandLine& cmd, const std::string_view value) -> void {
+  if (auto it = stats_format_map.find(value); it != stats_format_map.end()) {
+    cmd.set_stats_format(it->second);
+  } else {
+    std::cerr << "Error : Unknown statistics format \"" << value << '"' << std::endl;
+    exit(-1);
+  }
+}
+
+auto jobs_handler(CommandLine& cmd, const std::string_view value) -> void {
+  auto jobs         = uint32_t{0};
+  auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), jobs);
+  if (value.empty() || error != std::errc{} || end != value.data() + value.size()) {
+    std::cerr << "Error : \"--jobs\" requires a worker count, got \"" << value << '"' << std::endl;
+    exit(-1);
+  }
+  cmd.set_jobs(jobs);
+}
+
+auto cache_handler(CommandLine& cmd, const std::string_view value) -> void {
+  if (value.empty()) {
+    std::cerr << "Error : \"--cache\" requires a cache directory." << std::endl;
+    exit(-1);
+  }
+  cmd.set_cache_dir(value);
+}
+
+// Sizes are given in MiB.
+auto cache_size_handler(CommandLine& cmd, const std::string_view value) -> void {
+  auto size         = uint64_t{0};
+  auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), size);
+  if (value.empty() || error != std::errc{} || end != value.data() + value.size() || size == 0 ||
+      size > (uint64_t{1} << 40)) {
+    std::cerr << "Error : \"--cache-size\" requires a size in MiB, got \"" << value << '"'
+              << std::endl;
+    exit(-1);
+  }
+  cmd.set_cache_size(size << 20);
+}
+
+auto solution_handler(CommandLine& cmd, const std::string_view value) -> void {
+  if (value.empty()) {
+    std::cerr << "Error : \"--solution\" requires a solution file." << std::endl;
+    exit(-1);
+  }
+  cmd.set_solution_path(value);
+}
+
+auto config_handler(CommandLine& cmd, const std::string_view value) -> void {
+  if (value.empty()) {
+    std::cerr << "Error : \"--config\" requires a configuration name." << std::endl;
+    exit(-1);
+  }
+  cmd.set_configuration(value);
+}
+
+const auto option_handlers = std::unordered_map<std::string_view, option_handler>{
+    {"--time-trace", time_trace_handler},
+    {"--stats",      stats_handler     },
+    {"--jobs",       jobs_handler      },
+    {"--cache",      cache_handler     },
+    {"--cache-size", cache_size_handler},
+    {"--solution",   solution_handler  },
+    {"--config",     config_handler    },
+};
+
+auto CommandLine::parse(int argc, const char* argv[]) -> CommandLine {
+  auto cmd = CommandLine{};
+
+  for (auto i = 1; i < argc; ++i) {
+    const auto arg   = std::string_view{argv[i]};
+    const auto split = arg.find('=');
+    const auto name  = arg.substr(0, split);
+    const auto value = split == std::string_view::npos ? std::string_view{} : arg.substr(split + 1);
+
+    if (auto it = option_handlers.find(name); it != option_handlers.end()) {
+      auto handler = it->second;
+      handler(cmd, value);
+    } else {
+      std::cerr << "Error : Unknown option \"" << arg << '"' << std::endl;
+      exit(-1);
+    }
+  }
+
+  return cmd;
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2023 Jacob R. Green
+// All Rights Reserved.
+
+#pragma once
+
+#ifndef __cplusplus
+#error
+#endif
+
+#include "driver.hpp"
+
+enum class StatsFormat : uint8_t {
+  None,
+  Json
+};
+
+class CommandLine final {
+  fs::path time_trace_path_;
+  fs::path solution_path_;
+  fs::path cache_dir_;
+  std::string configuration_;
+  StatsFormat stats_format_ = StatsFormat::None;
+  uint32_t jobs_            = 0;
+  uint64_t cache_size_      = default_cache_size;
+
+ public:
+  NODISCARD auto& time_trace_path() const { return time_trace_path_; }
+  NODISCARD auto time_trace() const { return !time_trace_path_.empty(); }
+
+  NODISCARD auto stats_format() const { return stats_format_; }
+  NODISCARD auto stats() const { return stats_format_ != StatsFormat::None; }
+
+  NODISCARD auto jobs() const { return jobs_; }
+
+  NODISCARD auto& cache_dir() const { return cache_dir_; }
+  NODISCARD auto cache_size() const { return cache_size_; }
+
+  NODISCARD auto& solution_path() const { return solution_path_; }
+  NODISCARD auto& configuration() const { return configuration_; }
+
+  NODISCARD auto compiler_options() const {
+    return CompilerOptions{.collect_stats = stats(),
+                           .jobs          = jobs_,
+                           .cache_dir     = cache_dir_,
+                           .cache_size    = cache_size_,
+                           .configuration = configuration_};
+  }
+
+  auto set_time_trace_path(const std::string_view path) { time_trace_path_ = path; }
+  auto set_stats_format(StatsFormat format) { stats_format_ = format; }
+  auto set_jobs(uint32_t jobs) { jobs_ = jobs; }
+  auto set_cache_dir(const std::string_view dir) { cache_dir_ = dir; }
+  auto set_cache_size(uint64_t size) { cache_size_ = size; }
+  auto set_solution_path(const std::string_view path) { solution_path_ = path; }
+  auto set_configuration(const std::string_view name) { configuration_ = name; }
+
+  static auto parse(int argc, const char* argv[]) -> CommandLine;
+};